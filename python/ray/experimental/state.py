@@ -230,7 +230,8 @@ class GlobalState(object):
                     "DataSize": entry.ObjectSize(),
                     "Manager": entry.Manager(),
                     "IsEviction": entry.IsEviction(),
-                    "NumEvictions": entry.NumEvictions()
+                    "NumEvictions": entry.NumEvictions(),
+                    "IsPartial": entry.IsPartial()
                 }
                 result.append(object_info)
 
@@ -1389,6 +1390,9 @@ class GlobalState(object):
                     heartbeat_data = gcs_entries.Entries(0)
                     message = (ray.gcs_utils.HeartbeatTableData.
                                GetRootAsHeartbeatTableData(heartbeat_data, 0))
+                    # Only full heartbeats carry the resource labels.
+                    if not message.IsFull():
+                        continue
                     # Calculate available resources for this client
                     num_resources = message.ResourcesAvailableLabelLength()
                     dynamic_resources = {}
@@ -317,6 +317,14 @@ class Monitor(object):
         heartbeat_data = gcs_entries.Entries(0)
         message = ray.gcs_utils.HeartbeatTableData.GetRootAsHeartbeatTableData(
             heartbeat_data, 0)
+        client_id = ray.utils.binary_to_hex(message.ClientId())
+        ip = self.local_scheduler_id_to_ip_map.get(client_id)
+        if not message.IsFull():
+            # Only full heartbeats carry the resource labels. The heartbeats in
+            # between still show that the local scheduler is alive.
+            if ip:
+                self.load_metrics.mark_active(ip)
+            return
         num_resources = message.ResourcesAvailableLabelLength()
         static_resources = {}
         dynamic_resources = {}
@@ -327,8 +335,6 @@ class Monitor(object):
             static_resources[static] = message.ResourcesTotalCapacity(i)
 
         # Update the load metrics for this local scheduler.
-        client_id = ray.utils.binary_to_hex(message.ClientId())
-        ip = self.local_scheduler_id_to_ip_map.get(client_id)
         if ip:
             self.load_metrics.update(ip, static_resources, dynamic_resources)
         else:
@@ -77,3 +77,7 @@ LOGGER_LEVEL = "info"
 LOGGER_LEVEL_CHOICES = ['debug', 'info', 'warning', 'error', 'critical']
 LOGGER_LEVEL_HELP = ("The logging level threshold, choices=['debug', 'info',"
                      " 'warning', 'error', 'critical'], default='info'")
+
+# The environment variable that the raylet sets when it starts a worker as a
+# fork server. Its value is the file descriptor of the socket to the raylet.
+WORKER_FORK_SERVER_FD_ENVIRONMENT_VARIABLE = "RAY_WORKER_FORK_SERVER_FD"
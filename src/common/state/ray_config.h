@@ -24,6 +24,8 @@ class RayConfig {
 
   uint64_t num_heartbeats_warning() const { return num_heartbeats_warning_; }
 
+  int64_t num_heartbeats_full_resync() const { return num_heartbeats_full_resync_; }
+
   int64_t initial_reconstruction_timeout_milliseconds() const {
     return initial_reconstruction_timeout_milliseconds_;
   }
@@ -116,6 +118,72 @@ class RayConfig {
 
   int num_workers_per_process() const { return num_workers_per_process_; }
 
+  bool locality_aware_scheduling() const { return locality_aware_scheduling_; }
+
+  int scheduling_node_selection_strategy() const {
+    return scheduling_node_selection_strategy_;
+  }
+
+  int64_t max_tasks_to_spillover() const { return max_tasks_to_spillover_; }
+
+  int64_t async_write_max_messages() const { return async_write_max_messages_; }
+
+  int64_t async_write_high_water_mark_bytes() const {
+    return async_write_high_water_mark_bytes_;
+  }
+
+  uint64_t client_connection_read_buffer_bytes() const {
+    return client_connection_read_buffer_bytes_;
+  }
+
+  bool use_python_worker_fork_server() const { return use_python_worker_fork_server_; }
+
+  int64_t worker_fork_timeout_milliseconds() const {
+    return worker_fork_timeout_milliseconds_;
+  }
+
+  int64_t worker_pool_resize_period_milliseconds() const {
+    return worker_pool_resize_period_milliseconds_;
+  }
+
+  int64_t worker_pool_idle_timeout_milliseconds() const {
+    return worker_pool_idle_timeout_milliseconds_;
+  }
+
+  double worker_pool_demand_smoothing() const { return worker_pool_demand_smoothing_; }
+
+  int64_t max_tasks_in_flight_per_worker() const {
+    return max_tasks_in_flight_per_worker_;
+  }
+
+  int64_t task_lease_renewal_tick_milliseconds() const {
+    return task_lease_renewal_tick_milliseconds_;
+  }
+
+  int64_t object_manager_max_connections_per_peer() const {
+    return object_manager_max_connections_per_peer_;
+  }
+
+  int64_t object_manager_max_pull_stripes() const {
+    return object_manager_max_pull_stripes_;
+  }
+
+  int64_t object_manager_broadcast_fanout() const {
+    return object_manager_broadcast_fanout_;
+  }
+
+  int64_t object_manager_max_pull_forwards() const {
+    return object_manager_max_pull_forwards_;
+  }
+
+  bool object_manager_zero_copy_sends() const { return object_manager_zero_copy_sends_; }
+
+  int64_t object_location_cache_size() const { return object_location_cache_size_; }
+
+  int64_t max_tasks_examined_for_spillover() const {
+    return max_tasks_examined_for_spillover_;
+  }
+
  private:
   RayConfig()
       : ray_protocol_version_(0x0000000000000000),
@@ -123,6 +191,7 @@ class RayConfig {
         heartbeat_timeout_milliseconds_(100),
         num_heartbeats_timeout_(100),
         num_heartbeats_warning_(5),
+        num_heartbeats_full_resync_(10),
         initial_reconstruction_timeout_milliseconds_(200),
         get_timeout_milliseconds_(1000),
         worker_get_request_size_(10000),
@@ -152,7 +221,27 @@ class RayConfig {
         object_manager_pull_timeout_ms_(100),
         object_manager_push_timeout_ms_(10000),
         object_manager_default_chunk_size_(1000000),
-        num_workers_per_process_(1) {}
+        num_workers_per_process_(1),
+        locality_aware_scheduling_(false),
+        scheduling_node_selection_strategy_(0),
+        max_tasks_to_spillover_(10),
+        async_write_max_messages_(16),
+        async_write_high_water_mark_bytes_(8 * 1024 * 1024),
+        client_connection_read_buffer_bytes_(64 * 1024),
+        use_python_worker_fork_server_(false),
+        worker_fork_timeout_milliseconds_(100),
+        worker_pool_resize_period_milliseconds_(1000),
+        worker_pool_idle_timeout_milliseconds_(60000),
+        worker_pool_demand_smoothing_(0.2),
+        max_tasks_in_flight_per_worker_(1),
+        task_lease_renewal_tick_milliseconds_(10),
+        object_manager_max_connections_per_peer_(4),
+        object_manager_max_pull_stripes_(1),
+        object_manager_broadcast_fanout_(0),
+        object_manager_max_pull_forwards_(2),
+        object_manager_zero_copy_sends_(false),
+        object_location_cache_size_(10000),
+        max_tasks_examined_for_spillover_(100) {}
 
   ~RayConfig() {}
 
@@ -174,6 +263,10 @@ class RayConfig {
   /// heartbeat periods ago, then a warning will be logged that the heartbeat
   /// handler is drifting.
   uint64_t num_heartbeats_warning_;
+  /// A raylet sends a full heartbeat with all of its resources every this many
+  /// heartbeats. The heartbeats in between only carry what changed, so this
+  /// bounds how long a receiver that missed a heartbeat has stale resources.
+  int64_t num_heartbeats_full_resync_;
 
   /// The initial period for a task execution lease. The lease will expire this
   /// many milliseconds after the first acquisition of the lease. Nodes that
@@ -277,6 +370,112 @@ class RayConfig {
 
   /// Number of workers per process
   int num_workers_per_process_;
+
+  /// Whether the raylet scheduling policy should prefer to place a task on
+  /// the feasible node that already stores the most bytes of the task's
+  /// arguments. Only the argument locations that the object manager already
+  /// knows are used, and no lookups are made to place a task. If none are
+  /// known, the node selection strategy picks the node.
+  bool locality_aware_scheduling_;
+
+  /// The strategy the raylet scheduling policy uses to choose between the
+  /// candidate nodes for a task. 0 picks uniformly at random, 1 picks at random
+  /// weighted by the nodes' CPU capacity, 2 samples two nodes and picks the one
+  /// with the lower CPU utilization, and 3 picks the node with the lowest CPU
+  /// utilization.
+  int scheduling_node_selection_strategy_;
+
+  /// The maximum number of ready tasks that a raylet spills over to a remote
+  /// raylet in response to a single heartbeat from it.
+  int64_t max_tasks_to_spillover_;
+
+  /// The maximum number of queued messages that a connection coalesces into a
+  /// single asynchronous write.
+  int64_t async_write_max_messages_;
+
+  /// The number of bytes queued for asynchronous writes on a connection above
+  /// which the connection reports that its write queue is full.
+  int64_t async_write_high_water_mark_bytes_;
+
+  /// The size of the buffer that a client connection reads messages into. A
+  /// single read can receive as many messages as fit. The buffer grows to fit
+  /// larger messages.
+  uint64_t client_connection_read_buffer_bytes_;
+
+  /// Whether the raylet forks Python workers from a fork server that has
+  /// already imported the worker's modules, instead of starting each worker
+  /// from the worker command.
+  bool use_python_worker_fork_server_;
+
+  /// How long the raylet waits for a fork server to fork a worker. The raylet
+  /// blocks while it waits, so if the fork server does not answer in time, it
+  /// is stopped and workers are started from the worker command instead.
+  int64_t worker_fork_timeout_milliseconds_;
+
+  /// The period at which the raylet resizes its worker pool based on the
+  /// demand for workers. If this is 0, workers are only started when a task
+  /// finds no idle worker and are never reaped.
+  int64_t worker_pool_resize_period_milliseconds_;
+
+  /// The time that a worker must be idle for before the raylet may reap it
+  /// when the worker pool is larger than the demand for workers.
+  int64_t worker_pool_idle_timeout_milliseconds_;
+
+  /// The weight of the latest number of ready tasks in the smoothed demand for
+  /// workers that the worker pool is sized by. Lower values remember past
+  /// demand for longer.
+  double worker_pool_demand_smoothing_;
+
+  /// The maximum number of tasks that the raylet assigns to a worker at once,
+  /// including the task that the worker is running. The other tasks are sent
+  /// ahead, so that the worker starts the next task as soon as it finishes
+  /// one. Actors are likewise sent the methods that only wait for the methods
+  /// before them. If this is 1, a worker is only sent a task when it asks for
+  /// one.
+  int64_t max_tasks_in_flight_per_worker_;
+
+  /// The period of the timer that renews the task leases held by the raylet.
+  /// The leases that are due within the same period are renewed together.
+  int64_t task_lease_renewal_tick_milliseconds_;
+
+  /// The maximum number of transfer connections that the object manager opens
+  /// to each remote object manager. Each connection has one chunk in flight,
+  /// and the rest of the chunks for that remote object manager are queued.
+  int64_t object_manager_max_connections_per_peer_;
+
+  /// The maximum number of remote object managers that an object is pulled
+  /// from at once. Each one sends a disjoint range of the object's chunks. If
+  /// this is 1, objects are pulled from one location at a time. Striping is
+  /// off by default until it is shown to speed up pulls.
+  int64_t object_manager_max_pull_stripes_;
+
+  /// The maximum number of nodes that the object manager serves an object to
+  /// at once. Further pulls of the object are forwarded to those nodes, which
+  /// relay the chunks as they receive them. If this is 0, pulls are never
+  /// forwarded.
+  int64_t object_manager_broadcast_fanout_;
+
+  /// The maximum number of times that a pull is forwarded. A node serves a
+  /// pull that was forwarded this many times itself, so that a pull cannot
+  /// be forwarded in a loop between nodes with stale distribution trees.
+  int64_t object_manager_max_pull_forwards_;
+
+  /// Whether the object manager sends chunks with MSG_ZEROCOPY, so that the
+  /// kernel transmits them straight from the object store's memory. A chunk
+  /// stays pinned until the kernel reports that it has been sent. This
+  /// requires Linux 4.14 or later. Over loopback, the kernel copies the data
+  /// when it delivers it, so only transfers between hosts avoid the copy.
+  bool object_manager_zero_copy_sends_;
+
+  /// The number of object lookups whose locations and size the object
+  /// directory caches. The cached locations are used as a hint when placing
+  /// tasks near their arguments.
+  int64_t object_location_cache_size_;
+
+  /// The maximum number of ready tasks that a raylet examines when choosing
+  /// the tasks to spill over to a remote raylet in response to a single
+  /// heartbeat from it.
+  int64_t max_tasks_examined_for_spillover_;
 };
 
 #endif  // RAY_CONFIG_H
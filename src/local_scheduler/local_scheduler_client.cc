@@ -6,12 +6,48 @@
 
 #include "common/io.h"
 #include "common/task.h"
+#include <poll.h>
 #include <stdlib.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 using MessageType = ray::local_scheduler::protocol::MessageType;
 
+// Buffer a message from the raylet if it is a task that was pipelined to this
+// worker. Returns true and frees the message if it was buffered.
+static bool buffer_pipelined_task(LocalSchedulerConnection *conn,
+                                  int64_t type,
+                                  int64_t length,
+                                  uint8_t *bytes) {
+  if (type != static_cast<int64_t>(MessageType::ExecuteTask)) {
+    return false;
+  }
+  conn->pipelined_tasks.emplace_back(bytes, bytes + length);
+  free(bytes);
+  return true;
+}
+
+// Read a message from the raylet, exiting if the raylet closed the connection.
+static void read_raylet_message(LocalSchedulerConnection *conn,
+                                int64_t *type,
+                                int64_t *length,
+                                uint8_t **bytes) {
+  read_message(conn->conn, type, length, bytes);
+  if (*type == static_cast<int64_t>(CommonMessageType::DISCONNECT_CLIENT)) {
+    RAY_LOG(DEBUG) << "Exiting because local scheduler closed connection.";
+    exit(1);
+  }
+}
+
+// Check whether a message from the raylet can be read without blocking.
+static bool message_available(int fd) {
+  struct pollfd poll_fd;
+  poll_fd.fd = fd;
+  poll_fd.events = POLLIN;
+  poll_fd.revents = 0;
+  return poll(&poll_fd, 1, 0) > 0;
+}
+
 LocalSchedulerConnection *LocalSchedulerConnection_init(
     const char *local_scheduler_socket,
     const UniqueID &client_id,
@@ -21,6 +57,7 @@ LocalSchedulerConnection *LocalSchedulerConnection_init(
     const Language &language) {
   LocalSchedulerConnection *result = new LocalSchedulerConnection();
   result->use_raylet = use_raylet;
+  result->pipeline_may_be_revoked = false;
   result->conn = connect_ipc_sock_retry(local_scheduler_socket, -1, -1);
 
   /* Register with the local scheduler.
@@ -155,22 +192,64 @@ TaskSpec *local_scheduler_get_task_raylet(LocalSchedulerConnection *conn,
   int64_t type;
   int64_t reply_size;
   uint8_t *reply;
+  std::vector<uint8_t> task_message;
   {
     std::unique_lock<std::mutex> guard(conn->mutex);
-    write_message(conn->conn, static_cast<int64_t>(MessageType::GetTask), 0,
-                  NULL, &conn->write_mutex);
-    // Receive a task from the local scheduler. This will block until the local
-    // scheduler gives this client a task.
-    read_message(conn->conn, &type, &reply_size, &reply);
-  }
-  if (type == static_cast<int64_t>(CommonMessageType::DISCONNECT_CLIENT)) {
-    RAY_LOG(DEBUG) << "Exiting because local scheduler closed connection.";
-    exit(1);
+    const bool revoke = conn->pipeline_may_be_revoked.exchange(false);
+    TaskID started_task_id = TaskID::nil();
+    if (!revoke) {
+      // The raylet only revokes the tasks pipelined to this worker when it
+      // blocks, so the next one can be started without waiting for a reply.
+      // Tell the raylet which task is started so that it can check.
+      while (message_available(conn->conn)) {
+        read_raylet_message(conn, &type, &reply_size, &reply);
+        RAY_CHECK(buffer_pipelined_task(conn, type, reply_size, reply));
+      }
+      if (!conn->pipelined_tasks.empty()) {
+        task_message = std::move(conn->pipelined_tasks.front());
+        conn->pipelined_tasks.pop_front();
+        auto task_reply = flatbuffers::GetRoot<ray::protocol::GetTaskReply>(
+            task_message.data());
+        started_task_id =
+            ray::raylet::TaskSpecification(*task_reply->task_spec()).TaskId();
+      }
+    }
+    flatbuffers::FlatBufferBuilder fbb;
+    auto message = ray::protocol::CreateGetTaskRequest(
+        fbb, to_flatbuf(fbb, started_task_id), revoke);
+    fbb.Finish(message);
+    write_message(conn->conn, static_cast<int64_t>(MessageType::GetTask),
+                  fbb.GetSize(), fbb.GetBufferPointer(), &conn->write_mutex);
+    if (revoke) {
+      // The raylet queues the pipelined tasks again, so drop the ones that it
+      // sent before its reply.
+      conn->pipelined_tasks.clear();
+      while (true) {
+        read_raylet_message(conn, &type, &reply_size, &reply);
+        if (type == static_cast<int64_t>(
+                        ray::protocol::MessageType::CancelPipelinedTasks)) {
+          free(reply);
+          break;
+        }
+        RAY_CHECK(type == static_cast<int64_t>(MessageType::ExecuteTask));
+        free(reply);
+      }
+    }
+    if (task_message.empty()) {
+      // Receive a task from the local scheduler. This will block until the
+      // local scheduler gives this client a task.
+      while (conn->pipelined_tasks.empty()) {
+        read_raylet_message(conn, &type, &reply_size, &reply);
+        RAY_CHECK(buffer_pipelined_task(conn, type, reply_size, reply));
+      }
+      task_message = std::move(conn->pipelined_tasks.front());
+      conn->pipelined_tasks.pop_front();
+    }
   }
-  RAY_CHECK(type == static_cast<int64_t>(MessageType::ExecuteTask));
 
   // Parse the flatbuffer object.
-  auto reply_message = flatbuffers::GetRoot<ray::protocol::GetTaskReply>(reply);
+  auto reply_message =
+      flatbuffers::GetRoot<ray::protocol::GetTaskReply>(task_message.data());
 
   // Create a copy of the task spec so we can free the reply.
   *task_size = reply_message->task_spec()->size();
@@ -205,8 +284,6 @@ TaskSpec *local_scheduler_get_task_raylet(LocalSchedulerConnection *conn,
     }
   }
 
-  // Free the original message from the local scheduler.
-  free(reply);
   // Return the copy of the task spec and pass ownership to the caller.
   return spec;
 }
@@ -225,6 +302,11 @@ void local_scheduler_reconstruct_objects(
   auto message = ray::local_scheduler::protocol::CreateReconstructObjects(
       fbb, object_ids_message, fetch_only);
   fbb.Finish(message);
+  if (!fetch_only) {
+    // The raylet treats this worker as blocked and may revoke its pipelined
+    // tasks.
+    conn->pipeline_may_be_revoked = true;
+  }
   write_message(conn->conn,
                 static_cast<int64_t>(MessageType::ReconstructObjects),
                 fbb.GetSize(), fbb.GetBufferPointer(), &conn->write_mutex);
@@ -304,11 +386,17 @@ std::pair<std::vector<ObjectID>, std::vector<ObjectID>> local_scheduler_wait(
   uint8_t *reply;
   {
     std::unique_lock<std::mutex> guard(conn->mutex);
+    // The raylet may treat this worker as blocked and revoke its pipelined
+    // tasks.
+    conn->pipeline_may_be_revoked = true;
     write_message(conn->conn,
                   static_cast<int64_t>(ray::protocol::MessageType::WaitRequest),
                   fbb.GetSize(), fbb.GetBufferPointer(), &conn->write_mutex);
-    // Read result.
-    read_message(conn->conn, &type, &reply_size, &reply);
+    // Read result. Tasks that the raylet pipelines to this worker may arrive
+    // first.
+    do {
+      read_message(conn->conn, &type, &reply_size, &reply);
+    } while (buffer_pipelined_task(conn, type, reply_size, reply));
   }
   RAY_CHECK(static_cast<ray::protocol::MessageType>(type) ==
             ray::protocol::MessageType::WaitReply);
@@ -1,7 +1,10 @@
 #ifndef LOCAL_SCHEDULER_CLIENT_H
 #define LOCAL_SCHEDULER_CLIENT_H
 
+#include <atomic>
+#include <deque>
 #include <mutex>
+#include <vector>
 
 #include "common/task.h"
 #include "local_scheduler_shared.h"
@@ -21,6 +24,13 @@ struct LocalSchedulerConnection {
   /// of that resource allocated for this worker.
   std::unordered_map<std::string, std::vector<std::pair<int64_t, double>>>
       resource_ids_;
+  /// The ExecuteTask messages that the raylet sent ahead of time, in the order
+  /// that the worker runs them.
+  std::deque<std::vector<uint8_t>> pipelined_tasks;
+  /// True if the worker sent a message that may block it since its last
+  /// GetTask. The raylet may have revoked the pipelined tasks then, so the
+  /// worker must not start any of them and asks for all of them to be revoked.
+  std::atomic<bool> pipeline_may_be_revoked;
   /// A mutex to protect stateful operations of the local scheduler client.
   std::mutex mutex;
   /// A mutext to protect write operations of the local scheduler client.
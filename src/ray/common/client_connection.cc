@@ -1,11 +1,37 @@
 #include "client_connection.h"
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+// This uses struct timespec without including its definition.
+#include <linux/errqueue.h>
+#endif
+
 #include <boost/bind.hpp>
 
 #include "common.h"
 #include "ray/raylet/format/node_manager_generated.h"
 #include "ray/util/util.h"
 
+#ifdef __linux__
+// These are only defined by the headers of Linux 4.14 or later, but the
+// running kernel may support them anyway.
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#endif
+
 namespace ray {
 
 ray::Status TcpConnect(boost::asio::ip::tcp::socket &socket,
@@ -18,9 +44,32 @@ ray::Status TcpConnect(boost::asio::ip::tcp::socket &socket,
   return boost_to_ray_status(error);
 }
 
+template <class T>
+std::shared_ptr<ServerConnection<T>> ServerConnection<T>::Create(
+    boost::asio::basic_stream_socket<T> &&socket) {
+  std::shared_ptr<ServerConnection<T>> self(new ServerConnection(std::move(socket)));
+  return self;
+}
+
 template <class T>
 ServerConnection<T>::ServerConnection(boost::asio::basic_stream_socket<T> &&socket)
-    : socket_(std::move(socket)) {}
+    : socket_(std::move(socket)),
+      async_write_queue_(),
+      async_write_queue_bytes_(0),
+      async_write_in_flight_(false),
+      zero_copy_enabled_(false),
+      zero_copy_next_seq_(0),
+      zero_copy_writes_() {}
+
+template <class T>
+ServerConnection<T>::~ServerConnection() {
+  // The kernel may keep transmitting from the buffers of pending zero-copy
+  // writes after the socket is closed, but the owner is dropping the
+  // connection anyway, so the data is no longer needed.
+  for (const auto &write : zero_copy_writes_) {
+    write.on_complete();
+  }
+}
 
 template <class T>
 Status ServerConnection<T>::WriteBuffer(
@@ -69,6 +118,197 @@ void ServerConnection<T>::ReadBuffer(
   }
 }
 
+template <class T>
+void ServerConnection<T>::Close() {
+  boost::system::error_code ec;
+  socket_.close(ec);
+}
+
+template <class T>
+bool ServerConnection<T>::EnableZeroCopyWrites() {
+#ifdef __linux__
+  int enable = 1;
+  if (setsockopt(socket_.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &enable,
+                 sizeof(enable)) == 0) {
+    zero_copy_enabled_ = true;
+  }
+#endif
+  return zero_copy_enabled_;
+}
+
+template <class T>
+bool ServerConnection<T>::ZeroCopyWritesEnabled() const {
+  return zero_copy_enabled_;
+}
+
+template <class T>
+void ServerConnection<T>::WriteMessageWithBufferZeroCopyAsync(
+    int64_t type, int64_t length, const uint8_t *message,
+    const boost::asio::const_buffer &buffer, const std::function<void()> &on_complete,
+    const std::function<void(const ray::Status &)> &handler) {
+  RAY_CHECK(zero_copy_enabled_);
+  auto write_buffer = std::make_shared<AsyncWriteBuffer>();
+  write_buffer->write_version = RayConfig::instance().ray_protocol_version();
+  write_buffer->write_type = type;
+  write_buffer->write_length = length;
+  write_buffer->write_message.assign(message, message + length);
+  write_buffer->handler = handler;
+
+  std::vector<boost::asio::const_buffer> message_buffers;
+  message_buffers.push_back(boost::asio::buffer(&write_buffer->write_version,
+                                                sizeof(write_buffer->write_version)));
+  message_buffers.push_back(
+      boost::asio::buffer(&write_buffer->write_type, sizeof(write_buffer->write_type)));
+  message_buffers.push_back(boost::asio::buffer(&write_buffer->write_length,
+                                                sizeof(write_buffer->write_length)));
+  message_buffers.push_back(boost::asio::buffer(write_buffer->write_message));
+  // The message is small, so it is copied. The buffer is only written once the
+  // message has been, since the zero-copy writes bypass the asynchronous ones.
+  auto this_ptr = this->shared_from_this();
+  boost::asio::async_write(
+      socket_, message_buffers,
+      [this_ptr, write_buffer, buffer, on_complete](
+          const boost::system::error_code &error, size_t bytes_transferred) {
+        if (error) {
+          on_complete();
+          write_buffer->handler(boost_to_ray_status(error));
+          return;
+        }
+        this_ptr->WriteBufferZeroCopyAsync(buffer, on_complete, write_buffer->handler);
+      });
+}
+
+template <class T>
+void ServerConnection<T>::WriteBufferZeroCopyAsync(
+    const boost::asio::const_buffer &buffer, const std::function<void()> &on_complete,
+    const std::function<void(const ray::Status &)> &handler) {
+  // The buffer is released once the kernel no longer references the part that
+  // was written with MSG_ZEROCOPY, and the write of the rest has completed.
+  auto num_references = std::make_shared<int>(1);
+  std::function<void()> release = [num_references, on_complete]() {
+    if (--*num_references == 0) {
+      on_complete();
+    }
+  };
+  Status status = Status::OK();
+  const uint8_t *data = boost::asio::buffer_cast<const uint8_t *>(buffer);
+  size_t bytes_remaining = boost::asio::buffer_size(buffer);
+  const uint32_t first_seq = zero_copy_next_seq_;
+#ifdef __linux__
+  const int fd = socket_.native_handle();
+  while (bytes_remaining != 0) {
+    struct iovec iov;
+    iov.iov_base = const_cast<uint8_t *>(data);
+    iov.iov_len = bytes_remaining;
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ssize_t bytes_written = sendmsg(fd, &msg, MSG_ZEROCOPY | MSG_DONTWAIT);
+    if (bytes_written > 0) {
+      // The kernel only assigns a sequence number to calls that write data.
+      zero_copy_next_seq_++;
+      data += bytes_written;
+      bytes_remaining -= bytes_written;
+    } else if (bytes_written < 0 && errno == EINTR) {
+      continue;
+    } else if (bytes_written < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+               errno != ENOBUFS) {
+      status = Status::IOError(std::strerror(errno));
+      break;
+    } else {
+      // The socket's send buffer is full, or the memory for tracking the
+      // pending zero-copy writes on the socket is exhausted. Write the rest
+      // asynchronously instead of waiting for room on the send strand.
+      break;
+    }
+  }
+#endif
+  if (zero_copy_next_seq_ != first_seq) {
+    (*num_references)++;
+    zero_copy_writes_.push_back(
+        {first_seq, static_cast<uint32_t>(zero_copy_next_seq_ - 1), 0, release});
+  }
+  if (!status.ok() || bytes_remaining == 0) {
+    release();
+    ReapZeroCopyCompletions(/*timeout_ms=*/0);
+    handler(status);
+    return;
+  }
+  auto this_ptr = this->shared_from_this();
+  boost::asio::async_write(
+      socket_, boost::asio::buffer(data, bytes_remaining),
+      [this_ptr, release, handler](const boost::system::error_code &error,
+                                   size_t bytes_transferred) {
+        release();
+        handler(boost_to_ray_status(error));
+      });
+}
+
+template <class T>
+size_t ServerConnection<T>::ReapZeroCopyCompletions(int timeout_ms) {
+#ifdef __linux__
+  const int fd = socket_.native_handle();
+  bool waited = false;
+  while (!zero_copy_writes_.empty()) {
+    char control[128];
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if ((errno == EAGAIN || errno == EWOULDBLOCK) && timeout_ms > 0 && !waited) {
+        // Completions are queued on the socket's error queue, which poll
+        // reports as POLLERR even if no events are requested.
+        struct pollfd poll_fd = {fd, 0, 0};
+        poll(&poll_fd, 1, timeout_ms);
+        waited = true;
+        continue;
+      }
+      break;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      const auto *error = reinterpret_cast<const struct sock_extended_err *>(
+          CMSG_DATA(cmsg));
+      if (error->ee_errno == 0 && error->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+        CompleteZeroCopyWrites(error->ee_info, error->ee_data);
+      }
+    }
+  }
+#endif
+  return zero_copy_writes_.size();
+}
+
+template <class T>
+void ServerConnection<T>::CompleteZeroCopyWrites(uint32_t first_seq,
+                                                 uint32_t last_seq) {
+  auto it = zero_copy_writes_.begin();
+  while (it != zero_copy_writes_.end()) {
+    const uint32_t overlap_first = std::max(first_seq, it->first_seq);
+    const uint32_t overlap_last = std::min(last_seq, it->last_seq);
+    if (overlap_first <= overlap_last) {
+      it->num_completed += overlap_last - overlap_first + 1;
+    }
+    if (it->num_completed == it->last_seq - it->first_seq + 1) {
+      // Remove the write before running its callback, which may release the
+      // buffer's owner.
+      auto on_complete = std::move(it->on_complete);
+      it = zero_copy_writes_.erase(it);
+      on_complete();
+    } else {
+      it++;
+    }
+  }
+}
+
 template <class T>
 ray::Status ServerConnection<T>::WriteMessage(int64_t type, int64_t length,
                                               const uint8_t *message) {
@@ -79,10 +319,122 @@ ray::Status ServerConnection<T>::WriteMessage(int64_t type, int64_t length,
   message_buffers.push_back(boost::asio::buffer(&length, sizeof(length)));
   message_buffers.push_back(boost::asio::buffer(message, length));
   // Write the message and then wait for more messages.
-  // TODO(swang): Does this need to be an async write?
   return WriteBuffer(message_buffers);
 }
 
+template <class T>
+void ServerConnection<T>::WriteMessageAsync(
+    int64_t type, int64_t length, const uint8_t *message,
+    const std::function<void(const ray::Status &)> &handler) {
+  std::unique_ptr<AsyncWriteBuffer> write_buffer(new AsyncWriteBuffer());
+  write_buffer->write_version = RayConfig::instance().ray_protocol_version();
+  write_buffer->write_type = type;
+  write_buffer->write_length = length;
+  write_buffer->write_message.assign(message, message + length);
+  write_buffer->handler = handler;
+  async_write_queue_bytes_ += length;
+  async_write_queue_.push_back(std::move(write_buffer));
+  DoAsyncWrites();
+}
+
+template <class T>
+void ServerConnection<T>::WriteMessageWithBufferAsync(
+    int64_t type, int64_t length, const uint8_t *message,
+    const boost::asio::const_buffer &buffer,
+    const std::function<void(const ray::Status &)> &handler) {
+  auto write_buffer = std::make_shared<AsyncWriteBuffer>();
+  write_buffer->write_version = RayConfig::instance().ray_protocol_version();
+  write_buffer->write_type = type;
+  write_buffer->write_length = length;
+  write_buffer->write_message.assign(message, message + length);
+  write_buffer->handler = handler;
+
+  std::vector<boost::asio::const_buffer> message_buffers;
+  message_buffers.push_back(boost::asio::buffer(&write_buffer->write_version,
+                                                sizeof(write_buffer->write_version)));
+  message_buffers.push_back(
+      boost::asio::buffer(&write_buffer->write_type, sizeof(write_buffer->write_type)));
+  message_buffers.push_back(boost::asio::buffer(&write_buffer->write_length,
+                                                sizeof(write_buffer->write_length)));
+  message_buffers.push_back(boost::asio::buffer(write_buffer->write_message));
+  message_buffers.push_back(buffer);
+  // Hold a reference to the connection and the copied message until the write
+  // completes.
+  auto this_ptr = this->shared_from_this();
+  boost::asio::async_write(
+      socket_, message_buffers,
+      [this_ptr, write_buffer](const boost::system::error_code &error,
+                               size_t bytes_transferred) {
+        write_buffer->handler(boost_to_ray_status(error));
+      });
+}
+
+template <class T>
+int64_t ServerConnection<T>::PendingWriteBytes() const {
+  return async_write_queue_bytes_;
+}
+
+template <class T>
+bool ServerConnection<T>::IsWriteQueueFull() const {
+  return async_write_queue_bytes_ >
+         RayConfig::instance().async_write_high_water_mark_bytes();
+}
+
+template <class T>
+void ServerConnection<T>::DoAsyncWrites() {
+  if (async_write_in_flight_ || async_write_queue_.empty()) {
+    return;
+  }
+
+  // Coalesce the messages at the front of the queue into a single
+  // gather-write. The buffers point into the queued messages, which stay at
+  // the front of the queue until the write completes.
+  const size_t max_messages = RayConfig::instance().async_write_max_messages();
+  std::vector<boost::asio::const_buffer> message_buffers;
+  size_t num_messages = 0;
+  for (const auto &write_buffer : async_write_queue_) {
+    if (num_messages == max_messages) {
+      break;
+    }
+    message_buffers.push_back(boost::asio::buffer(&write_buffer->write_version,
+                                                  sizeof(write_buffer->write_version)));
+    message_buffers.push_back(
+        boost::asio::buffer(&write_buffer->write_type, sizeof(write_buffer->write_type)));
+    message_buffers.push_back(boost::asio::buffer(&write_buffer->write_length,
+                                                  sizeof(write_buffer->write_length)));
+    message_buffers.push_back(boost::asio::buffer(write_buffer->write_message));
+    num_messages++;
+  }
+
+  async_write_in_flight_ = true;
+  // Hold a reference to the connection until the write completes, in case the
+  // owner drops it in the meantime.
+  auto this_ptr = this->shared_from_this();
+  boost::asio::async_write(
+      socket_, message_buffers,
+      [this, this_ptr, num_messages](const boost::system::error_code &error,
+                                     size_t bytes_transferred) {
+        ray::Status status = boost_to_ray_status(error);
+        async_write_in_flight_ = false;
+        // Pop the written messages before running their handlers, since the
+        // handlers may queue more messages.
+        std::vector<std::unique_ptr<AsyncWriteBuffer>> written_buffers;
+        for (size_t i = 0; i < num_messages; i++) {
+          async_write_queue_bytes_ -= async_write_queue_.front()->write_length;
+          written_buffers.push_back(std::move(async_write_queue_.front()));
+          async_write_queue_.pop_front();
+        }
+        for (const auto &write_buffer : written_buffers) {
+          if (write_buffer->handler) {
+            write_buffer->handler(status);
+          }
+        }
+        // Write the messages that were queued in the meantime. If the write
+        // failed, these will fail as well.
+        DoAsyncWrites();
+      });
+}
+
 template <class T>
 std::shared_ptr<ClientConnection<T>> ClientConnection<T>::Create(
     ClientHandler<T> &client_handler, MessageHandler<T> &message_handler,
@@ -94,13 +446,24 @@ std::shared_ptr<ClientConnection<T>> ClientConnection<T>::Create(
   return self;
 }
 
+namespace {
+
+/// The size of a message header: the protocol version, the message type, and
+/// the length of the message.
+constexpr size_t kMessageHeaderSize = 3 * sizeof(int64_t);
+
+}  // namespace
+
 template <class T>
 ClientConnection<T>::ClientConnection(MessageHandler<T> &message_handler,
                                       boost::asio::basic_stream_socket<T> &&socket,
                                       const std::string &debug_label)
     : ServerConnection<T>(std::move(socket)),
       message_handler_(message_handler),
-      debug_label_(debug_label) {}
+      debug_label_(debug_label),
+      read_buffer_(RayConfig::instance().client_connection_read_buffer_bytes()),
+      read_start_(0),
+      read_end_(0) {}
 
 template <class T>
 const ClientID &ClientConnection<T>::GetClientID() {
@@ -114,51 +477,143 @@ void ClientConnection<T>::SetClientID(const ClientID &client_id) {
 
 template <class T>
 void ClientConnection<T>::ProcessMessages() {
-  // Wait for a message header from the client. The message header includes the
-  // protocol version, the message type, and the length of the message.
-  std::vector<boost::asio::mutable_buffer> header;
-  header.push_back(boost::asio::buffer(&read_version_, sizeof(read_version_)));
-  header.push_back(boost::asio::buffer(&read_type_, sizeof(read_type_)));
-  header.push_back(boost::asio::buffer(&read_length_, sizeof(read_length_)));
-  boost::asio::async_read(
-      ServerConnection<T>::socket_, header,
-      boost::bind(&ClientConnection<T>::ProcessMessageHeader, this->shared_from_this(),
-                  boost::asio::placeholders::error));
+  if (HasBufferedMessage()) {
+    // The next message was received along with an earlier one. Process it from
+    // the event loop instead of from here, since the caller is usually the
+    // handler for the previous message.
+    ServerConnection<T>::socket_.get_io_service().post(
+        boost::bind(&ClientConnection<T>::ProcessBufferedMessage,
+                    shared_ClientConnection_from_this()));
+    return;
+  }
+
+  // Read as much as is available, up to the end of the receive buffer.
+  ReserveReadBuffer();
+  ServerConnection<T>::socket_.async_read_some(
+      boost::asio::buffer(read_buffer_.data() + read_end_,
+                          read_buffer_.size() - read_end_),
+      boost::bind(&ClientConnection<T>::ProcessReadData,
+                  shared_ClientConnection_from_this(),
+                  boost::asio::placeholders::error,
+                  boost::asio::placeholders::bytes_transferred));
+}
+
+template <class T>
+void ClientConnection<T>::ReadBuffer(
+    const std::vector<boost::asio::mutable_buffer> &buffer,
+    boost::system::error_code &ec) {
+  std::vector<boost::asio::mutable_buffer> remaining_buffer;
+  for (const auto &b : buffer) {
+    // Copy any bytes that were already received, then read the rest from the
+    // socket.
+    const size_t buffer_size = boost::asio::buffer_size(b);
+    const size_t num_buffered = std::min(buffer_size, read_end_ - read_start_);
+    std::memcpy(boost::asio::buffer_cast<uint8_t *>(b), read_buffer_.data() + read_start_,
+                num_buffered);
+    read_start_ += num_buffered;
+    if (num_buffered < buffer_size) {
+      remaining_buffer.push_back(b + num_buffered);
+    }
+  }
+  ec = boost::system::error_code();
+  if (!remaining_buffer.empty()) {
+    ServerConnection<T>::ReadBuffer(remaining_buffer, ec);
+  }
 }
 
 template <class T>
-void ClientConnection<T>::ProcessMessageHeader(const boost::system::error_code &error) {
+bool ClientConnection<T>::HasBufferedMessage() const {
+  const size_t num_buffered = read_end_ - read_start_;
+  if (num_buffered < kMessageHeaderSize) {
+    return false;
+  }
+  uint64_t length;
+  std::memcpy(&length, read_buffer_.data() + read_start_ + 2 * sizeof(int64_t),
+              sizeof(length));
+  return num_buffered - kMessageHeaderSize >= length;
+}
+
+template <class T>
+void ClientConnection<T>::ReserveReadBuffer() {
+  const size_t num_buffered = read_end_ - read_start_;
+  size_t required_size = RayConfig::instance().client_connection_read_buffer_bytes();
+  if (num_buffered >= kMessageHeaderSize) {
+    // Make sure that the whole message fits.
+    uint64_t length;
+    std::memcpy(&length, read_buffer_.data() + read_start_ + 2 * sizeof(int64_t),
+                sizeof(length));
+    required_size = std::max<size_t>(required_size, kMessageHeaderSize + length);
+  }
+  // Move the unprocessed bytes to the front of the buffer, so that the buffer
+  // does not grow with the total number of bytes received.
+  if (read_start_ > 0) {
+    std::memmove(read_buffer_.data(), read_buffer_.data() + read_start_, num_buffered);
+    read_start_ = 0;
+    read_end_ = num_buffered;
+  }
+  if (read_buffer_.size() < required_size) {
+    read_buffer_.resize(required_size);
+  } else if (num_buffered == 0 && read_buffer_.size() > required_size) {
+    // Release the memory that was used for an earlier, larger message.
+    std::vector<uint8_t>(required_size).swap(read_buffer_);
+  }
+}
+
+template <class T>
+void ClientConnection<T>::ProcessReadData(const boost::system::error_code &error,
+                                          size_t bytes_transferred) {
   if (error) {
     // If there was an error, disconnect the client.
-    read_type_ = static_cast<int64_t>(protocol::MessageType::DisconnectClient);
-    read_length_ = 0;
-    ProcessMessage(error);
+    ProcessMessage(static_cast<int64_t>(protocol::MessageType::DisconnectClient),
+                   nullptr);
     return;
   }
 
-  // If there was no error, make sure the protocol version matches.
-  RAY_CHECK(read_version_ == RayConfig::instance().ray_protocol_version());
-  // Resize the message buffer to match the received length.
-  read_message_.resize(read_length_);
-  // Wait for the message to be read.
-  boost::asio::async_read(
-      ServerConnection<T>::socket_, boost::asio::buffer(read_message_),
-      boost::bind(&ClientConnection<T>::ProcessMessage, this->shared_from_this(),
-                  boost::asio::placeholders::error));
+  read_end_ += bytes_transferred;
+  if (HasBufferedMessage()) {
+    ProcessBufferedMessage();
+  } else {
+    // Wait for the rest of the message.
+    ProcessMessages();
+  }
 }
 
 template <class T>
-void ClientConnection<T>::ProcessMessage(const boost::system::error_code &error) {
-  if (error) {
-    read_type_ = static_cast<int64_t>(protocol::MessageType::DisconnectClient);
+void ClientConnection<T>::ProcessBufferedMessage() {
+  RAY_CHECK(HasBufferedMessage());
+  int64_t version;
+  int64_t type;
+  uint64_t length;
+  const uint8_t *header = read_buffer_.data() + read_start_;
+  std::memcpy(&version, header, sizeof(version));
+  std::memcpy(&type, header + sizeof(int64_t), sizeof(type));
+  std::memcpy(&length, header + 2 * sizeof(int64_t), sizeof(length));
+  // Make sure the protocol version matches.
+  RAY_CHECK(version == RayConfig::instance().ray_protocol_version());
+  // Consume the message before calling the handler, since the handler may
+  // read more from the connection. The message stays in place until the
+  // handler calls ProcessMessages.
+  read_start_ += kMessageHeaderSize + length;
+  const uint8_t *message = header + kMessageHeaderSize;
+  if (length > 0 && reinterpret_cast<uintptr_t>(message) % alignof(uint64_t) != 0) {
+    // Handlers read flatbuffers in place, which requires an aligned message.
+    // A message follows an earlier one in the buffer at any offset, since
+    // message lengths need not be multiples of 8, so copy it.
+    aligned_message_.resize((length + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    std::memcpy(aligned_message_.data(), message, length);
+    message = reinterpret_cast<const uint8_t *>(aligned_message_.data());
   }
+  ProcessMessage(type, message);
+}
 
+template <class T>
+void ClientConnection<T>::ProcessMessage(int64_t message_type, const uint8_t *message) {
   uint64_t start_ms = current_time_ms();
-  message_handler_(this->shared_from_this(), read_type_, read_message_.data());
+  message_handler_(shared_ClientConnection_from_this(), message_type, message);
   uint64_t interval = current_time_ms() - start_ms;
   if (interval > RayConfig::instance().handler_warning_timeout_ms()) {
-    RAY_LOG(WARNING) << "[" << debug_label_ << "]ProcessMessage with type " << read_type_
-                     << " took " << interval << " ms ";
+    RAY_LOG(WARNING) << "[" << debug_label_ << "]ProcessMessage with type "
+                     << message_type << " took " << interval << " ms ";
   }
 }
 
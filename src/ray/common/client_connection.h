@@ -1,6 +1,7 @@
 #ifndef RAY_COMMON_CLIENT_CONNECTION_H
 #define RAY_COMMON_CLIENT_CONNECTION_H
 
+#include <deque>
 #include <memory>
 
 #include <boost/asio.hpp>
@@ -24,12 +25,22 @@ ray::Status TcpConnect(boost::asio::ip::tcp::socket &socket,
 /// \typename ServerConnection
 ///
 /// A generic type representing a client connection to a server. This typename
-/// can be used to write messages synchronously to the server.
+/// can be used to write messages synchronously or asynchronously to the
+/// server.
 template <typename T>
-class ServerConnection {
+class ServerConnection : public std::enable_shared_from_this<ServerConnection<T>> {
  public:
-  /// Create a connection to the server.
-  ServerConnection(boost::asio::basic_stream_socket<T> &&socket);
+  /// Allocate a new server connection.
+  ///
+  /// \param socket A reference to the server socket.
+  /// \return std::shared_ptr<ServerConnection>.
+  static std::shared_ptr<ServerConnection<T>> Create(
+      boost::asio::basic_stream_socket<T> &&socket);
+
+  /// Destroy the connection. The completion callbacks of any zero-copy writes
+  /// that are still pending are run, since their completions can no longer be
+  /// reaped once the socket is closed.
+  virtual ~ServerConnection();
 
   /// Write a message to the client.
   ///
@@ -39,6 +50,47 @@ class ServerConnection {
   /// \return Status.
   ray::Status WriteMessage(int64_t type, int64_t length, const uint8_t *message);
 
+  /// Write a message to the client asynchronously. The message is copied and
+  /// queued behind any other messages that have not been written yet. Queued
+  /// messages are written in order, several at a time with a single
+  /// gather-write.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param handler A callback to run once the message has been written, or
+  /// the write failed.
+  /// \return Void.
+  void WriteMessageAsync(int64_t type, int64_t length, const uint8_t *message,
+                         const std::function<void(const ray::Status &)> &handler);
+
+  /// Write a message followed by a buffer to the client asynchronously, with a
+  /// single gather-write. The message is copied, but the buffer is not, so it
+  /// must stay valid until the handler runs. The write is not queued, so the
+  /// caller must not start another asynchronous write on this connection until
+  /// the handler runs.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param buffer The buffer to write after the message.
+  /// \param handler A callback to run once the message and buffer have been
+  /// written, or the write failed.
+  /// \return Void.
+  void WriteMessageWithBufferAsync(
+      int64_t type, int64_t length, const uint8_t *message,
+      const boost::asio::const_buffer &buffer,
+      const std::function<void(const ray::Status &)> &handler);
+
+  /// \return The number of bytes queued for asynchronous writes that have not
+  /// been written yet.
+  int64_t PendingWriteBytes() const;
+
+  /// \return Whether the bytes queued for asynchronous writes are above the
+  /// high-water mark. Callers that can defer work should not queue more
+  /// messages on this connection until it drains.
+  bool IsWriteQueueFull() const;
+
   /// Write a buffer to this connection.
   ///
   /// \param buffer The buffer.
@@ -49,12 +101,120 @@ class ServerConnection {
   ///
   /// \param buffer The buffer.
   /// \param ec The error code object in which to store error codes.
-  void ReadBuffer(const std::vector<boost::asio::mutable_buffer> &buffer,
-                  boost::system::error_code &ec);
+  virtual void ReadBuffer(const std::vector<boost::asio::mutable_buffer> &buffer,
+                          boost::system::error_code &ec);
+
+  /// Close the connection. Pending asynchronous operations fail with an error.
+  void Close();
+
+  /// Enable zero-copy writes on this connection. This is only supported for
+  /// TCP sockets on Linux 4.14 or later.
+  ///
+  /// \return Whether zero-copy writes are enabled.
+  bool EnableZeroCopyWrites();
+
+  /// \return Whether zero-copy writes are enabled on this connection.
+  bool ZeroCopyWritesEnabled() const;
+
+  /// Write a message followed by a buffer to the client asynchronously. The
+  /// buffer is written with MSG_ZEROCOPY, so that the kernel transmits it from
+  /// the buffer's pages instead of copying it into the socket's send buffer,
+  /// as far as the send buffer has room. The rest is written as by
+  /// WriteMessageWithBufferAsync. The kernel references the pages until the
+  /// data has been acknowledged, so the buffer must stay valid until the
+  /// completion callback runs, which is usually during a later call to
+  /// ReapZeroCopyCompletions. The same restrictions on other asynchronous
+  /// writes apply as for WriteMessageWithBufferAsync.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param buffer The buffer to write after the message.
+  /// \param on_complete A callback to run once the kernel no longer references
+  /// the buffer.
+  /// \param handler A callback to run once the message and buffer have been
+  /// written, or the write failed.
+  /// \return Void.
+  void WriteMessageWithBufferZeroCopyAsync(
+      int64_t type, int64_t length, const uint8_t *message,
+      const boost::asio::const_buffer &buffer, const std::function<void()> &on_complete,
+      const std::function<void(const ray::Status &)> &handler);
+
+  /// Run the completion callbacks of the zero-copy writes whose buffers the
+  /// kernel no longer references.
+  ///
+  /// \param timeout_ms How long to wait for a completion if none is ready, or
+  /// 0 to not wait.
+  /// \return The number of zero-copy writes that are still pending.
+  size_t ReapZeroCopyCompletions(int timeout_ms);
 
  protected:
+  /// A protected constructor for a server connection.
+  ServerConnection(boost::asio::basic_stream_socket<T> &&socket);
+
   /// The socket connection to the server.
   boost::asio::basic_stream_socket<T> socket_;
+
+ private:
+  /// A message that is queued for writing.
+  struct AsyncWriteBuffer {
+    int64_t write_version;
+    int64_t write_type;
+    uint64_t write_length;
+    std::vector<uint8_t> write_message;
+    std::function<void(const ray::Status &)> handler;
+  };
+
+  /// A zero-copy write whose buffer the kernel may still reference. Each
+  /// sendmsg call that writes part of the buffer is assigned the next
+  /// sequence number, and the kernel reports ranges of completed calls.
+  struct ZeroCopyWrite {
+    /// The sequence number of the first sendmsg call for the write.
+    uint32_t first_seq;
+    /// The sequence number of the last sendmsg call for the write.
+    uint32_t last_seq;
+    /// The number of the write's sendmsg calls that have completed.
+    uint32_t num_completed;
+    std::function<void()> on_complete;
+  };
+
+  /// Write the queued messages, if no write is in flight already.
+  void DoAsyncWrites();
+
+  /// Write a buffer with MSG_ZEROCOPY until the socket's send buffer is full,
+  /// and then write the rest asynchronously.
+  ///
+  /// \param buffer The buffer.
+  /// \param on_complete A callback to run once the kernel no longer references
+  /// the buffer.
+  /// \param handler A callback to run once the buffer has been written, or the
+  /// write failed.
+  void WriteBufferZeroCopyAsync(const boost::asio::const_buffer &buffer,
+                                const std::function<void()> &on_complete,
+                                const std::function<void(const ray::Status &)> &handler);
+
+  /// Credit a range of completed sendmsg calls to the pending zero-copy
+  /// writes, and run the callbacks of the writes that are complete.
+  ///
+  /// \param first_seq The first sequence number in the range.
+  /// \param last_seq The last sequence number in the range.
+  void CompleteZeroCopyWrites(uint32_t first_seq, uint32_t last_seq);
+
+  /// The messages that are queued for writing. The messages at the front of
+  /// the queue may be in flight.
+  std::deque<std::unique_ptr<AsyncWriteBuffer>> async_write_queue_;
+  /// The number of bytes in async_write_queue_.
+  int64_t async_write_queue_bytes_;
+  /// Whether a gather-write of the front of async_write_queue_ is in flight.
+  bool async_write_in_flight_;
+  /// Whether zero-copy writes are enabled on the socket.
+  bool zero_copy_enabled_;
+  /// The sequence number that the kernel will assign to the next successful
+  /// zero-copy sendmsg call.
+  uint32_t zero_copy_next_seq_;
+  /// The zero-copy writes that the kernel has not reported as complete, in
+  /// order of their sequence numbers.
+  std::deque<ZeroCopyWrite> zero_copy_writes_;
 };
 
 template <typename T>
@@ -72,8 +232,7 @@ using MessageHandler =
 /// writing messages to the client, like in ServerConnection, this typename can
 /// also be used to process messages asynchronously from client.
 template <typename T>
-class ClientConnection : public ServerConnection<T>,
-                         public std::enable_shared_from_this<ClientConnection<T>> {
+class ClientConnection : public ServerConnection<T> {
  public:
   /// Allocate a new node client connection.
   ///
@@ -93,20 +252,49 @@ class ClientConnection : public ServerConnection<T>,
 
   /// Listen for and process messages from the client connection. Once a
   /// message has been fully received, the client manager's
-  /// ProcessClientMessage handler will be called.
+  /// ProcessClientMessage handler will be called. The message passed to the
+  /// handler points into the connection's receive buffer, so it is only valid
+  /// until the handler calls ProcessMessages again.
   void ProcessMessages();
 
+  /// Read a buffer from this connection. Bytes that were already received
+  /// along with earlier messages are consumed before reading from the socket.
+  ///
+  /// \param buffer The buffer.
+  /// \param ec The error code object in which to store error codes.
+  void ReadBuffer(const std::vector<boost::asio::mutable_buffer> &buffer,
+                  boost::system::error_code &ec) override;
+
  private:
   /// A private constructor for a node client connection.
   ClientConnection(MessageHandler<T> &message_handler,
                    boost::asio::basic_stream_socket<T> &&socket,
                    const std::string &debug_label);
-  /// Process an error from the last operation, then process the  message
-  /// header from the client.
-  void ProcessMessageHeader(const boost::system::error_code &error);
-  /// Process an error from reading the message header, then process the
-  /// message from the client.
-  void ProcessMessage(const boost::system::error_code &error);
+  /// \return A shared pointer to this connection.
+  std::shared_ptr<ClientConnection<T>> shared_ClientConnection_from_this() {
+    return std::static_pointer_cast<ClientConnection<T>>(
+        ServerConnection<T>::shared_from_this());
+  }
+  /// \return Whether the receive buffer holds a complete message.
+  bool HasBufferedMessage() const;
+  /// Make room at the end of the receive buffer for the rest of the next
+  /// message, or for a full read if the next message's length is not known
+  /// yet.
+  void ReserveReadBuffer();
+  /// Process an error from the last read, then process the next message in
+  /// the receive buffer, or read more if there is no complete message.
+  ///
+  /// \param error The error from the read.
+  /// \param bytes_transferred The number of bytes read.
+  void ProcessReadData(const boost::system::error_code &error,
+                       size_t bytes_transferred);
+  /// Consume the next message from the receive buffer and process it.
+  void ProcessBufferedMessage();
+  /// Call the message handler.
+  ///
+  /// \param message_type The type of the message.
+  /// \param message The message contents.
+  void ProcessMessage(int64_t message_type, const uint8_t *message);
 
   /// The ClientID of the remote client.
   ClientID client_id_;
@@ -114,11 +302,16 @@ class ClientConnection : public ServerConnection<T>,
   MessageHandler<T> message_handler_;
   /// A label used for debug messages.
   const std::string debug_label_;
-  /// Buffers for the current message being read rom the client.
-  int64_t read_version_;
-  int64_t read_type_;
-  uint64_t read_length_;
-  std::vector<uint8_t> read_message_;
+  /// The buffer that messages from the client are read into. The bytes in
+  /// [read_start_, read_end_) have been received but not processed yet. A
+  /// single read can receive many messages, which are then processed without
+  /// reading from the socket again.
+  std::vector<uint8_t> read_buffer_;
+  size_t read_start_;
+  size_t read_end_;
+  /// A copy of the message being processed, if it did not start at an 8-byte
+  /// aligned address in read_buffer_.
+  std::vector<uint64_t> aligned_message_;
 };
 
 using LocalServerConnection = ServerConnection<boost::asio::local::stream_protocol>;
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+
+#include "common/state/ray_config.h"
+#include "ray/common/client_connection.h"
+
+namespace ray {
+
+class ClientConnectionTest : public ::testing::Test {
+ public:
+  ClientConnectionTest() : io_service_(), in_(io_service_), out_(io_service_) {
+    boost::asio::local::connect_pair(in_, out_);
+  }
+
+  /// Write a message to the other end of the socket pair.
+  ///
+  /// \param type The message type.
+  /// \param message The message contents.
+  void WriteMessage(int64_t type, const std::string &message) {
+    int64_t version = RayConfig::instance().ray_protocol_version();
+    uint64_t length = message.size();
+    boost::asio::write(out_, boost::asio::buffer(&version, sizeof(version)));
+    boost::asio::write(out_, boost::asio::buffer(&type, sizeof(type)));
+    boost::asio::write(out_, boost::asio::buffer(&length, sizeof(length)));
+    boost::asio::write(out_, boost::asio::buffer(message));
+  }
+
+  /// Read a message written by a ServerConnection from the other end of the
+  /// socket pair.
+  ///
+  /// \param[out] type The message type.
+  /// \param[out] message The message contents.
+  void ReadMessage(int64_t *type, std::string *message) {
+    int64_t version;
+    uint64_t length;
+    boost::asio::read(out_, boost::asio::buffer(&version, sizeof(version)));
+    ASSERT_EQ(version, RayConfig::instance().ray_protocol_version());
+    boost::asio::read(out_, boost::asio::buffer(type, sizeof(*type)));
+    boost::asio::read(out_, boost::asio::buffer(&length, sizeof(length)));
+    message->resize(length);
+    boost::asio::read(out_, boost::asio::buffer(&(*message)[0], length));
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  boost::asio::local::stream_protocol::socket in_;
+  boost::asio::local::stream_protocol::socket out_;
+};
+
+TEST_F(ClientConnectionTest, TestAsyncWritesInOrder) {
+  auto conn = LocalServerConnection::Create(std::move(in_));
+  std::vector<std::string> messages = {"first", "second", "third"};
+  std::vector<int> num_written;
+  for (int i = 0; i < static_cast<int>(messages.size()); i++) {
+    const auto &message = messages[i];
+    conn->WriteMessageAsync(i, message.size(),
+                            reinterpret_cast<const uint8_t *>(message.data()),
+                            [&num_written, i](const ray::Status &status) {
+                              ASSERT_TRUE(status.ok());
+                              num_written.push_back(i);
+                            });
+  }
+  // Messages are copied when they are queued.
+  messages.clear();
+  ASSERT_EQ(conn->PendingWriteBytes(), 16);
+  ASSERT_FALSE(conn->IsWriteQueueFull());
+
+  io_service_.run();
+  ASSERT_EQ(num_written, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(conn->PendingWriteBytes(), 0);
+
+  // The messages arrive in the order that they were queued, even if they
+  // were coalesced into a single write.
+  int64_t type;
+  std::string message;
+  ReadMessage(&type, &message);
+  ASSERT_EQ(type, 0);
+  ASSERT_EQ(message, "first");
+  ReadMessage(&type, &message);
+  ASSERT_EQ(type, 1);
+  ASSERT_EQ(message, "second");
+  ReadMessage(&type, &message);
+  ASSERT_EQ(type, 2);
+  ASSERT_EQ(message, "third");
+}
+
+TEST_F(ClientConnectionTest, TestAsyncWriteFailure) {
+  auto conn = LocalServerConnection::Create(std::move(in_));
+  out_.close();
+  const std::string message = "message";
+  int num_failed = 0;
+  for (int i = 0; i < 2; i++) {
+    conn->WriteMessageAsync(0, message.size(),
+                            reinterpret_cast<const uint8_t *>(message.data()),
+                            [&num_failed](const ray::Status &status) {
+                              ASSERT_TRUE(status.IsIOError());
+                              num_failed++;
+                            });
+  }
+  // Dropping the connection does not drop the queued writes.
+  conn.reset();
+  io_service_.run();
+  ASSERT_EQ(num_failed, 2);
+}
+
+TEST_F(ClientConnectionTest, TestProcessBufferedMessages) {
+  // Write all of the messages and some raw data before the connection starts
+  // reading, so that they are received together.
+  const std::vector<std::string> messages = {"first", "second", "third"};
+  for (size_t i = 0; i < messages.size(); i++) {
+    WriteMessage(i, messages[i]);
+  }
+  const std::string raw_data = "raw data";
+  boost::asio::write(out_, boost::asio::buffer(raw_data));
+
+  std::vector<std::string> received;
+  ClientHandler<boost::asio::local::stream_protocol> client_handler =
+      [](LocalClientConnection &client) { client.ProcessMessages(); };
+  MessageHandler<boost::asio::local::stream_protocol> message_handler =
+      [&messages, &raw_data, &received](std::shared_ptr<LocalClientConnection> client,
+                                        int64_t message_type, const uint8_t *message) {
+        ASSERT_LT(message_type, static_cast<int64_t>(messages.size()));
+        received.emplace_back(reinterpret_cast<const char *>(message),
+                              messages[message_type].size());
+        if (received.size() < messages.size()) {
+          client->ProcessMessages();
+          return;
+        }
+        // Raw data that follows a message can be read after the message,
+        // even if it was received along with the message.
+        std::string data(raw_data.size(), '\0');
+        boost::system::error_code ec;
+        client->ReadBuffer({boost::asio::buffer(&data[0], data.size())}, ec);
+        ASSERT_FALSE(ec);
+        ASSERT_EQ(data, raw_data);
+      };
+  auto conn = LocalClientConnection::Create(client_handler, message_handler,
+                                            std::move(in_), "test");
+  io_service_.run();
+  ASSERT_EQ(received, messages);
+}
+
+TEST_F(ClientConnectionTest, TestProcessMessagesAligned) {
+  // Messages whose lengths are not multiples of 8 are received together, so
+  // most of them start at a misaligned offset in the receive buffer.
+  std::vector<std::string> messages;
+  for (size_t length = 1; length <= 17; length++) {
+    messages.emplace_back(length, static_cast<char>('a' + length));
+    WriteMessage(messages.size() - 1, messages.back());
+  }
+
+  std::vector<std::string> received;
+  ClientHandler<boost::asio::local::stream_protocol> client_handler =
+      [](LocalClientConnection &client) { client.ProcessMessages(); };
+  MessageHandler<boost::asio::local::stream_protocol> message_handler =
+      [&messages, &received](std::shared_ptr<LocalClientConnection> client,
+                             int64_t message_type, const uint8_t *message) {
+        ASSERT_LT(message_type, static_cast<int64_t>(messages.size()));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(message) % alignof(uint64_t), 0u);
+        received.emplace_back(reinterpret_cast<const char *>(message),
+                              messages[message_type].size());
+        if (received.size() < messages.size()) {
+          client->ProcessMessages();
+        }
+      };
+  auto conn = LocalClientConnection::Create(client_handler, message_handler,
+                                            std::move(in_), "test");
+  io_service_.run();
+  ASSERT_EQ(received, messages);
+}
+
+}  // namespace ray
@@ -113,6 +113,7 @@ AsyncGcsClient::AsyncGcsClient(const std::string &address, int port,
   task_reconstruction_log_.reset(new TaskReconstructionLog(shard_contexts_, this));
   task_lease_table_.reset(new TaskLeaseTable(shard_contexts_, this));
   heartbeat_table_.reset(new HeartbeatTable(shard_contexts_, this));
+  heartbeat_batch_table_.reset(new HeartbeatBatchTable(shard_contexts_, this));
   profile_table_.reset(new ProfileTable(shard_contexts_, this));
   command_type_ = command_type;
 
@@ -193,6 +194,10 @@ ClassTable &AsyncGcsClient::class_table() { return *class_table_; }
 
 HeartbeatTable &AsyncGcsClient::heartbeat_table() { return *heartbeat_table_; }
 
+HeartbeatBatchTable &AsyncGcsClient::heartbeat_batch_table() {
+  return *heartbeat_batch_table_;
+}
+
 ErrorTable &AsyncGcsClient::error_table() { return *error_table_; }
 
 DriverTable &AsyncGcsClient::driver_table() { return *driver_table_; }
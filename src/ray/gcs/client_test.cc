@@ -9,6 +9,7 @@ extern "C" {
 
 #include "ray/gcs/client.h"
 #include "ray/gcs/tables.h"
+#include "ray/raylet/heartbeat_codec.h"
 
 namespace ray {
 
@@ -916,6 +917,56 @@ TEST_F(TestGcsWithAsio, TestClientTableMarkDisconnected) {
   TestClientTableMarkDisconnected(job_id_, client_);
 }
 
+void TestHeartbeatBatchSubscribe(const JobID &job_id,
+                                 std::shared_ptr<gcs::AsyncGcsClient> client) {
+  // Encode a full heartbeat followed by delta heartbeats that each depend on
+  // the one before, with a different load each time.
+  const ClientID client_id = ClientID::from_random();
+  const int num_heartbeats = 4;
+  raylet::HeartbeatEncoder encoder(/*full_heartbeat_period=*/num_heartbeats);
+  raylet::SchedulingResources resources(
+      raylet::ResourceSet(std::unordered_map<std::string, double>({{"CPU", 8}})));
+  auto batch = std::make_shared<HeartbeatBatchTableDataT>();
+  for (int i = 1; i <= num_heartbeats; i++) {
+    const double load = i;
+    resources.SetLoadResources(
+        raylet::ResourceSet(std::unordered_map<std::string, double>({{"CPU", load}})));
+    std::unique_ptr<HeartbeatTableDataT> heartbeat(new HeartbeatTableDataT());
+    heartbeat->client_id = client_id.binary();
+    encoder.Encode(resources, heartbeat.get());
+    batch->batch.push_back(std::move(heartbeat));
+  }
+
+  // Check that the published batch is received in order, so that each delta
+  // heartbeat is decoded on top of the heartbeat it depends on.
+  auto notification_callback = [client_id, num_heartbeats](
+      gcs::AsyncGcsClient *client, const ClientID &id,
+      const HeartbeatBatchTableDataT &data) {
+    ASSERT_EQ(data.batch.size(), static_cast<size_t>(num_heartbeats));
+    raylet::HeartbeatDecoder decoder;
+    for (int i = 0; i < num_heartbeats; i++) {
+      ASSERT_EQ(ClientID::from_binary(data.batch[i]->client_id), client_id);
+      ASSERT_TRUE(decoder.Decode(*data.batch[i]));
+      ASSERT_EQ(decoder.GetLoadResources().GetNumCpus(), static_cast<double>(i + 1));
+    }
+    test->Stop();
+  };
+
+  // Publish the batch once the subscription is done.
+  auto subscribe_callback = [job_id, batch](gcs::AsyncGcsClient *client) {
+    RAY_CHECK_OK(
+        client->heartbeat_batch_table().Add(job_id, ClientID::nil(), batch, nullptr));
+  };
+  RAY_CHECK_OK(client->heartbeat_batch_table().Subscribe(
+      job_id, ClientID::nil(), notification_callback, nullptr, subscribe_callback));
+  test->Start();
+}
+
+TEST_F(TestGcsWithAsio, TestHeartbeatBatchSubscribe) {
+  test = this;
+  TestHeartbeatBatchSubscribe(job_id_, client_);
+}
+
 #undef TEST_MACRO
 
 }  // namespace gcs
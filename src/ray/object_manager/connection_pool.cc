@@ -60,6 +60,24 @@ void ConnectionPool::ReleaseSender(ConnectionType type,
   Return(conn_map, conn->GetClientID(), conn);
 }
 
+ray::Status ConnectionPool::RemoveSender(ConnectionType type,
+                                         std::shared_ptr<SenderConnection> conn) {
+  std::unique_lock<std::mutex> guard(connection_mutex);
+  SenderMapType &conn_map = (type == ConnectionType::MESSAGE)
+                                ? message_send_connections_
+                                : transfer_send_connections_;
+  SenderMapType &avail_conn_map = (type == ConnectionType::MESSAGE)
+                                      ? available_message_send_connections_
+                                      : available_transfer_send_connections_;
+  const ClientID &client_id = conn->GetClientID();
+  if (!Remove(conn_map, client_id, conn)) {
+    return ray::Status::KeyError("The sender connection is not registered.");
+  }
+  // The connection is usually borrowed, but remove it in case it was released.
+  Remove(avail_conn_map, client_id, conn);
+  return ray::Status::OK();
+}
+
 void ConnectionPool::Add(ReceiverMapType &conn_map, const ClientID &client_id,
                          std::shared_ptr<TcpClientConnection> conn) {
   conn_map[client_id].push_back(std::move(conn));
@@ -85,6 +103,24 @@ void ConnectionPool::Remove(ReceiverMapType &conn_map, const ClientID &client_id
   connections.erase(connections.begin() + pos);
 }
 
+bool ConnectionPool::Remove(SenderMapType &conn_map, const ClientID &client_id,
+                            const std::shared_ptr<SenderConnection> &conn) {
+  auto it = conn_map.find(client_id);
+  if (it == conn_map.end()) {
+    return false;
+  }
+  auto &connections = it->second;
+  auto conn_it = std::find(connections.begin(), connections.end(), conn);
+  if (conn_it == connections.end()) {
+    return false;
+  }
+  connections.erase(conn_it);
+  if (connections.empty()) {
+    conn_map.erase(it);
+  }
+  return true;
+}
+
 uint64_t ConnectionPool::Count(SenderMapType &conn_map, const ClientID &client_id) {
   auto it = conn_map.find(client_id);
   if (it == conn_map.end()) {
@@ -76,9 +76,8 @@ class ConnectionPool {
   /// \return Void.
   void ReleaseSender(ConnectionType type, std::shared_ptr<SenderConnection> &conn);
 
-  // TODO(hme): Implement with error handling.
   /// Remove a sender connection. This is invoked if the connection is no longer
-  /// usable.
+  /// usable. The connection is not closed.
   ///
   /// \param type The type of connection.
   /// \param conn The actual connection.
@@ -108,6 +107,12 @@ class ConnectionPool {
   void Remove(ReceiverMapType &conn_map, const ClientID &client_id,
               std::shared_ptr<TcpClientConnection> &conn);
 
+  /// Removes the given sender for ClientID from the given map.
+  ///
+  /// \return Whether the sender was in the map.
+  bool Remove(SenderMapType &conn_map, const ClientID &client_id,
+              const std::shared_ptr<SenderConnection> &conn);
+
   /// Returns the count of sender connections to ClientID.
   uint64_t Count(SenderMapType &conn_map, const ClientID &client_id);
 
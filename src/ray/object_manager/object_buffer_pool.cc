@@ -39,6 +39,20 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Ge
     uint64_t chunk_index) {
   std::lock_guard<std::mutex> lock(pool_mutex_);
   RAY_LOG(DEBUG) << "GetChunk " << object_id << " " << data_size << " " << metadata_size;
+  auto create_it = create_buffer_state_.find(object_id);
+  if (create_it != create_buffer_state_.end()) {
+    // The object is still being received, so relay the chunks that were
+    // already received.
+    CreateBufferState &buffer_state = create_it->second;
+    if (buffer_state.chunk_state[chunk_index] != CreateChunkState::SEALED) {
+      return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+          errored_chunk_,
+          ray::Status::IOError("Unable to obtain object chunk, chunk not received."));
+    }
+    buffer_state.references++;
+    return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+        buffer_state.chunk_info[chunk_index], ray::Status::OK());
+  }
   if (get_buffer_state_.count(object_id) == 0) {
     plasma::ObjectBuffer object_buffer;
     plasma::ObjectID plasma_id = object_id.to_plasma_id();
@@ -67,6 +81,18 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Ge
 
 void ObjectBufferPool::ReleaseGetChunk(const ObjectID &object_id, uint64_t chunk_index) {
   std::lock_guard<std::mutex> lock(pool_mutex_);
+  if (get_buffer_state_.count(object_id) == 0) {
+    // The chunk was read from the create buffer, since a get buffer is only
+    // set up once the create buffer is released.
+    CreateBufferState &buffer_state = create_buffer_state_[object_id];
+    RAY_CHECK(buffer_state.references > 0);
+    buffer_state.references--;
+    if (buffer_state.references == 0 && buffer_state.num_seals_remaining == 0) {
+      ARROW_CHECK_OK(store_client_.Release(object_id.to_plasma_id()));
+      create_buffer_state_.erase(object_id);
+    }
+    return;
+  }
   GetBufferState &buffer_state = get_buffer_state_[object_id];
   buffer_state.references--;
   RAY_LOG(DEBUG) << "ReleaseBuffer " << object_id << " " << buffer_state.references;
@@ -108,7 +134,8 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Cr
     uint64_t num_chunks = GetNumChunks(data_size);
     create_buffer_state_.emplace(
         std::piecewise_construct, std::forward_as_tuple(object_id),
-        std::forward_as_tuple(BuildChunks(object_id, mutable_data, data_size)));
+        std::forward_as_tuple(BuildChunks(object_id, mutable_data, data_size), data_size,
+                              metadata_size));
     RAY_CHECK(create_buffer_state_[object_id].chunk_info.size() == num_chunks);
   }
   if (create_buffer_state_[object_id].chunk_state[chunk_index] !=
@@ -123,7 +150,7 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Cr
       create_buffer_state_[object_id].chunk_info[chunk_index], ray::Status::OK());
 }
 
-void ObjectBufferPool::AbortCreateChunk(const ObjectID &object_id,
+bool ObjectBufferPool::AbortCreateChunk(const ObjectID &object_id,
                                         const uint64_t chunk_index) {
   std::lock_guard<std::mutex> lock(pool_mutex_);
   RAY_CHECK(create_buffer_state_[object_id].chunk_state[chunk_index] ==
@@ -140,8 +167,10 @@ void ObjectBufferPool::AbortCreateChunk(const ObjectID &object_id,
     }
     if (abort) {
       AbortCreate(object_id);
+      return true;
     }
   }
+  return false;
 }
 
 void ObjectBufferPool::SealChunk(const ObjectID &object_id, const uint64_t chunk_index) {
@@ -155,15 +184,53 @@ void ObjectBufferPool::SealChunk(const ObjectID &object_id, const uint64_t chunk
   if (create_buffer_state_[object_id].num_seals_remaining == 0) {
     const plasma::ObjectID plasma_id = object_id.to_plasma_id();
     ARROW_CHECK_OK(store_client_.Seal(plasma_id));
-    ARROW_CHECK_OK(store_client_.Release(plasma_id));
-    create_buffer_state_.erase(object_id);
+    // If chunks are still being relayed from the buffer, it is released once
+    // they are released.
+    if (create_buffer_state_[object_id].references == 0) {
+      ARROW_CHECK_OK(store_client_.Release(plasma_id));
+      create_buffer_state_.erase(object_id);
+    }
+  }
+}
+
+bool ObjectBufferPool::GetMissingChunks(const ObjectID &object_id, uint64_t *num_chunks,
+                                        std::vector<uint64_t> *missing_chunks) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it == create_buffer_state_.end() || it->second.num_seals_remaining == 0) {
+    return false;
+  }
+  const auto &chunk_state = it->second.chunk_state;
+  *num_chunks = chunk_state.size();
+  missing_chunks->clear();
+  for (uint64_t chunk_index = 0; chunk_index < chunk_state.size(); chunk_index++) {
+    if (chunk_state[chunk_index] != CreateChunkState::SEALED) {
+      missing_chunks->push_back(chunk_index);
+    }
   }
+  return true;
+}
+
+bool ObjectBufferPool::GetCreateSizes(const ObjectID &object_id, uint64_t *data_size,
+                                      uint64_t *metadata_size) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it == create_buffer_state_.end() || it->second.num_seals_remaining == 0) {
+    return false;
+  }
+  *data_size = it->second.data_size;
+  *metadata_size = it->second.metadata_size;
+  return true;
 }
 
 void ObjectBufferPool::AbortCreate(const ObjectID &object_id) {
   const plasma::ObjectID plasma_id = object_id.to_plasma_id();
   ARROW_CHECK_OK(store_client_.Release(plasma_id));
-  ARROW_CHECK_OK(store_client_.Abort(plasma_id));
+  if (create_buffer_state_[object_id].num_seals_remaining > 0) {
+    // Only abort the object if it was not sealed while its chunks were being
+    // relayed.
+    ARROW_CHECK_OK(store_client_.Abort(plasma_id));
+  }
   create_buffer_state_.erase(object_id);
 }
 
@@ -65,14 +65,17 @@ class ObjectBufferPool {
 
   /// Returns a chunk of an object at the given chunk_index. The object chunk serves
   /// as the data that is to be written to a connection as part of sending an object to
-  /// a remote node.
+  /// a remote node. If the object is still being created, the chunk is read from
+  /// the create buffer, as long as the chunk has been sealed, and the object stays
+  /// in the create buffer until the chunk is released.
   ///
   /// \param object_id The ObjectID.
   /// \param data_size The sum of the object size and metadata size.
   /// \param metadata_size The size of the metadata.
   /// \param chunk_index The index of the chunk.
   /// \return A pair consisting of a ChunkInfo and status of invoking this method.
-  /// An IOError status is returned if the Get call on the plasma store fails.
+  /// An IOError status is returned if the Get call on the plasma store fails, or
+  /// if the object is being created and the chunk has not been sealed yet.
   std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> GetChunk(
       const ObjectID &object_id, uint64_t data_size, uint64_t metadata_size,
       uint64_t chunk_index);
@@ -111,7 +114,9 @@ class ObjectBufferPool {
   ///
   /// \param object_id The ObjectID.
   /// \param chunk_index The index of the chunk.
-  void AbortCreateChunk(const ObjectID &object_id, uint64_t chunk_index);
+  /// \return Whether the create operation of the object was aborted too,
+  /// since none of its chunks were sealed or are being written to.
+  bool AbortCreateChunk(const ObjectID &object_id, uint64_t chunk_index);
 
   /// Seal the object associated with a create operation. This is invoked whenever
   /// a chunk is successfully written to.
@@ -123,6 +128,28 @@ class ObjectBufferPool {
   /// \param chunk_index The index of the chunk.
   void SealChunk(const ObjectID &object_id, uint64_t chunk_index);
 
+  /// Get the chunks of an object that is being created that have not been
+  /// sealed yet, including the chunks that are being written to.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param[out] num_chunks The number of chunks in the object.
+  /// \param[out] missing_chunks The indices of the chunks that have not been
+  /// sealed, in increasing order.
+  /// \return Whether a create operation is in progress for the object. If not,
+  /// either no chunk of the object has been created, or all of its chunks were
+  /// sealed, or every create operation was aborted.
+  bool GetMissingChunks(const ObjectID &object_id, uint64_t *num_chunks,
+                        std::vector<uint64_t> *missing_chunks);
+
+  /// Get the sizes of an object that is being created.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param[out] data_size The sum of the object size and metadata size.
+  /// \param[out] metadata_size The size of the metadata.
+  /// \return Whether a create operation is in progress for the object.
+  bool GetCreateSizes(const ObjectID &object_id, uint64_t *data_size,
+                      uint64_t *metadata_size);
+
   /// Free a list of objects from object store.
   ///
   /// \param object_ids the The list of ObjectIDs to be deleted.
@@ -161,10 +188,13 @@ class ObjectBufferPool {
   /// Holds the state of a create buffer.
   struct CreateBufferState {
     CreateBufferState() {}
-    CreateBufferState(std::vector<ChunkInfo> chunk_info)
+    CreateBufferState(std::vector<ChunkInfo> chunk_info, uint64_t data_size,
+                      uint64_t metadata_size)
         : chunk_info(chunk_info),
           chunk_state(chunk_info.size(), CreateChunkState::AVAILABLE),
-          num_seals_remaining(chunk_info.size()) {}
+          num_seals_remaining(chunk_info.size()),
+          data_size(data_size),
+          metadata_size(metadata_size) {}
     /// A vector maintaining information about the chunks which comprise
     /// an object.
     std::vector<ChunkInfo> chunk_info;
@@ -173,6 +203,13 @@ class ObjectBufferPool {
     std::vector<CreateChunkState> chunk_state;
     /// The number of chunks left to seal before the buffer is sealed.
     uint64_t num_seals_remaining;
+    /// The sum of the object size and metadata size.
+    uint64_t data_size;
+    /// The size of the metadata.
+    uint64_t metadata_size;
+    /// The number of sealed chunks that are being read by GetChunk. Once the
+    /// buffer is sealed, it is released when this reaches 0.
+    uint64_t references = 0;
   };
 
   /// Returned when GetChunk or CreateChunk fails.
@@ -1,5 +1,7 @@
 #include "ray/object_manager/object_directory.h"
 
+#include "common/state/ray_config.h"
+
 namespace ray {
 
 ObjectDirectory::ObjectDirectory(std::shared_ptr<gcs::AsyncGcsClient> &gcs_client)
@@ -9,6 +11,7 @@ namespace {
 
 std::vector<ClientID> UpdateObjectLocations(
     std::unordered_set<ClientID> &client_ids,
+    std::unordered_set<ClientID> &partial_client_ids,
     const std::vector<ObjectTableDataT> &location_history,
     const ray::gcs::ClientTable &client_table) {
   // location_history contains the history of locations of the object (it is a log),
@@ -17,21 +20,31 @@ std::vector<ClientID> UpdateObjectLocations(
   //   client1.is_eviction = true
   //   client2.is_eviction = false
   // In such a scenario, we want to indicate client2 is the only client that contains
-  // the object, which the following code achieves.
+  // the object, which the following code achieves. A client that is still
+  // receiving the object is a partial location until it adds or evicts the
+  // object.
   for (const auto &object_table_data : location_history) {
     ClientID client_id = ClientID::from_binary(object_table_data.manager);
-    if (!object_table_data.is_eviction) {
-      client_ids.insert(client_id);
-    } else {
+    if (object_table_data.is_eviction) {
       client_ids.erase(client_id);
+      partial_client_ids.erase(client_id);
+    } else if (object_table_data.is_partial) {
+      if (client_ids.count(client_id) == 0) {
+        partial_client_ids.insert(client_id);
+      }
+    } else {
+      client_ids.insert(client_id);
+      partial_client_ids.erase(client_id);
     }
   }
   // Filter out the removed clients from the object locations.
-  for (auto it = client_ids.begin(); it != client_ids.end();) {
-    if (client_table.IsRemoved(*it)) {
-      it = client_ids.erase(it);
-    } else {
-      it++;
+  for (auto *locations : {&client_ids, &partial_client_ids}) {
+    for (auto it = locations->begin(); it != locations->end();) {
+      if (client_table.IsRemoved(*it)) {
+        it = locations->erase(it);
+      } else {
+        it++;
+      }
     }
   }
   return std::vector<ClientID>(client_ids.begin(), client_ids.end());
@@ -52,7 +65,14 @@ void ObjectDirectory::RegisterBackend() {
     // Update entries for this object.
     std::vector<ClientID> client_id_vec =
         UpdateObjectLocations(object_id_listener_pair->second.current_object_locations,
+                              object_id_listener_pair->second.partial_object_locations,
                               location_history, gcs_client_->client_table());
+    // Record the object's size, which is included in every addition entry.
+    for (const auto &object_table_data : location_history) {
+      if (!object_table_data.is_eviction && !object_table_data.is_partial) {
+        object_id_listener_pair->second.object_size = object_table_data.object_size;
+      }
+    }
     // Copy the callbacks so that the callbacks can unsubscribe without interrupting
     // looping over the callbacks.
     auto callbacks = object_id_listener_pair->second.callbacks;
@@ -84,6 +104,21 @@ ray::Status ObjectDirectory::ReportObjectAdded(const ObjectID &object_id,
   return status;
 }
 
+ray::Status ObjectDirectory::ReportPartialObjectAdded(const ObjectID &object_id,
+                                                      const ClientID &client_id) {
+  // Append the partial addition entry to the object table. It is superseded by
+  // the addition or eviction entry that this node appends later.
+  JobID job_id = JobID::nil();
+  auto data = std::make_shared<ObjectTableDataT>();
+  data->manager = client_id.binary();
+  data->is_eviction = false;
+  data->is_partial = true;
+  data->num_evictions = object_evictions_[object_id];
+  ray::Status status =
+      gcs_client_->object_table().Append(job_id, object_id, data, nullptr);
+  return status;
+}
+
 ray::Status ObjectDirectory::ReportObjectRemoved(const ObjectID &object_id,
                                                  const ClientID &client_id) {
   // Append the eviction entry to the object table.
@@ -159,6 +194,40 @@ ray::Status ObjectDirectory::SubscribeObjectLocations(const UniqueID &callback_i
   return status;
 }
 
+ray::Status ObjectDirectory::SubscribeObjectLocations(
+    const UniqueID &callback_id, const std::vector<ObjectID> &object_ids,
+    const OnLocationsFound &callback) {
+  ray::Status status = ray::Status::OK();
+  std::vector<ObjectID> subscribed_object_ids;
+  for (const auto &object_id : object_ids) {
+    if (listeners_.find(object_id) == listeners_.end()) {
+      listeners_.emplace(object_id, LocationListenerState());
+      ray::Status request_status = gcs_client_->object_table().RequestNotifications(
+          JobID::nil(), object_id, gcs_client_->client_table().GetLocalClientId());
+      if (!request_status.ok()) {
+        status = request_status;
+      }
+    }
+    auto &listener_state = listeners_.find(object_id)->second;
+    if (listener_state.callbacks.emplace(callback_id, callback).second) {
+      subscribed_object_ids.push_back(object_id);
+    }
+  }
+  // Immediately notify of the locations of the newly subscribed objects, once
+  // all of them are subscribed.
+  for (const auto &object_id : subscribed_object_ids) {
+    auto entry = listeners_.find(object_id);
+    // The callback may have unsubscribed from objects later in the batch.
+    if (entry == listeners_.end() || entry->second.callbacks.count(callback_id) == 0) {
+      continue;
+    }
+    std::vector<ClientID> client_id_vec(entry->second.current_object_locations.begin(),
+                                        entry->second.current_object_locations.end());
+    callback(client_id_vec, object_id);
+  }
+  return status;
+}
+
 ray::Status ObjectDirectory::UnsubscribeObjectLocations(const UniqueID &callback_id,
                                                         const ObjectID &object_id) {
   ray::Status status = ray::Status::OK();
@@ -175,6 +244,64 @@ ray::Status ObjectDirectory::UnsubscribeObjectLocations(const UniqueID &callback
   return status;
 }
 
+bool ObjectDirectory::GetCachedLocations(const ObjectID &object_id,
+                                         std::vector<ClientID> *client_ids,
+                                         int64_t *object_size) const {
+  auto entry = listeners_.find(object_id);
+  if (entry != listeners_.end() && entry->second.object_size >= 0) {
+    client_ids->assign(entry->second.current_object_locations.begin(),
+                       entry->second.current_object_locations.end());
+    *object_size = entry->second.object_size;
+    return true;
+  }
+  // Fall back to the last lookup of the object.
+  auto cached = lookup_cache_.find(object_id);
+  if (cached == lookup_cache_.end()) {
+    return false;
+  }
+  *client_ids = cached->second.client_ids;
+  *object_size = cached->second.object_size;
+  return true;
+}
+
+void ObjectDirectory::CacheLookup(const ObjectID &object_id,
+                                  const std::vector<ClientID> &client_ids,
+                                  const std::vector<ObjectTableDataT> &location_history) {
+  // The object's size is included in every addition entry.
+  int64_t object_size = -1;
+  for (const auto &object_table_data : location_history) {
+    if (!object_table_data.is_eviction && !object_table_data.is_partial) {
+      object_size = object_table_data.object_size;
+    }
+  }
+  if (object_size < 0) {
+    return;
+  }
+  auto inserted = lookup_cache_.emplace(object_id, CachedLocations());
+  inserted.first->second.client_ids = client_ids;
+  inserted.first->second.object_size = object_size;
+  if (!inserted.second) {
+    return;
+  }
+  lookup_cache_order_.push_back(object_id);
+  const size_t max_size =
+      static_cast<size_t>(RayConfig::instance().object_location_cache_size());
+  while (lookup_cache_order_.size() > max_size) {
+    lookup_cache_.erase(lookup_cache_order_.front());
+    lookup_cache_order_.pop_front();
+  }
+}
+
+void ObjectDirectory::GetCachedPartialLocations(
+    const ObjectID &object_id, std::vector<ClientID> *client_ids) const {
+  client_ids->clear();
+  auto entry = listeners_.find(object_id);
+  if (entry != listeners_.end()) {
+    client_ids->assign(entry->second.partial_object_locations.begin(),
+                       entry->second.partial_object_locations.end());
+  }
+}
+
 ray::Status ObjectDirectory::LookupLocations(const ObjectID &object_id,
                                              const OnLocationsFound &callback) {
   JobID job_id = JobID::nil();
@@ -184,8 +311,11 @@ ray::Status ObjectDirectory::LookupLocations(const ObjectID &object_id,
                        const std::vector<ObjectTableDataT> &location_history) {
         // Build the set of current locations based on the entries in the log.
         std::unordered_set<ClientID> client_ids;
-        std::vector<ClientID> locations_vector = UpdateObjectLocations(
-            client_ids, location_history, gcs_client_->client_table());
+        std::unordered_set<ClientID> partial_client_ids;
+        std::vector<ClientID> locations_vector =
+            UpdateObjectLocations(client_ids, partial_client_ids, location_history,
+                                  gcs_client_->client_table());
+        CacheLookup(object_id, locations_vector, location_history);
         callback(locations_vector, object_id);
       });
   return status;
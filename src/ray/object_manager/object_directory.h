@@ -1,6 +1,7 @@
 #ifndef RAY_OBJECT_MANAGER_OBJECT_DIRECTORY_H
 #define RAY_OBJECT_MANAGER_OBJECT_DIRECTORY_H
 
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -50,6 +51,9 @@ class ObjectDirectoryInterface {
                                               const ray::ObjectID &object_id)>;
 
   /// Lookup object locations. Callback may be invoked with empty list of client ids.
+  /// The locations and size that are found are cached, so that
+  /// GetCachedLocations returns them even if the object's locations are not
+  /// subscribed to.
   ///
   /// \param object_id The object's ObjectID.
   /// \param callback Invoked with (possibly empty) list of client ids and object_id.
@@ -74,6 +78,21 @@ class ObjectDirectoryInterface {
                                                const ObjectID &object_id,
                                                const OnLocationsFound &callback) = 0;
 
+  /// Subscribe to be notified of the locations of several objects at once.
+  /// This behaves like a call to SubscribeObjectLocations for each object,
+  /// except that all of the subscriptions are recorded before the callback
+  /// fires for any of the objects.
+  ///
+  /// \param callback_id The id associated with the specified callback. This is
+  /// needed when UnsubscribeObjectLocations is called.
+  /// \param object_ids The required objects' ObjectIDs.
+  /// \param callback Invoked with the list of client ids and object_id of each
+  /// object.
+  /// \return Status of whether the subscriptions succeeded.
+  virtual ray::Status SubscribeObjectLocations(const UniqueID &callback_id,
+                                               const std::vector<ObjectID> &object_ids,
+                                               const OnLocationsFound &callback) = 0;
+
   /// Unsubscribe to object location notifications.
   ///
   /// \param callback_id The id associated with a callback. This was given
@@ -84,6 +103,32 @@ class ObjectDirectoryInterface {
   virtual ray::Status UnsubscribeObjectLocations(const UniqueID &callback_id,
                                                  const ObjectID &object_id) = 0;
 
+  /// Get the locations and size of an object from the location information
+  /// that is cached locally, without contacting the GCS. Location information
+  /// is cached for objects whose locations are currently subscribed to, and
+  /// for the objects that were looked up recently. The locations from a
+  /// lookup may be stale.
+  ///
+  /// \param object_id The object's ObjectID.
+  /// \param[out] client_ids The known locations of the object.
+  /// \param[out] object_size The size of the object in bytes.
+  /// \return True if the object's locations and size are known. False
+  /// otherwise.
+  virtual bool GetCachedLocations(const ObjectID &object_id,
+                                  std::vector<ClientID> *client_ids,
+                                  int64_t *object_size) const = 0;
+
+  /// Get the nodes that are still receiving an object, from the location
+  /// information that is cached locally. These nodes are not included in the
+  /// object's locations, but they can serve the chunks that they already
+  /// received.
+  ///
+  /// \param object_id The object's ObjectID.
+  /// \param[out] client_ids The nodes that have part of the object.
+  /// \return Void.
+  virtual void GetCachedPartialLocations(const ObjectID &object_id,
+                                         std::vector<ClientID> *client_ids) const = 0;
+
   /// Report objects added to this node's store to the object directory.
   ///
   /// \param object_id The object id that was put into the store.
@@ -94,6 +139,16 @@ class ObjectDirectoryInterface {
                                         const ClientID &client_id,
                                         const ObjectInfoT &object_info) = 0;
 
+  /// Report that this node started receiving an object. The node is
+  /// advertised as a partial holder of the object until it reports the object
+  /// as added or removed.
+  ///
+  /// \param object_id The object id that is being received.
+  /// \param client_id The client id corresponding to this node.
+  /// \return Status of whether this method succeeded.
+  virtual ray::Status ReportPartialObjectAdded(const ObjectID &object_id,
+                                               const ClientID &client_id) = 0;
+
   /// Report objects removed from this client's store to the object directory.
   ///
   /// \param object_id The object id that was removed from the store.
@@ -130,11 +185,21 @@ class ObjectDirectory : public ObjectDirectoryInterface {
   ray::Status SubscribeObjectLocations(const UniqueID &callback_id,
                                        const ObjectID &object_id,
                                        const OnLocationsFound &callback) override;
+  ray::Status SubscribeObjectLocations(const UniqueID &callback_id,
+                                       const std::vector<ObjectID> &object_ids,
+                                       const OnLocationsFound &callback) override;
   ray::Status UnsubscribeObjectLocations(const UniqueID &callback_id,
                                          const ObjectID &object_id) override;
 
+  bool GetCachedLocations(const ObjectID &object_id, std::vector<ClientID> *client_ids,
+                          int64_t *object_size) const override;
+  void GetCachedPartialLocations(const ObjectID &object_id,
+                                 std::vector<ClientID> *client_ids) const override;
+
   ray::Status ReportObjectAdded(const ObjectID &object_id, const ClientID &client_id,
                                 const ObjectInfoT &object_info) override;
+  ray::Status ReportPartialObjectAdded(const ObjectID &object_id,
+                                       const ClientID &client_id) override;
   ray::Status ReportObjectRemoved(const ObjectID &object_id,
                                   const ClientID &client_id) override;
   /// Ray only (not part of the OD interface).
@@ -150,12 +215,37 @@ class ObjectDirectory : public ObjectDirectoryInterface {
     std::unordered_map<UniqueID, OnLocationsFound> callbacks;
     /// The current set of known locations of this object.
     std::unordered_set<ClientID> current_object_locations;
+    /// The current set of nodes that are receiving this object.
+    std::unordered_set<ClientID> partial_object_locations;
+    /// The size of the object, as reported by the last node that added it.
+    /// This is -1 if the size is not yet known.
+    int64_t object_size = -1;
+  };
+
+  /// The locations and size of an object, as of its last lookup.
+  struct CachedLocations {
+    std::vector<ClientID> client_ids;
+    int64_t object_size;
   };
 
+  /// Cache the result of a lookup, evicting the oldest lookups once the cache
+  /// is full.
+  ///
+  /// \param object_id The object that was looked up.
+  /// \param client_ids The object's locations.
+  /// \param location_history The object's entries in the object table.
+  /// \return Void.
+  void CacheLookup(const ObjectID &object_id, const std::vector<ClientID> &client_ids,
+                   const std::vector<ObjectTableDataT> &location_history);
+
   /// Reference to the gcs client.
   std::shared_ptr<gcs::AsyncGcsClient> gcs_client_;
   /// Info about subscribers to object locations.
   std::unordered_map<ObjectID, LocationListenerState> listeners_;
+  /// The results of recent lookups of objects whose size was known.
+  std::unordered_map<ObjectID, CachedLocations> lookup_cache_;
+  /// The objects in lookup_cache_, in the order that they were cached.
+  std::deque<ObjectID> lookup_cache_order_;
   /// Map from object ID to the number of times it's been evicted on this
   /// node before.
   std::unordered_map<ObjectID, int> object_evictions_;
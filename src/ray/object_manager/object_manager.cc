@@ -8,7 +8,7 @@ namespace object_manager_protocol = ray::object_manager::protocol;
 
 namespace {
 
-void CheckIOError(ray::Status &status, const std::string &operation) {
+void CheckIOError(const ray::Status &status, const std::string &operation) {
   RAY_CHECK(status.IsIOError());
   RAY_LOG(ERROR) << "Failed to contact remote object manager during " << operation;
 }
@@ -17,6 +17,12 @@ void CheckIOError(ray::Status &status, const std::string &operation) {
 
 namespace ray {
 
+std::pair<uint64_t, uint64_t> GetStripeRange(uint64_t num_chunks, uint64_t num_stripes,
+                                             uint64_t stripe_index) {
+  return std::make_pair(stripe_index * num_chunks / num_stripes,
+                        (stripe_index + 1) * num_chunks / num_stripes);
+}
+
 ObjectManager::ObjectManager(asio::io_service &main_service,
                              const ObjectManagerConfig &config,
                              std::shared_ptr<gcs::AsyncGcsClient> gcs_client)
@@ -31,7 +37,8 @@ ObjectManager::ObjectManager(asio::io_service &main_service,
                    /*release_delay=*/2 * config_.max_sends),
       send_work_(send_service_),
       receive_work_(receive_service_),
-      connection_pool_() {
+      connection_pool_(),
+      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
   RAY_CHECK(config_.max_sends > 0);
   RAY_CHECK(config_.max_receives > 0);
   main_service_ = &main_service;
@@ -54,7 +61,8 @@ ObjectManager::ObjectManager(asio::io_service &main_service,
                    /*release_delay=*/2 * config_.max_sends),
       send_work_(send_service_),
       receive_work_(receive_service_),
-      connection_pool_() {
+      connection_pool_(),
+      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
   RAY_CHECK(config_.max_sends > 0);
   RAY_CHECK(config_.max_receives > 0);
   // TODO(hme) Client ID is never set with this constructor.
@@ -100,6 +108,29 @@ void ObjectManager::HandleObjectAdded(const ObjectInfoT &object_info) {
   local_objects_[object_id] = object_info;
   ray::Status status =
       object_directory_->ReportObjectAdded(object_id, client_id_, object_info);
+  partial_objects_.erase(object_id);
+
+  // Send the rest of the chunks that were requested while the object was
+  // being received.
+  auto relay_it = relay_requests_.find(object_id);
+  if (relay_it != relay_requests_.end()) {
+    uint64_t data_size =
+        static_cast<uint64_t>(object_info.data_size + object_info.metadata_size);
+    uint64_t metadata_size = static_cast<uint64_t>(object_info.metadata_size);
+    uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size);
+    for (const auto &relay : relay_it->second) {
+      std::vector<uint64_t> chunks_to_send;
+      for (uint64_t chunk_index = 0; chunk_index < num_chunks; chunk_index++) {
+        if (relay.Wants(num_chunks, chunk_index) &&
+            relay.sent_chunks.count(chunk_index) == 0) {
+          chunks_to_send.push_back(chunk_index);
+        }
+      }
+      QueueChunkSends(object_id, relay.client_id, data_size, metadata_size,
+                      chunks_to_send);
+    }
+    relay_requests_.erase(relay_it);
+  }
 
   // Handle the unfulfilled_push_requests_ which contains the push request that is not
   // completed due to unsatisfied local objects.
@@ -123,9 +154,19 @@ void ObjectManager::HandleObjectAdded(const ObjectInfoT &object_info) {
 
 void ObjectManager::NotifyDirectoryObjectDeleted(const ObjectID &object_id) {
   local_objects_.erase(object_id);
+  partial_objects_.erase(object_id);
+  broadcast_states_.erase(object_id);
   ray::Status status = object_directory_->ReportObjectRemoved(object_id, client_id_);
 }
 
+void ObjectManager::RemovePartialObject(const ObjectID &object_id) {
+  // The eviction entry supersedes the partial addition entry in the object
+  // table. A local object was already reported as added.
+  if (partial_objects_.erase(object_id) != 0 && local_objects_.count(object_id) == 0) {
+    RAY_CHECK_OK(object_directory_->ReportObjectRemoved(object_id, client_id_));
+  }
+}
+
 ray::Status ObjectManager::SubscribeObjAdded(
     std::function<void(const ObjectInfoT &)> callback) {
   store_notification_.SubscribeObjAdded(callback);
@@ -139,55 +180,73 @@ ray::Status ObjectManager::SubscribeObjDeleted(
 }
 
 ray::Status ObjectManager::Pull(const ObjectID &object_id) {
-  // Check if object is already local.
-  if (local_objects_.count(object_id) != 0) {
-    RAY_LOG(ERROR) << object_id << " attempted to pull an object that's already local.";
-    return ray::Status::OK();
+  return PullObjects({object_id});
+}
+
+ray::Status ObjectManager::PullObjects(const std::vector<ObjectID> &object_ids) {
+  std::vector<ObjectID> new_object_ids;
+  for (const auto &object_id : object_ids) {
+    // Check if object is already local.
+    if (local_objects_.count(object_id) != 0) {
+      RAY_LOG(ERROR) << object_id << " attempted to pull an object that's already local.";
+      continue;
+    }
+    if (pull_requests_.emplace(object_id, PullRequest()).second) {
+      new_object_ids.push_back(object_id);
+    }
   }
-  if (pull_requests_.find(object_id) != pull_requests_.end()) {
+  if (new_object_ids.empty()) {
     return ray::Status::OK();
   }
 
-  pull_requests_.emplace(object_id, PullRequest());
   // Subscribe to object notifications. A notification will be received every
-  // time the set of client IDs for the object changes. Notifications will also
+  // time the set of client IDs for an object changes. Notifications will also
   // be received if the list of locations is empty. The set of client IDs has
   // no ordering guarantee between notifications.
   return object_directory_->SubscribeObjectLocations(
-      object_directory_pull_callback_id_, object_id,
+      object_directory_pull_callback_id_, new_object_ids,
       [this](const std::vector<ClientID> &client_ids, const ObjectID &object_id) {
-        // Exit if the Pull request has already been fulfilled or canceled.
-        auto it = pull_requests_.find(object_id);
-        if (it == pull_requests_.end()) {
-          return;
-        }
-        // Reset the list of clients that are now expected to have the object.
-        // NOTE(swang): Since we are overwriting the previous list of clients,
-        // we may end up sending a duplicate request to the same client as
-        // before.
-        it->second.client_locations = client_ids;
-        if (it->second.client_locations.empty()) {
-          // The object locations are now empty, so we should wait for the next
-          // notification about a new object location.  Cancel the timer until
-          // the next Pull attempt since there are no more clients to try.
-          if (it->second.retry_timer != nullptr) {
-            it->second.retry_timer->cancel();
-            it->second.timer_set = false;
-          }
-        } else {
-          // New object locations were found.
-          if (!it->second.timer_set) {
-            // The timer was not set, which means that we weren't trying any
-            // clients. We now have some clients to try, so begin trying to
-            // Pull from one.  If we fail to receive an object within the pull
-            // timeout, then this will try the rest of the clients in the list
-            // in succession.
-            TryPull(object_id);
-          }
-        }
+        HandlePullLocations(client_ids, object_id);
       });
 }
 
+void ObjectManager::HandlePullLocations(const std::vector<ClientID> &client_ids,
+                                        const ObjectID &object_id) {
+  // Exit if the Pull request has already been fulfilled or canceled.
+  auto it = pull_requests_.find(object_id);
+  if (it == pull_requests_.end()) {
+    return;
+  }
+  // Reset the list of clients that are now expected to have the object.
+  // NOTE(swang): Since we are overwriting the previous list of clients,
+  // we may end up sending a duplicate request to the same client as
+  // before.
+  it->second.client_locations = client_ids;
+  if (it->second.client_locations.empty()) {
+    // The object locations are now empty, so we should wait for the next
+    // notification about a new object location.  Cancel the timer until
+    // the next Pull attempt since there are no more clients to try.
+    if (it->second.retry_timer != nullptr) {
+      it->second.retry_timer->cancel();
+      it->second.timer_set = false;
+    }
+  } else {
+    // New object locations were found.
+    if (!it->second.timer_set) {
+      // The timer was not set, which means that we weren't trying any
+      // clients. We now have some clients to try, so begin pulling stripes
+      // of the object from several of them at once if it is large. Otherwise,
+      // begin trying to Pull from one.  If we fail to receive an object within
+      // the pull timeout, then this will try the rest of the clients in the
+      // list in succession.
+      if (!TryStripedPull(object_id)) {
+        it->second.striped_pull.reset();
+        TryPull(object_id);
+      }
+    }
+  }
+}
+
 void ObjectManager::TryPull(const ObjectID &object_id) {
   auto it = pull_requests_.find(object_id);
   if (it == pull_requests_.end()) {
@@ -210,8 +269,16 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
     RAY_CHECK(client_id != client_id_);
   }
 
-  // Try pulling from the client.
-  PullEstablishConnection(object_id, client_id);
+  // Try pulling from the client. If some of the object's chunks were already
+  // received, e.g., from a client that stalled, only request the missing ones.
+  uint64_t num_chunks;
+  std::vector<uint64_t> missing_chunks;
+  if (buffer_pool_.GetMissingChunks(object_id, &num_chunks, &missing_chunks)) {
+    SendPullChunksRequest(object_id, client_id, client_id_, /*num_stripes=*/0,
+                          /*stripe_index=*/0, missing_chunks, /*num_forwards=*/0);
+  } else {
+    QueuePullRequest(object_id, client_id);
+  }
 
   // If there are more clients to try, try them in succession, with a timeout
   // in between each try.
@@ -247,8 +314,46 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
   }
 };
 
-void ObjectManager::PullEstablishConnection(const ObjectID &object_id,
-                                            const ClientID &client_id) {
+void ObjectManager::QueuePullRequest(const ObjectID &object_id,
+                                     const ClientID &client_id) {
+  auto &object_ids = queued_pull_requests_[client_id];
+  if (object_ids.empty()) {
+    // Send the requests once the handlers that are ready to run have queued
+    // theirs, e.g., the notifications for the rest of a batch of objects.
+    main_service_->post([this, client_id]() { SendQueuedPullRequests(client_id); });
+  }
+  object_ids.push_back(object_id);
+}
+
+void ObjectManager::SendQueuedPullRequests(const ClientID &client_id) {
+  auto it = queued_pull_requests_.find(client_id);
+  if (it == queued_pull_requests_.end()) {
+    return;
+  }
+  std::vector<ObjectID> object_ids;
+  for (const auto &object_id : it->second) {
+    if (pull_requests_.count(object_id) != 0) {
+      object_ids.push_back(object_id);
+    }
+  }
+  queued_pull_requests_.erase(it);
+  if (object_ids.empty()) {
+    return;
+  }
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = object_manager_protocol::CreatePullRequestBatchMessage(
+      fbb, fbb.CreateString(client_id_.binary()), to_flatbuf(fbb, object_ids));
+  fbb.Finish(message);
+  PullEstablishConnection(
+      client_id,
+      static_cast<int64_t>(object_manager_protocol::MessageType::PullRequestBatch),
+      std::string(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+                  fbb.GetSize()));
+}
+
+void ObjectManager::PullEstablishConnection(const ClientID &client_id,
+                                            int64_t message_type,
+                                            const std::string &message) {
   // Acquire a message connection and send pull request.
   ray::Status status;
   std::shared_ptr<SenderConnection> conn;
@@ -258,7 +363,8 @@ void ObjectManager::PullEstablishConnection(const ObjectID &object_id,
   if (conn == nullptr) {
     status = object_directory_->GetInformation(
         client_id,
-        [this, object_id, client_id](const RemoteConnectionInfo &connection_info) {
+        [this, client_id, message_type,
+         message](const RemoteConnectionInfo &connection_info) {
           std::shared_ptr<SenderConnection> async_conn = CreateSenderConnection(
               ConnectionPool::ConnectionType::MESSAGE, connection_info);
           if (async_conn == nullptr) {
@@ -266,35 +372,329 @@ void ObjectManager::PullEstablishConnection(const ObjectID &object_id,
           }
           connection_pool_.RegisterSender(ConnectionPool::ConnectionType::MESSAGE,
                                           client_id, async_conn);
-          Status pull_send_status = PullSendRequest(object_id, async_conn);
-          if (!pull_send_status.ok()) {
-            CheckIOError(pull_send_status, "Pull");
-          }
+          PullSendRequest(message_type, message, async_conn);
         },
         []() {
           RAY_LOG(ERROR) << "Failed to establish connection with remote object manager.";
         });
   } else {
-    status = PullSendRequest(object_id, conn);
-    if (!status.ok()) {
-      CheckIOError(status, "Pull");
+    PullSendRequest(message_type, message, conn);
+  }
+}
+
+void ObjectManager::PullSendRequest(int64_t message_type, const std::string &message,
+                                    std::shared_ptr<SenderConnection> &conn) {
+  conn->WriteMessageAsync(
+      message_type, message.size(), reinterpret_cast<const uint8_t *>(message.data()),
+      [this, conn](const ray::Status &status) mutable {
+        if (status.ok()) {
+          connection_pool_.ReleaseSender(ConnectionPool::ConnectionType::MESSAGE, conn);
+        } else {
+          // Drop the failed connection. The next request opens a new one.
+          CheckIOError(status, "Pull");
+          RAY_CHECK_OK(connection_pool_.RemoveSender(
+              ConnectionPool::ConnectionType::MESSAGE, conn));
+          conn->Close();
+        }
+      });
+}
+
+bool ObjectManager::TryStripedPull(const ObjectID &object_id) {
+  auto it = pull_requests_.find(object_id);
+  RAY_CHECK(it != pull_requests_.end());
+  // Pull from the nodes that are still receiving the object too, since they
+  // relay the chunks as they receive them.
+  std::vector<ClientID> client_ids;
+  object_directory_->GetCachedPartialLocations(object_id, &client_ids);
+  for (const auto &client_id : it->second.client_locations) {
+    if (std::find(client_ids.begin(), client_ids.end(), client_id) == client_ids.end()) {
+      client_ids.push_back(client_id);
     }
   }
+  client_ids.erase(std::remove(client_ids.begin(), client_ids.end(), client_id_),
+                   client_ids.end());
+  uint64_t num_stripes = std::min<uint64_t>(
+      RayConfig::instance().object_manager_max_pull_stripes(), client_ids.size());
+  if (num_stripes < 2) {
+    return false;
+  }
+  // Use at most one stripe per chunk. The object size in the directory does not
+  // include the metadata, so the number of chunks may be one higher.
+  std::vector<ClientID> cached_locations;
+  int64_t object_size;
+  if (!object_directory_->GetCachedLocations(object_id, &cached_locations,
+                                             &object_size)) {
+    return false;
+  }
+  num_stripes = std::min(num_stripes, buffer_pool_.GetNumChunks(object_size));
+  if (num_stripes < 2) {
+    return false;
+  }
+  // Choose the sources at random, so that the nodes that pull the object at
+  // once spread their requests over its holders.
+  std::shuffle(client_ids.begin(), client_ids.end(), gen_);
+  client_ids.resize(num_stripes);
+
+  std::unique_ptr<StripedPull> striped_pull(new StripedPull(num_stripes));
+  std::vector<uint64_t> missing_chunks;
+  if (buffer_pool_.GetMissingChunks(object_id, &striped_pull->num_chunks,
+                                    &missing_chunks)) {
+    // Some chunks were received by an earlier attempt, e.g., before the
+    // object's locations were lost, so only request the missing ones.
+    RequestChunks(object_id, *striped_pull, missing_chunks, client_ids);
+  } else {
+    for (uint64_t stripe_index = 0; stripe_index < num_stripes; stripe_index++) {
+      const ClientID &client_id = client_ids[stripe_index];
+      striped_pull->sources[client_id] = {static_cast<int64_t>(stripe_index), {},
+                                          false};
+      SendPullChunksRequest(object_id, client_id, client_id_, num_stripes,
+                            stripe_index, {}, /*num_forwards=*/0);
+    }
+  }
+  it->second.striped_pull = std::move(striped_pull);
+  SetStripedPullTimer(object_id);
+  return true;
 }
 
-ray::Status ObjectManager::PullSendRequest(const ObjectID &object_id,
-                                           std::shared_ptr<SenderConnection> &conn) {
+void ObjectManager::SendPullChunksRequest(const ObjectID &object_id,
+                                          const ClientID &client_id,
+                                          const ClientID &requester_id,
+                                          uint64_t num_stripes, uint64_t stripe_index,
+                                          const std::vector<uint64_t> &chunk_indices,
+                                          uint64_t num_forwards) {
   flatbuffers::FlatBufferBuilder fbb;
-  auto message = object_manager_protocol::CreatePullRequestMessage(
-      fbb, fbb.CreateString(client_id_.binary()), fbb.CreateString(object_id.binary()));
+  auto message = object_manager_protocol::CreatePullChunksRequestMessage(
+      fbb, fbb.CreateString(requester_id.binary()), fbb.CreateString(object_id.binary()),
+      num_stripes, stripe_index, fbb.CreateVector(chunk_indices), num_forwards);
   fbb.Finish(message);
-  Status status = conn->WriteMessage(
-      static_cast<int64_t>(object_manager_protocol::MessageType::PullRequest),
-      fbb.GetSize(), fbb.GetBufferPointer());
-  if (status.ok()) {
-    connection_pool_.ReleaseSender(ConnectionPool::ConnectionType::MESSAGE, conn);
+  PullEstablishConnection(
+      client_id,
+      static_cast<int64_t>(object_manager_protocol::MessageType::PullChunksRequest),
+      std::string(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+                  fbb.GetSize()));
+}
+
+void ObjectManager::RequestChunks(const ObjectID &object_id, StripedPull &striped_pull,
+                                  const std::vector<uint64_t> &chunk_indices,
+                                  const std::vector<ClientID> &client_ids) {
+  RAY_CHECK(!client_ids.empty());
+  const size_t range_size = (chunk_indices.size() + client_ids.size() - 1) /
+                            client_ids.size();
+  for (size_t i = 0; i < client_ids.size(); i++) {
+    const size_t first = std::min(i * range_size, chunk_indices.size());
+    const size_t last = std::min(first + range_size, chunk_indices.size());
+    if (first == last) {
+      break;
+    }
+    std::vector<uint64_t> range(chunk_indices.begin() + first,
+                                chunk_indices.begin() + last);
+    auto source =
+        striped_pull.sources.emplace(client_ids[i], StripeSource{-1, {}, false}).first;
+    source->second.chunk_indices.insert(source->second.chunk_indices.end(),
+                                        range.begin(), range.end());
+    SendPullChunksRequest(object_id, client_ids[i], client_id_, /*num_stripes=*/0,
+                          /*stripe_index=*/0, range, /*num_forwards=*/0);
+  }
+}
+
+std::vector<uint64_t> ObjectManager::GetMissingChunks(
+    const StripedPull &striped_pull, const StripeSource &source,
+    const std::unordered_set<uint64_t> &missing_chunks) const {
+  RAY_CHECK(striped_pull.num_chunks > 0);
+  std::unordered_set<uint64_t> requested_chunks(source.chunk_indices.begin(),
+                                                source.chunk_indices.end());
+  if (source.stripe_index >= 0) {
+    auto range = GetStripeRange(striped_pull.num_chunks, striped_pull.num_stripes,
+                                source.stripe_index);
+    for (uint64_t chunk_index = range.first; chunk_index < range.second;
+         chunk_index++) {
+      requested_chunks.insert(chunk_index);
+    }
+  }
+  std::vector<uint64_t> source_missing_chunks;
+  for (const auto &chunk_index : requested_chunks) {
+    if (missing_chunks.count(chunk_index) != 0) {
+      source_missing_chunks.push_back(chunk_index);
+    }
+  }
+  std::sort(source_missing_chunks.begin(), source_missing_chunks.end());
+  return source_missing_chunks;
+}
+
+void ObjectManager::HandlePullChunkReceived(const ObjectID &object_id,
+                                            const ClientID &client_id,
+                                            uint64_t chunk_index, uint64_t data_size,
+                                            uint64_t metadata_size) {
+  const uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size);
+  auto relay_it = relay_requests_.find(object_id);
+  if (relay_it != relay_requests_.end()) {
+    for (auto &relay : relay_it->second) {
+      if (relay.Wants(num_chunks, chunk_index) &&
+          relay.sent_chunks.insert(chunk_index).second) {
+        QueueChunkSends(object_id, relay.client_id, data_size, metadata_size,
+                        {chunk_index});
+      }
+    }
+  }
+  auto it = pull_requests_.find(object_id);
+  if (it == pull_requests_.end()) {
+    // This node is not pulling the object, e.g., because the pull was
+    // canceled, so the rest of its chunks may never arrive.
+    return;
+  }
+  // Advertise this node as a partial holder of the object, so that other
+  // nodes can pull the chunks that it has received from it.
+  if (num_chunks > 1 && local_objects_.count(object_id) == 0 &&
+      partial_objects_.insert(object_id).second) {
+    RAY_CHECK_OK(object_directory_->ReportPartialObjectAdded(object_id, client_id_));
+  }
+  if (it->second.striped_pull == nullptr) {
+    return;
+  }
+  StripedPull &striped_pull = *it->second.striped_pull;
+  if (striped_pull.num_chunks == 0) {
+    striped_pull.num_chunks = num_chunks;
+  }
+  auto source = striped_pull.sources.find(client_id);
+  if (source == striped_pull.sources.end()) {
+    // The source may have forwarded the request to a node that relays the
+    // chunks, so credit the source of the chunk's stripe.
+    for (source = striped_pull.sources.begin(); source != striped_pull.sources.end();
+         source++) {
+      if (source->second.stripe_index < 0) {
+        continue;
+      }
+      auto range = GetStripeRange(striped_pull.num_chunks, striped_pull.num_stripes,
+                                  source->second.stripe_index);
+      if (chunk_index >= range.first && chunk_index < range.second) {
+        break;
+      }
+    }
+  }
+  if (source != striped_pull.sources.end()) {
+    source->second.made_progress = true;
+  }
+}
+
+void ObjectManager::HandlePullChunkFailed(const ObjectID &object_id,
+                                          const ClientID &client_id,
+                                          uint64_t chunk_index) {
+  auto it = pull_requests_.find(object_id);
+  if (it == pull_requests_.end()) {
+    return;
+  }
+  // Re-request the chunk from another location of the object if there is one,
+  // since the connection to the failed source may be broken.
+  ClientID source_id = client_id;
+  for (const auto &location : it->second.client_locations) {
+    if (location != client_id && location != client_id_) {
+      source_id = location;
+      break;
+    }
+  }
+  RAY_LOG(DEBUG) << "Re-requesting chunk " << chunk_index << " of " << object_id
+                 << " from " << source_id;
+  if (it->second.striped_pull != nullptr) {
+    RequestChunks(object_id, *it->second.striped_pull, {chunk_index}, {source_id});
+  } else {
+    SendPullChunksRequest(object_id, source_id, client_id_, /*num_stripes=*/0,
+                          /*stripe_index=*/0, {chunk_index}, /*num_forwards=*/0);
+  }
+}
+
+void ObjectManager::CheckStripedPull(const ObjectID &object_id) {
+  auto it = pull_requests_.find(object_id);
+  if (it == pull_requests_.end()) {
+    return;
+  }
+  RAY_CHECK(it->second.striped_pull != nullptr);
+  StripedPull &striped_pull = *it->second.striped_pull;
+  std::vector<uint64_t> missing_chunk_indices;
+  if (!buffer_pool_.GetMissingChunks(object_id, &striped_pull.num_chunks,
+                                     &missing_chunk_indices)) {
+    if (striped_pull.num_chunks > 0) {
+      // Every chunk was received, so the object is about to be added to the
+      // local store, which completes the pull.
+      return;
+    }
+    // No source sent a chunk within the timeout, so the chunks cannot be
+    // re-routed yet. Fall back to pulling the whole object from one location
+    // at a time.
+    it->second.striped_pull.reset();
+    if (!it->second.client_locations.empty()) {
+      TryPull(object_id);
+    } else {
+      it->second.timer_set = false;
+    }
+    return;
+  }
+
+  // Find the sources that still owe chunks but did not send any since the
+  // last check.
+  const std::unordered_set<uint64_t> missing_chunks(missing_chunk_indices.begin(),
+                                                    missing_chunk_indices.end());
+  std::vector<uint64_t> rerouted_chunks;
+  std::vector<ClientID> stalled_client_ids;
+  std::vector<ClientID> client_ids;
+  for (auto &source : striped_pull.sources) {
+    std::vector<uint64_t> source_missing_chunks =
+        GetMissingChunks(striped_pull, source.second, missing_chunks);
+    if (!source_missing_chunks.empty() && !source.second.made_progress) {
+      stalled_client_ids.push_back(source.first);
+      rerouted_chunks.insert(rerouted_chunks.end(), source_missing_chunks.begin(),
+                             source_missing_chunks.end());
+    } else {
+      client_ids.push_back(source.first);
+    }
+    source.second.made_progress = false;
+  }
+
+  if (!rerouted_chunks.empty()) {
+    for (const auto &client_id : stalled_client_ids) {
+      striped_pull.sources.erase(client_id);
+    }
+    if (client_ids.empty()) {
+      // Every source stalled, so try the other locations of the object, or
+      // the same sources again if there are none.
+      for (const auto &client_id : it->second.client_locations) {
+        if (client_id != client_id_ &&
+            std::find(stalled_client_ids.begin(), stalled_client_ids.end(),
+                      client_id) == stalled_client_ids.end()) {
+          client_ids.push_back(client_id);
+        }
+      }
+      if (client_ids.empty()) {
+        client_ids = stalled_client_ids;
+      }
+    }
+    std::sort(rerouted_chunks.begin(), rerouted_chunks.end());
+    RAY_LOG(DEBUG) << "Re-routing " << rerouted_chunks.size() << " chunks of "
+                   << object_id << " from " << stalled_client_ids.size()
+                   << " stalled sources";
+    RequestChunks(object_id, striped_pull, rerouted_chunks, client_ids);
   }
-  return status;
+  SetStripedPullTimer(object_id);
+}
+
+void ObjectManager::SetStripedPullTimer(const ObjectID &object_id) {
+  auto it = pull_requests_.find(object_id);
+  RAY_CHECK(it != pull_requests_.end());
+  if (it->second.retry_timer == nullptr) {
+    it->second.retry_timer = std::unique_ptr<boost::asio::deadline_timer>(
+        new boost::asio::deadline_timer(*main_service_));
+  }
+  boost::posix_time::milliseconds stall_timeout(config_.pull_timeout_ms);
+  it->second.retry_timer->expires_from_now(stall_timeout);
+  it->second.retry_timer->async_wait(
+      [this, object_id](const boost::system::error_code &error) {
+        if (!error) {
+          CheckStripedPull(object_id);
+        } else {
+          // Check that the error was due to the timer being canceled.
+          RAY_CHECK(error == boost::asio::error::operation_aborted);
+        }
+      });
+  it->second.timer_set = true;
 }
 
 void ObjectManager::HandlePushTaskTimeout(const ObjectID &object_id,
@@ -343,23 +743,66 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
     return;
   }
 
+  PushChunks(object_id, client_id, /*num_stripes=*/1, /*stripe_index=*/0, {});
+}
+
+void ObjectManager::PushChunks(const ObjectID &object_id, const ClientID &client_id,
+                               uint64_t num_stripes, uint64_t stripe_index,
+                               const std::vector<uint64_t> &chunk_indices) {
+  const ObjectInfoT &object_info = local_objects_[object_id];
+  uint64_t data_size =
+      static_cast<uint64_t>(object_info.data_size + object_info.metadata_size);
+  uint64_t metadata_size = static_cast<uint64_t>(object_info.metadata_size);
+  uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size);
+  std::pair<uint64_t, uint64_t> stripe(0, 0);
+  if (num_stripes > 0) {
+    stripe = GetStripeRange(num_chunks, num_stripes, stripe_index);
+  }
+  std::vector<uint64_t> chunks_to_send;
+  for (uint64_t chunk_index = stripe.first; chunk_index < stripe.second; chunk_index++) {
+    chunks_to_send.push_back(chunk_index);
+  }
+  for (const auto &chunk_index : chunk_indices) {
+    if (chunk_index < num_chunks &&
+        (chunk_index < stripe.first || chunk_index >= stripe.second)) {
+      chunks_to_send.push_back(chunk_index);
+    }
+  }
+  QueueChunkSends(object_id, client_id, data_size, metadata_size, chunks_to_send);
+}
+
+void ObjectManager::QueueChunkSends(const ObjectID &object_id, const ClientID &client_id,
+                                    uint64_t data_size, uint64_t metadata_size,
+                                    const std::vector<uint64_t> &chunk_indices) {
+  if (chunk_indices.empty()) {
+    return;
+  }
   // TODO(hme): Cache this data in ObjectDirectory.
   // Okay for now since the GCS client caches this data.
   RAY_CHECK_OK(object_directory_->GetInformation(
       client_id,
-      [this, object_id, client_id](const RemoteConnectionInfo &info) {
-        const ObjectInfoT &object_info = local_objects_[object_id];
-        uint64_t data_size =
-            static_cast<uint64_t>(object_info.data_size + object_info.metadata_size);
-        uint64_t metadata_size = static_cast<uint64_t>(object_info.metadata_size);
-        uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size);
-        for (uint64_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
-          send_service_.post([this, client_id, object_id, data_size, metadata_size,
-                              chunk_index, info]() {
-            ExecuteSendObject(client_id, object_id, data_size, metadata_size, chunk_index,
-                              info);
-          });
+      [this, object_id, client_id, data_size, metadata_size,
+       chunk_indices](const RemoteConnectionInfo &info) {
+        auto &peer_entry = peer_send_states_[client_id];
+        if (peer_entry == nullptr) {
+          peer_entry = std::make_shared<PeerSendState>(send_service_);
         }
+        std::shared_ptr<PeerSendState> peer = peer_entry;
+        // Queue all of the chunks on the peer's strand at once. The send
+        // threads then keep as many of them in flight as there are transfer
+        // connections to the peer.
+        peer->strand.post([this, peer, info, object_id, data_size, metadata_size,
+                           chunk_indices]() {
+          if (peer->removed) {
+            return;
+          }
+          peer->connection_info = info;
+          for (const auto &chunk_index : chunk_indices) {
+            peer->queued_chunks.push_back(
+                {object_id, data_size, metadata_size, chunk_index});
+          }
+          DispatchChunkSends(peer);
+        });
       },
       []() {
         // Push is best effort, so do nothing here.
@@ -368,77 +811,238 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
       }));
 }
 
-void ObjectManager::ExecuteSendObject(const ClientID &client_id,
-                                      const ObjectID &object_id, uint64_t data_size,
-                                      uint64_t metadata_size, uint64_t chunk_index,
-                                      const RemoteConnectionInfo &connection_info) {
-  RAY_LOG(DEBUG) << "ExecuteSendObject " << client_id << " " << object_id << " "
-                 << chunk_index;
-  ray::Status status;
-  std::shared_ptr<SenderConnection> conn;
-  connection_pool_.GetSender(ConnectionPool::ConnectionType::TRANSFER, client_id, &conn);
-  if (conn == nullptr) {
-    conn =
-        CreateSenderConnection(ConnectionPool::ConnectionType::TRANSFER, connection_info);
-    connection_pool_.RegisterSender(ConnectionPool::ConnectionType::TRANSFER, client_id,
-                                    conn);
-    if (conn == nullptr) {
-      return;
+bool ObjectManager::RelayRequest::Wants(uint64_t num_chunks, uint64_t chunk_index) const {
+  if (num_stripes > 0) {
+    auto stripe = GetStripeRange(num_chunks, num_stripes, stripe_index);
+    if (chunk_index >= stripe.first && chunk_index < stripe.second) {
+      return true;
     }
   }
-  status = SendObjectHeaders(object_id, data_size, metadata_size, chunk_index, conn);
-  if (!status.ok()) {
-    CheckIOError(status, "Push");
+  return chunk_indices.count(chunk_index) != 0;
+}
+
+bool ObjectManager::RedirectPull(const ObjectID &object_id, const ClientID &requester_id,
+                                 uint64_t num_stripes, uint64_t stripe_index,
+                                 const std::vector<uint64_t> &chunk_indices,
+                                 uint64_t num_forwards) {
+  const int64_t fanout = config_.broadcast_fanout;
+  if (fanout <= 0) {
+    return false;
+  }
+  if (static_cast<int64_t>(num_forwards) >=
+      RayConfig::instance().object_manager_max_pull_forwards()) {
+    // The distribution trees that the request went through may be stale and
+    // lead back here, so serve it.
+    return false;
+  }
+  BroadcastState &state = broadcast_states_[object_id];
+  const int64_t now_ms = current_time_ms();
+  if (now_ms - state.last_served_ms > config_.pull_timeout_ms) {
+    // The nodes that were served before may have evicted the object since,
+    // so start a new distribution tree.
+    state.children.clear();
+    state.next_child = 0;
+  }
+  const bool is_child = std::find(state.children.begin(), state.children.end(),
+                                  requester_id) != state.children.end();
+  if (is_child || static_cast<int64_t>(state.children.size()) < fanout) {
+    if (!is_child) {
+      state.children.push_back(requester_id);
+    }
+    state.last_served_ms = now_ms;
+    return false;
+  }
+  // Forward the request to the children in turn. Each child serves up to
+  // fanout nodes itself and forwards the rest further down.
+  const ClientID child_id = state.children[state.next_child];
+  state.next_child = (state.next_child + 1) % state.children.size();
+  RAY_LOG(DEBUG) << "Forwarding the pull of " << object_id << " by " << requester_id
+                 << " to " << child_id;
+  SendPullChunksRequest(object_id, child_id, requester_id, num_stripes, stripe_index,
+                        chunk_indices, num_forwards + 1);
+  return true;
+}
+
+void ObjectManager::RelayChunks(const ObjectID &object_id, const ClientID &client_id,
+                                uint64_t num_stripes, uint64_t stripe_index,
+                                const std::vector<uint64_t> &chunk_indices) {
+  RelayRequest relay;
+  relay.client_id = client_id;
+  relay.num_stripes = num_stripes;
+  relay.stripe_index = stripe_index;
+  relay.chunk_indices.insert(chunk_indices.begin(), chunk_indices.end());
+  // Send the requested chunks that were received already.
+  uint64_t num_chunks;
+  std::vector<uint64_t> missing_chunks;
+  uint64_t data_size;
+  uint64_t metadata_size;
+  if (buffer_pool_.GetMissingChunks(object_id, &num_chunks, &missing_chunks) &&
+      buffer_pool_.GetCreateSizes(object_id, &data_size, &metadata_size)) {
+    std::vector<uint64_t> chunks_to_send;
+    size_t next_missing = 0;
+    for (uint64_t chunk_index = 0; chunk_index < num_chunks; chunk_index++) {
+      if (next_missing < missing_chunks.size() &&
+          missing_chunks[next_missing] == chunk_index) {
+        next_missing++;
+      } else if (relay.Wants(num_chunks, chunk_index)) {
+        chunks_to_send.push_back(chunk_index);
+        relay.sent_chunks.insert(chunk_index);
+      }
+    }
+    QueueChunkSends(object_id, client_id, data_size, metadata_size, chunks_to_send);
   }
+  relay_requests_[object_id].push_back(std::move(relay));
 }
 
-ray::Status ObjectManager::SendObjectHeaders(const ObjectID &object_id,
-                                             uint64_t data_size, uint64_t metadata_size,
-                                             uint64_t chunk_index,
-                                             std::shared_ptr<SenderConnection> &conn) {
+void ObjectManager::DispatchChunkSends(const std::shared_ptr<PeerSendState> &peer) {
+  const int64_t max_connections =
+      RayConfig::instance().object_manager_max_connections_per_peer();
+  while (!peer->queued_chunks.empty()) {
+    std::shared_ptr<SenderConnection> conn;
+    if (!peer->idle_connections.empty()) {
+      conn = peer->idle_connections.back();
+      peer->idle_connections.pop_back();
+    } else if (peer->num_connections < max_connections) {
+      conn = CreateSenderConnection(ConnectionPool::ConnectionType::TRANSFER,
+                                    peer->connection_info);
+      if (conn == nullptr) {
+        // Push is best effort, so drop the chunks for this peer.
+        peer->queued_chunks.clear();
+        return;
+      }
+      peer->num_connections++;
+    } else {
+      // Every connection has a chunk in flight. The next chunk is sent when
+      // one of them completes.
+      return;
+    }
+    ChunkSend chunk = peer->queued_chunks.front();
+    peer->queued_chunks.pop_front();
+    SendChunk(peer, std::move(conn), chunk);
+  }
+}
+
+void ObjectManager::SendChunk(const std::shared_ptr<PeerSendState> &peer,
+                              std::shared_ptr<SenderConnection> conn,
+                              const ChunkSend &chunk) {
+  RAY_LOG(DEBUG) << "SendChunk " << peer->connection_info.client_id << " "
+                 << chunk.object_id << " " << chunk.chunk_index;
   std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> chunk_status =
-      buffer_pool_.GetChunk(object_id, data_size, metadata_size, chunk_index);
+      buffer_pool_.GetChunk(chunk.object_id, chunk.data_size, chunk.metadata_size,
+                            chunk.chunk_index);
   ObjectBufferPool::ChunkInfo chunk_info = chunk_status.first;
 
   // Fail on status not okay. The object is local, and there is
   // no other anticipated error here.
   RAY_CHECK_OK(chunk_status.second);
 
-  // Create buffer.
   flatbuffers::FlatBufferBuilder fbb;
   // TODO(hme): use to_flatbuf
   auto message = object_manager_protocol::CreatePushRequestMessage(
-      fbb, fbb.CreateString(object_id.binary()), chunk_index, data_size, metadata_size);
+      fbb, fbb.CreateString(chunk.object_id.binary()), chunk.chunk_index,
+      chunk.data_size, chunk.metadata_size);
   fbb.Finish(message);
-  ray::Status status = conn->WriteMessage(
-      static_cast<int64_t>(object_manager_protocol::MessageType::PushRequest),
-      fbb.GetSize(), fbb.GetBufferPointer());
-  if (!status.ok()) {
-    return status;
+  if (conn->ZeroCopyWritesEnabled()) {
+    // Let the kernel transmit the chunk straight from the object store's
+    // memory. The chunk is released once the kernel reports that it no longer
+    // references it, which may be long after the write completes.
+    conn->WriteMessageWithBufferZeroCopyAsync(
+        static_cast<int64_t>(object_manager_protocol::MessageType::PushRequest),
+        fbb.GetSize(), fbb.GetBufferPointer(),
+        asio::buffer(chunk_info.data, chunk_info.buffer_length),
+        [this, chunk]() {
+          buffer_pool_.ReleaseGetChunk(chunk.object_id, chunk.chunk_index);
+        },
+        peer->strand.wrap([this, peer, conn, chunk](const ray::Status &status) {
+          HandleChunkSent(peer, conn, chunk, status);
+        }));
+    return;
   }
-  return SendObjectData(object_id, chunk_info, conn);
+  // The chunk stays in the buffer pool until the write completes, so the data
+  // is written without copying it.
+  conn->WriteMessageWithBufferAsync(
+      static_cast<int64_t>(object_manager_protocol::MessageType::PushRequest),
+      fbb.GetSize(), fbb.GetBufferPointer(),
+      asio::buffer(chunk_info.data, chunk_info.buffer_length),
+      peer->strand.wrap([this, peer, conn, chunk](const ray::Status &status) {
+        // Do this regardless of whether it failed or succeeded.
+        buffer_pool_.ReleaseGetChunk(chunk.object_id, chunk.chunk_index);
+        HandleChunkSent(peer, conn, chunk, status);
+      }));
 }
 
-ray::Status ObjectManager::SendObjectData(const ObjectID &object_id,
-                                          const ObjectBufferPool::ChunkInfo &chunk_info,
-                                          std::shared_ptr<SenderConnection> &conn) {
-  boost::system::error_code error;
-  std::vector<asio::const_buffer> buffer;
-  buffer.push_back(asio::buffer(chunk_info.data, chunk_info.buffer_length));
-  Status status = conn->WriteBuffer(buffer);
+void ObjectManager::HandleChunkSent(const std::shared_ptr<PeerSendState> &peer,
+                                    std::shared_ptr<SenderConnection> conn,
+                                    const ChunkSend &chunk, const ray::Status &status) {
+  if (peer->removed) {
+    // The remote object manager was removed, so close the connection.
+    peer->num_connections--;
+    return;
+  }
+  if (status.ok()) {
+    if (conn->ZeroCopyWritesEnabled()) {
+      ScheduleZeroCopyReap(peer);
+    }
+    peer->idle_connections.push_back(std::move(conn));
+    RAY_LOG(DEBUG) << "SendCompleted " << client_id_ << " " << chunk.object_id << " "
+                   << chunk.chunk_index;
+  } else {
+    // Drop the failed connection. The next chunk opens a new one.
+    CheckIOError(status, "Push");
+    peer->num_connections--;
+  }
+  DispatchChunkSends(peer);
+}
 
-  // Do this regardless of whether it failed or succeeded.
-  buffer_pool_.ReleaseGetChunk(object_id, chunk_info.chunk_index);
+void ObjectManager::ScheduleZeroCopyReap(const std::shared_ptr<PeerSendState> &peer) {
+  if (peer->reaping) {
+    return;
+  }
+  peer->reaping = true;
+  peer->reap_timer.expires_from_now(boost::posix_time::milliseconds(1));
+  peer->reap_timer.async_wait(
+      peer->strand.wrap([this, peer](const boost::system::error_code &error) {
+        peer->reaping = false;
+        if (error) {
+          return;
+        }
+        size_t num_pending = 0;
+        for (const auto &conn : peer->idle_connections) {
+          num_pending += conn->ReapZeroCopyCompletions(/*timeout_ms=*/0);
+        }
+        if (num_pending > 0) {
+          ScheduleZeroCopyReap(peer);
+        }
+      }));
+}
 
-  if (status.ok()) {
-    connection_pool_.ReleaseSender(ConnectionPool::ConnectionType::TRANSFER, conn);
-    RAY_LOG(DEBUG) << "SendCompleted " << client_id_ << " " << object_id << " "
-                   << config_.max_sends;
+void ObjectManager::HandleClientRemoved(const ClientID &client_id) {
+  auto it = peer_send_states_.find(client_id);
+  if (it == peer_send_states_.end()) {
+    return;
   }
-  return status;
+  std::shared_ptr<PeerSendState> peer = std::move(it->second);
+  peer_send_states_.erase(it);
+  // The send threads may be using the peer's state, so drop its queued chunks
+  // and its idle connections on its strand. Each chunk in flight drops its
+  // connection once its write completes, and the handlers in flight keep the
+  // state alive until then.
+  peer->strand.post([peer]() {
+    peer->removed = true;
+    peer->queued_chunks.clear();
+    peer->num_connections -= static_cast<int64_t>(peer->idle_connections.size());
+    peer->idle_connections.clear();
+    peer->reap_timer.cancel();
+  });
 }
 
 void ObjectManager::CancelPull(const ObjectID &object_id) {
+  // The nodes that requested chunks of the object from this node re-route
+  // them once they notice that none arrive.
+  relay_requests_.erase(object_id);
+  // Other nodes should not pull the object from this node once it stops
+  // pulling it, since the rest of its chunks may never arrive.
+  RemovePartialObject(object_id);
   auto it = pull_requests_.find(object_id);
   if (it == pull_requests_.end()) {
     return;
@@ -449,6 +1053,23 @@ void ObjectManager::CancelPull(const ObjectID &object_id) {
   pull_requests_.erase(it);
 }
 
+bool ObjectManager::GetObjectLocations(const ObjectID &object_id,
+                                       std::vector<ClientID> *client_ids,
+                                       int64_t *object_size) const {
+  bool found = object_directory_->GetCachedLocations(object_id, client_ids, object_size);
+  auto it = local_objects_.find(object_id);
+  if (it != local_objects_.end()) {
+    // The local store has the authoritative size and location for the object.
+    if (std::find(client_ids->begin(), client_ids->end(), client_id_) ==
+        client_ids->end()) {
+      client_ids->push_back(client_id_);
+    }
+    *object_size = it->second.data_size + it->second.metadata_size;
+    found = true;
+  }
+  return found;
+}
+
 ray::Status ObjectManager::Wait(const std::vector<ObjectID> &object_ids,
                                 int64_t timeout_ms, uint64_t num_required_objects,
                                 bool wait_local, const WaitCallback &callback) {
@@ -626,15 +1247,22 @@ void ObjectManager::WaitComplete(const UniqueID &wait_id) {
 
 std::shared_ptr<SenderConnection> ObjectManager::CreateSenderConnection(
     ConnectionPool::ConnectionType type, RemoteConnectionInfo info) {
-  std::shared_ptr<SenderConnection> conn =
-      SenderConnection::Create(*main_service_, info.client_id, info.ip, info.port);
+  // Transfer connections are written to asynchronously from the send threads,
+  // so their completion handlers run on send_service_.
+  bool is_transfer = (type == ConnectionPool::ConnectionType::TRANSFER);
+  std::shared_ptr<SenderConnection> conn = SenderConnection::Create(
+      is_transfer ? send_service_ : *main_service_, info.client_id, info.ip, info.port);
   if (conn == nullptr) {
     RAY_LOG(ERROR) << "Failed to connect to remote object manager.";
     return conn;
   }
+  if (is_transfer && RayConfig::instance().object_manager_zero_copy_sends() &&
+      !conn->EnableZeroCopyWrites()) {
+    RAY_LOG(WARNING) << "Zero-copy sends are not supported, so chunks are copied "
+                     << "into the socket buffer.";
+  }
   // Prepare client connection info buffer
   flatbuffers::FlatBufferBuilder fbb;
-  bool is_transfer = (type == ConnectionPool::ConnectionType::TRANSFER);
   auto message = object_manager_protocol::CreateConnectClientMessage(
       fbb, fbb.CreateString(client_id_.binary()), is_transfer);
   fbb.Finish(message);
@@ -661,6 +1289,14 @@ void ObjectManager::ProcessClientMessage(std::shared_ptr<TcpClientConnection> &c
     ReceivePullRequest(conn, message);
     break;
   }
+  case static_cast<int64_t>(object_manager_protocol::MessageType::PullRequestBatch): {
+    ReceivePullRequestBatch(conn, message);
+    break;
+  }
+  case static_cast<int64_t>(object_manager_protocol::MessageType::PullChunksRequest): {
+    ReceivePullChunksRequest(conn, message);
+    break;
+  }
   case static_cast<int64_t>(object_manager_protocol::MessageType::ConnectClient): {
     ConnectClient(conn, message);
     break;
@@ -711,6 +1347,64 @@ void ObjectManager::ReceivePullRequest(std::shared_ptr<TcpClientConnection> &con
   conn->ProcessMessages();
 }
 
+void ObjectManager::ReceivePullRequestBatch(std::shared_ptr<TcpClientConnection> &conn,
+                                            const uint8_t *message) {
+  // Serialize and push each object to requesting client.
+  auto pr =
+      flatbuffers::GetRoot<object_manager_protocol::PullRequestBatchMessage>(message);
+  ClientID client_id = ClientID::from_binary(pr->client_id()->str());
+  for (const auto &object_id : from_flatbuf(*pr->object_ids())) {
+    if (local_objects_.count(object_id) == 0 ||
+        !RedirectPull(object_id, client_id, /*num_stripes=*/1, /*stripe_index=*/0, {},
+                      /*num_forwards=*/0)) {
+      Push(object_id, client_id);
+    }
+  }
+  conn->ProcessMessages();
+}
+
+void ObjectManager::ReceivePullChunksRequest(std::shared_ptr<TcpClientConnection> &conn,
+                                             const uint8_t *message) {
+  auto pr =
+      flatbuffers::GetRoot<object_manager_protocol::PullChunksRequestMessage>(message);
+  ObjectID object_id = ObjectID::from_binary(pr->object_id()->str());
+  ClientID client_id = ClientID::from_binary(pr->client_id()->str());
+  std::vector<uint64_t> chunk_indices;
+  if (pr->chunk_indices() != nullptr) {
+    chunk_indices.assign(pr->chunk_indices()->begin(), pr->chunk_indices()->end());
+  }
+  if (client_id == client_id_) {
+    // A forwarded request came back to the node that made it.
+    RAY_LOG(WARNING) << "Dropping the pull of " << object_id
+                     << " that was forwarded back to this node";
+    conn->ProcessMessages();
+    return;
+  }
+  // Serve the request if this node has the object or is receiving it, i.e.,
+  // has received some of its chunks and not all of them. Otherwise, the
+  // requester re-routes these chunks to another location once it notices that
+  // none of them arrive. Requests for individual chunks are re-routes, so they
+  // are never forwarded.
+  uint64_t num_chunks;
+  std::vector<uint64_t> missing_chunks;
+  const bool is_local = local_objects_.count(object_id) != 0;
+  const bool is_receiving =
+      !is_local && buffer_pool_.GetMissingChunks(object_id, &num_chunks, &missing_chunks);
+  if ((is_local || is_receiving) &&
+      (pr->num_stripes() == 0 ||
+       !RedirectPull(object_id, client_id, pr->num_stripes(), pr->stripe_index(),
+                     chunk_indices, pr->num_forwards()))) {
+    if (is_local) {
+      PushChunks(object_id, client_id, pr->num_stripes(), pr->stripe_index(),
+                 chunk_indices);
+    } else {
+      RelayChunks(object_id, client_id, pr->num_stripes(), pr->stripe_index(),
+                  chunk_indices);
+    }
+  }
+  conn->ProcessMessages();
+}
+
 void ObjectManager::ReceivePushRequest(std::shared_ptr<TcpClientConnection> &conn,
                                        const uint8_t *message) {
   // Serialize.
@@ -744,9 +1438,22 @@ void ObjectManager::ExecuteReceiveObject(const ClientID &client_id,
     conn.ReadBuffer(buffer, ec);
     if (ec.value() == boost::system::errc::success) {
       buffer_pool_.SealChunk(object_id, chunk_index);
+      main_service_->post(
+          [this, object_id, client_id, chunk_index, data_size, metadata_size]() {
+            HandlePullChunkReceived(object_id, client_id, chunk_index, data_size,
+                                    metadata_size);
+          });
     } else {
-      buffer_pool_.AbortCreateChunk(object_id, chunk_index);
-      // TODO(hme): This chunk failed, so create a pull request for this chunk.
+      const bool aborted = buffer_pool_.AbortCreateChunk(object_id, chunk_index);
+      RAY_LOG(ERROR) << "Failed to receive chunk " << chunk_index << " of "
+                     << object_id << ": " << boost_to_ray_status(ec).ToString();
+      main_service_->post([this, object_id, client_id, chunk_index, aborted]() {
+        if (aborted) {
+          // None of the object's chunks are left in the local store.
+          RemovePartialObject(object_id);
+        }
+        HandlePullChunkFailed(object_id, client_id, chunk_index);
+      });
     }
   } else {
     RAY_LOG(ERROR) << "Create Chunk Failed index = " << chunk_index << ": "
@@ -802,16 +1509,27 @@ void ObjectManager::SpreadFreeObjectRequest(const std::vector<ObjectID> &object_
     if (conn == nullptr) {
       conn = CreateSenderConnection(ConnectionPool::ConnectionType::MESSAGE,
                                     connection_info);
+      if (conn == nullptr) {
+        return;
+      }
       connection_pool_.RegisterSender(ConnectionPool::ConnectionType::MESSAGE,
                                       connection_info.client_id, conn);
     }
-    ray::Status status = conn->WriteMessage(
+    conn->WriteMessageAsync(
         static_cast<int64_t>(object_manager_protocol::MessageType::FreeRequest),
-        fbb.GetSize(), fbb.GetBufferPointer());
-    if (status.ok()) {
-      connection_pool_.ReleaseSender(ConnectionPool::ConnectionType::MESSAGE, conn);
-    }
-    // TODO(Yuhong): Implement ConnectionPool::RemoveSender and call it in "else".
+        fbb.GetSize(), fbb.GetBufferPointer(),
+        [this, conn](const ray::Status &status) mutable {
+          if (status.ok()) {
+            connection_pool_.ReleaseSender(ConnectionPool::ConnectionType::MESSAGE,
+                                           conn);
+          } else {
+            // Drop the failed connection. The next request opens a new one.
+            CheckIOError(status, "FreeObjects");
+            RAY_CHECK_OK(connection_pool_.RemoveSender(
+                ConnectionPool::ConnectionType::MESSAGE, conn));
+            conn->Close();
+          }
+        });
   };
   object_directory_->RunFunctionForEachClient(function_on_client);
 }
@@ -2,10 +2,12 @@
 #define RAY_OBJECT_MANAGER_OBJECT_MANAGER_H
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
+#include <random>
 #include <thread>
 
 #include <boost/asio.hpp>
@@ -32,7 +34,8 @@ struct ObjectManagerConfig {
   /// The time in milliseconds to wait before retrying a pull
   /// that fails due to client id lookup.
   uint pull_timeout_ms;
-  /// Maximum number of sends allowed.
+  /// The number of threads that send objects. Sends are asynchronous, so each
+  /// thread has many chunks in flight.
   int max_sends;
   /// Maximum number of receives allowed.
   int max_receives;
@@ -45,11 +48,31 @@ struct ObjectManagerConfig {
   /// Negative: waiting infinitely.
   /// 0: giving up retrying immediately.
   int push_timeout_ms;
+  /// The maximum number of nodes that an object is served to at once before
+  /// further pulls of it are forwarded to those nodes. 0: never forwarding.
+  int64_t broadcast_fanout;
 };
 
+/// Get the range of chunks in a stripe of an object. The stripes of an object
+/// are contiguous, disjoint and together cover all of its chunks.
+///
+/// \param num_chunks The number of chunks in the object.
+/// \param num_stripes The number of stripes that the chunks are split into.
+/// \param stripe_index The index of the stripe.
+/// \return The range of chunk indices [first, second) in the stripe.
+std::pair<uint64_t, uint64_t> GetStripeRange(uint64_t num_chunks, uint64_t num_stripes,
+                                             uint64_t stripe_index);
+
 class ObjectManagerInterface {
  public:
   virtual ray::Status Pull(const ObjectID &object_id) = 0;
+  /// Pull a batch of objects. By default, each object is pulled separately.
+  virtual ray::Status PullObjects(const std::vector<ObjectID> &object_ids) {
+    for (const auto &object_id : object_ids) {
+      RAY_RETURN_NOT_OK(Pull(object_id));
+    }
+    return ray::Status::OK();
+  }
   virtual void CancelPull(const ObjectID &object_id) = 0;
   virtual ~ObjectManagerInterface(){};
 };
@@ -110,6 +133,14 @@ class ObjectManager : public ObjectManagerInterface {
   /// \return Status of whether the pull request successfully initiated.
   ray::Status Pull(const ObjectID &object_id);
 
+  /// Pull a batch of objects. The locations of all of the objects are
+  /// subscribed to at once, and the pull requests for objects that are tried
+  /// at the same remote node are sent to it in a single message.
+  ///
+  /// \param object_ids The objects' object ids.
+  /// \return Status of whether the pull requests successfully initiated.
+  ray::Status PullObjects(const std::vector<ObjectID> &object_ids);
+
   /// Try to Pull an object from one of its expected client locations. If there
   /// are more client locations to try after this attempt, then this method
   /// will try each of the other clients in succession, with a timeout between
@@ -145,6 +176,26 @@ class ObjectManager : public ObjectManagerInterface {
   /// \return Void.
   void CancelPull(const ObjectID &object_id);
 
+  /// Stop sending chunks to a remote object manager that was removed from the
+  /// client table, and close the idle transfer connections to it.
+  ///
+  /// \param client_id The ID of the removed remote object manager.
+  /// \return Void.
+  void HandleClientRemoved(const ClientID &client_id);
+
+  /// Get the known locations and size of an object, using only information
+  /// that is already available to this object manager. This includes the
+  /// local store, the locations of objects that are currently being pulled,
+  /// and the results of recent lookups. No requests are made to the GCS.
+  ///
+  /// \param object_id The object's object id.
+  /// \param[out] client_ids The known locations of the object.
+  /// \param[out] object_size The size of the object in bytes.
+  /// \return True if the object's locations and size are known. False
+  /// otherwise.
+  bool GetObjectLocations(const ObjectID &object_id, std::vector<ClientID> *client_ids,
+                          int64_t *object_size) const;
+
   /// Callback definition for wait.
   using WaitCallback = std::function<void(const std::vector<ray::ObjectID> &found,
                                           const std::vector<ray::ObjectID> &remaining)>;
@@ -173,11 +224,45 @@ class ObjectManager : public ObjectManagerInterface {
  private:
   friend class TestObjectManager;
 
+  /// A remote object manager that a striped pull requested chunks from.
+  struct StripeSource {
+    /// The index of the stripe requested from this source, or -1 if only
+    /// individual chunks were requested.
+    int64_t stripe_index;
+    /// The chunks requested individually from this source, e.g., the chunks
+    /// re-routed from a stalled source.
+    std::vector<uint64_t> chunk_indices;
+    /// Whether a chunk was received from this source since the last check for
+    /// stalled sources.
+    bool made_progress;
+  };
+
+  /// A pull that requests disjoint stripes of an object's chunks from several
+  /// remote object managers at once.
+  struct StripedPull {
+    StripedPull(uint64_t num_stripes) : num_stripes(num_stripes), num_chunks(0) {}
+    /// The number of stripes that the object's chunks were split into.
+    uint64_t num_stripes;
+    /// The number of chunks in the object. This is 0 until the first chunk is
+    /// received, since only the senders know the exact size of the object.
+    /// The chunks that are still missing are tracked by the buffer pool.
+    uint64_t num_chunks;
+    /// The remote object managers that chunks were requested from.
+    std::unordered_map<ClientID, StripeSource> sources;
+  };
+
   struct PullRequest {
-    PullRequest() : retry_timer(nullptr), timer_set(false), client_locations() {}
+    PullRequest()
+        : retry_timer(nullptr),
+          timer_set(false),
+          client_locations(),
+          striped_pull(nullptr) {}
     std::unique_ptr<boost::asio::deadline_timer> retry_timer;
     bool timer_set;
     std::vector<ClientID> client_locations;
+    /// The state of the pull if the object is pulled from several remote
+    /// object managers at once, otherwise null.
+    std::unique_ptr<StripedPull> striped_pull;
   };
 
   struct WaitState {
@@ -205,6 +290,81 @@ class ObjectManager : public ObjectManagerInterface {
     uint64_t num_required_objects;
   };
 
+  /// A chunk of an object that is queued to be sent to a remote object
+  /// manager.
+  struct ChunkSend {
+    ObjectID object_id;
+    uint64_t data_size;
+    uint64_t metadata_size;
+    uint64_t chunk_index;
+  };
+
+  /// The chunks that are queued to be sent to a remote object manager, and the
+  /// transfer connections that send them. This is only accessed on the
+  /// strand, so the send threads never handle the same remote object manager
+  /// at once.
+  struct PeerSendState {
+    PeerSendState(boost::asio::io_service &send_service)
+        : strand(send_service),
+          num_connections(0),
+          reap_timer(send_service),
+          reaping(false),
+          removed(false) {}
+
+    /// Serializes the handlers for this remote object manager.
+    boost::asio::io_service::strand strand;
+    /// The address of the remote object manager.
+    RemoteConnectionInfo connection_info;
+    /// The chunks that are waiting for a free connection.
+    std::deque<ChunkSend> queued_chunks;
+    /// The connections that do not have a chunk in flight.
+    std::vector<std::shared_ptr<SenderConnection>> idle_connections;
+    /// The number of open transfer connections, including the idle ones.
+    int64_t num_connections;
+    /// The timer for reaping the completions of zero-copy sends on the idle
+    /// connections.
+    boost::asio::deadline_timer reap_timer;
+    /// Whether the reap timer is set.
+    bool reaping;
+    /// Whether the remote object manager was removed from the client table.
+    /// No more chunks are sent to it.
+    bool removed;
+  };
+
+  /// A request for chunks of an object that this node is still receiving.
+  struct RelayRequest {
+    /// Whether the request covers a chunk.
+    ///
+    /// \param num_chunks The number of chunks in the object.
+    /// \param chunk_index The index of the chunk.
+    /// \return Whether the chunk was requested.
+    bool Wants(uint64_t num_chunks, uint64_t chunk_index) const;
+
+    /// The node to send the chunks to.
+    ClientID client_id;
+    /// The number of stripes that the object's chunks are split into, or 0 if
+    /// only individual chunks were requested.
+    uint64_t num_stripes;
+    /// The index of the requested stripe.
+    uint64_t stripe_index;
+    /// The individually requested chunks.
+    std::unordered_set<uint64_t> chunk_indices;
+    /// The chunks that were sent already.
+    std::unordered_set<uint64_t> sent_chunks;
+  };
+
+  /// The nodes that this node is serving an object to directly. Further
+  /// requests for the object are forwarded to these nodes.
+  struct BroadcastState {
+    BroadcastState() : next_child(0), last_served_ms(0) {}
+    /// The nodes that were served the object directly.
+    std::vector<ClientID> children;
+    /// The index of the child to forward the next request to.
+    size_t next_child;
+    /// The time at which a node was last served the object directly.
+    int64_t last_served_ms;
+  };
+
   /// Creates a wait request and adds it to active_wait_requests_.
   ray::Status AddWaitRequest(const UniqueID &wait_id,
                              const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
@@ -240,36 +400,198 @@ class ObjectManager : public ObjectManagerInterface {
   /// Register object remove with directory.
   void NotifyDirectoryObjectDeleted(const ObjectID &object_id);
 
+  /// Stop advertising this node as a partial holder of an object that it is
+  /// no longer receiving, unless the object is local.
+  /// Executes on main_service_ thread.
+  ///
+  /// \param object_id The object.
+  /// \return Void.
+  void RemovePartialObject(const ObjectID &object_id);
+
+  /// Handle a notification of the locations of an object that is being
+  /// pulled.
+  void HandlePullLocations(const std::vector<ClientID> &client_ids,
+                           const ObjectID &object_id);
+
+  /// Queue a pull request for an object to a remote object manager. The
+  /// requests that are queued for the same remote object manager in one
+  /// iteration of the event loop are sent together.
+  /// Executes on main_service_ thread.
+  void QueuePullRequest(const ObjectID &object_id, const ClientID &client_id);
+
+  /// Send the queued pull requests to a remote object manager, skipping the
+  /// objects whose Pull has been canceled since.
+  /// Executes on main_service_ thread.
+  void SendQueuedPullRequests(const ClientID &client_id);
+
   /// Part of an asynchronous sequence of Pull methods.
   /// Uses an existing connection or creates a connection to ClientID.
   /// Executes on main_service_ thread.
-  void PullEstablishConnection(const ObjectID &object_id, const ClientID &client_id);
+  void PullEstablishConnection(const ClientID &client_id, int64_t message_type,
+                               const std::string &message);
+
+  /// Asynchronously send a pull request message via remote object manager
+  /// connection.
+  /// Executes on main_service_ thread.
+  void PullSendRequest(int64_t message_type, const std::string &message,
+                       std::shared_ptr<SenderConnection> &conn);
+
+  /// Start a striped pull of an object, if its size is known, it spans more
+  /// than one chunk, and it has more than one remote location. Each location
+  /// is asked for a disjoint stripe of the object's chunks.
+  /// Executes on main_service_ thread.
+  ///
+  /// \param object_id The object to pull.
+  /// \return Whether a striped pull was started.
+  bool TryStripedPull(const ObjectID &object_id);
 
-  /// Synchronously send a pull request via remote object manager connection.
+  /// Ask a remote object manager to push a stripe of an object's chunks and
+  /// some individual chunks to a requester, usually this node. The request
+  /// records how many times it was forwarded on the requester's behalf.
   /// Executes on main_service_ thread.
-  ray::Status PullSendRequest(const ObjectID &object_id,
-                              std::shared_ptr<SenderConnection> &conn);
+  void SendPullChunksRequest(const ObjectID &object_id, const ClientID &client_id,
+                             const ClientID &requester_id, uint64_t num_stripes,
+                             uint64_t stripe_index,
+                             const std::vector<uint64_t> &chunk_indices,
+                             uint64_t num_forwards);
+
+  /// Split chunks into contiguous ranges, one per remote object manager, and
+  /// request each range from its remote object manager.
+  /// Executes on main_service_ thread.
+  void RequestChunks(const ObjectID &object_id, StripedPull &striped_pull,
+                     const std::vector<uint64_t> &chunk_indices,
+                     const std::vector<ClientID> &client_ids);
+
+  /// Get the chunks that were requested from a source of a striped pull and
+  /// have not been received yet. The number of chunks in the object must be
+  /// known.
+  ///
+  /// \param striped_pull The striped pull.
+  /// \param source The source of the striped pull.
+  /// \param missing_chunks The chunks of the object that have not been
+  /// received yet.
+  /// \return The source's missing chunks, in increasing order.
+  std::vector<uint64_t> GetMissingChunks(
+      const StripedPull &striped_pull, const StripeSource &source,
+      const std::unordered_set<uint64_t> &missing_chunks) const;
+
+  /// Record that a chunk of an object was received, for the striped pull of
+  /// the object if there is one, and relay the chunk to the nodes that
+  /// requested it from this node.
+  /// Executes on main_service_ thread.
+  void HandlePullChunkReceived(const ObjectID &object_id, const ClientID &client_id,
+                               uint64_t chunk_index, uint64_t data_size,
+                               uint64_t metadata_size);
+
+  /// Re-request a chunk of an object that failed to be received, preferably
+  /// from a different remote object manager.
+  /// Executes on main_service_ thread.
+  void HandlePullChunkFailed(const ObjectID &object_id, const ClientID &client_id,
+                             uint64_t chunk_index);
+
+  /// Re-route the missing chunks of the sources of a striped pull that did
+  /// not send any chunk since the last check to the other sources.
+  /// Executes on main_service_ thread.
+  void CheckStripedPull(const ObjectID &object_id);
+
+  /// Set the timer after which the sources of a striped pull are checked for
+  /// stalls.
+  /// Executes on main_service_ thread.
+  void SetStripedPullTimer(const ObjectID &object_id);
+
+  /// Push some of the chunks of a local object to a remote object manager.
+  ///
+  /// \param object_id The object to push.
+  /// \param client_id The remote object manager to push to.
+  /// \param num_stripes The number of stripes that the object's chunks are
+  /// split into, or 0 to only push the chunks in chunk_indices.
+  /// \param stripe_index The index of the stripe to push.
+  /// \param chunk_indices Chunks to push in addition to the stripe.
+  void PushChunks(const ObjectID &object_id, const ClientID &client_id,
+                  uint64_t num_stripes, uint64_t stripe_index,
+                  const std::vector<uint64_t> &chunk_indices);
+
+  /// Queue chunks of an object to be sent to a remote object manager. The
+  /// object must be local, or the chunks must have been received already.
+  ///
+  /// \param object_id The object to send.
+  /// \param client_id The remote object manager to send to.
+  /// \param data_size The sum of the object size and metadata size.
+  /// \param metadata_size The size of the metadata.
+  /// \param chunk_indices The chunks to send.
+  void QueueChunkSends(const ObjectID &object_id, const ClientID &client_id,
+                       uint64_t data_size, uint64_t metadata_size,
+                       const std::vector<uint64_t> &chunk_indices);
+
+  /// Forward a pull request for an object that this node holds to one of the
+  /// nodes that it is already sending the object to, if it is sending the
+  /// object to broadcast_fanout nodes already. The node that the request is
+  /// forwarded to relays the chunks as it receives them, so the nodes that
+  /// pull the object at once form a pipelined distribution tree. A request
+  /// that was forwarded object_manager_max_pull_forwards times already is
+  /// never forwarded again.
+  ///
+  /// \param object_id The requested object.
+  /// \param requester_id The node that requested the object.
+  /// \param num_stripes The number of stripes of the request.
+  /// \param stripe_index The index of the requested stripe.
+  /// \param chunk_indices The individually requested chunks.
+  /// \param num_forwards The number of times the request was forwarded.
+  /// \return Whether the request was forwarded. If not, this node should
+  /// serve it.
+  bool RedirectPull(const ObjectID &object_id, const ClientID &requester_id,
+                    uint64_t num_stripes, uint64_t stripe_index,
+                    const std::vector<uint64_t> &chunk_indices, uint64_t num_forwards);
+
+  /// Send the requested chunks of an object that this node is still receiving
+  /// to a remote object manager. The chunks that were received already are
+  /// sent immediately, and the rest are sent as they are received.
+  ///
+  /// \param object_id The requested object.
+  /// \param client_id The remote object manager to send to.
+  /// \param num_stripes The number of stripes of the request.
+  /// \param stripe_index The index of the requested stripe.
+  /// \param chunk_indices The individually requested chunks.
+  void RelayChunks(const ObjectID &object_id, const ClientID &client_id,
+                   uint64_t num_stripes, uint64_t stripe_index,
+                   const std::vector<uint64_t> &chunk_indices);
 
   std::shared_ptr<SenderConnection> CreateSenderConnection(
       ConnectionPool::ConnectionType type, RemoteConnectionInfo info);
 
-  /// Begin executing a send.
-  /// Executes on send_service_ thread pool.
-  void ExecuteSendObject(const ClientID &client_id, const ObjectID &object_id,
-                         uint64_t data_size, uint64_t metadata_size, uint64_t chunk_index,
-                         const RemoteConnectionInfo &connection_info);
-  /// This method synchronously sends the object id and object size
-  /// to the remote object manager.
-  /// Executes on send_service_ thread pool.
-  ray::Status SendObjectHeaders(const ObjectID &object_id, uint64_t data_size,
-                                uint64_t metadata_size, uint64_t chunk_index,
-                                std::shared_ptr<SenderConnection> &conn);
-
-  /// This method initiates the actual object transfer.
-  /// Executes on send_service_ thread pool.
-  ray::Status SendObjectData(const ObjectID &object_id,
-                             const ObjectBufferPool::ChunkInfo &chunk_info,
-                             std::shared_ptr<SenderConnection> &conn);
+  /// Start sending the queued chunks to a remote object manager, one chunk per
+  /// transfer connection, opening connections up to the per-peer limit.
+  /// Executes on the peer's strand on the send_service_ thread pool.
+  void DispatchChunkSends(const std::shared_ptr<PeerSendState> &peer);
+
+  /// Asynchronously write a chunk's header and data to a remote object
+  /// manager. The connection is returned to the peer once the write completes.
+  /// If zero-copy writes are enabled on the connection, the chunk is written
+  /// synchronously instead, and stays pinned in the buffer pool until the
+  /// kernel reports that it no longer references the chunk's memory.
+  /// Executes on the peer's strand on the send_service_ thread pool.
+  void SendChunk(const std::shared_ptr<PeerSendState> &peer,
+                 std::shared_ptr<SenderConnection> conn, const ChunkSend &chunk);
+
+  /// Return a connection to the peer after writing a chunk, or drop it if the
+  /// write failed, and send the next queued chunks.
+  /// Executes on the peer's strand on the send_service_ thread pool.
+  ///
+  /// \param peer The remote object manager that the chunk was sent to.
+  /// \param conn The connection that the chunk was written to.
+  /// \param chunk The chunk.
+  /// \param status The status of the write.
+  void HandleChunkSent(const std::shared_ptr<PeerSendState> &peer,
+                       std::shared_ptr<SenderConnection> conn, const ChunkSend &chunk,
+                       const ray::Status &status);
+
+  /// Periodically reap the completions of the zero-copy sends on a peer's idle
+  /// connections, until none are pending. The connections with a chunk in
+  /// flight reap their completions when they write the next chunk.
+  /// Executes on the peer's strand on the send_service_ thread pool.
+  ///
+  /// \param peer The remote object manager.
+  void ScheduleZeroCopyReap(const std::shared_ptr<PeerSendState> &peer);
 
   /// Invoked when a remote object manager pushes an object to this object manager.
   /// This will invoke the object receive on the receive_service_ thread pool.
@@ -283,6 +605,12 @@ class ObjectManager : public ObjectManagerInterface {
   /// Handles receiving a pull request message.
   void ReceivePullRequest(std::shared_ptr<TcpClientConnection> &conn,
                           const uint8_t *message);
+  /// Handles receiving a pull request message for a batch of objects.
+  void ReceivePullRequestBatch(std::shared_ptr<TcpClientConnection> &conn,
+                               const uint8_t *message);
+  /// Handles receiving a pull request message for some chunks of an object.
+  void ReceivePullChunksRequest(std::shared_ptr<TcpClientConnection> &conn,
+                                const uint8_t *message);
   /// Handles freeing objects request.
   void ReceiveFreeRequest(std::shared_ptr<TcpClientConnection> &conn,
                           const uint8_t *message);
@@ -327,6 +655,25 @@ class ObjectManager : public ObjectManagerInterface {
   /// Connection pool for reusing outgoing connections to remote object managers.
   ConnectionPool connection_pool_;
 
+  /// The chunk sends to each remote object manager. The map is only accessed
+  /// on the main_service_ thread. An entry is erased when its remote object
+  /// manager is removed from the client table, and the send handlers in flight
+  /// keep the state alive until they run.
+  std::unordered_map<ClientID, std::shared_ptr<PeerSendState>> peer_send_states_;
+
+  /// The requests for chunks of objects that this node is still receiving.
+  std::unordered_map<ObjectID, std::vector<RelayRequest>> relay_requests_;
+
+  /// The nodes that this node serves each object to directly.
+  std::unordered_map<ObjectID, BroadcastState> broadcast_states_;
+
+  /// The objects that this node reported to the object directory as partially
+  /// received, and has not reported as added yet.
+  std::unordered_set<ObjectID> partial_objects_;
+
+  /// Used to spread the pulls of an object over its holders.
+  std::mt19937_64 gen_;
+
   /// Cache of locally available objects.
   std::unordered_map<ObjectID, ObjectInfoT> local_objects_;
 
@@ -346,6 +693,10 @@ class ObjectManager : public ObjectManagerInterface {
       unfulfilled_push_requests_;
 
   std::unordered_map<ObjectID, PullRequest> pull_requests_;
+
+  /// The pull requests that are waiting to be sent to each remote object
+  /// manager.
+  std::unordered_map<ClientID, std::vector<ObjectID>> queued_pull_requests_;
 };
 
 }  // namespace ray
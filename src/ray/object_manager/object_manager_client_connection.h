@@ -44,6 +44,34 @@ class SenderConnection : public boost::enable_shared_from_this<SenderConnection>
     return conn_->WriteMessage(type, length, message);
   }
 
+  /// Write a message to the client asynchronously.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param handler A callback to run once the message has been written, or
+  /// the write failed.
+  void WriteMessageAsync(int64_t type, uint64_t length, const uint8_t *message,
+                         const std::function<void(const ray::Status &)> &handler) {
+    conn_->WriteMessageAsync(type, length, message, handler);
+  }
+
+  /// Write a message followed by a buffer to the client asynchronously. The
+  /// buffer is not copied, so it must stay valid until the handler runs. No
+  /// other asynchronous write may be started until the handler runs.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param buffer The buffer to write after the message.
+  /// \param handler A callback to run once the write has completed or failed.
+  void WriteMessageWithBufferAsync(
+      int64_t type, uint64_t length, const uint8_t *message,
+      const boost::asio::const_buffer &buffer,
+      const std::function<void(const ray::Status &)> &handler) {
+    conn_->WriteMessageWithBufferAsync(type, length, message, buffer, handler);
+  }
+
   /// Write a buffer to this connection.
   ///
   /// \param buffer The buffer.
@@ -61,6 +89,44 @@ class SenderConnection : public boost::enable_shared_from_this<SenderConnection>
     return conn_->ReadBuffer(buffer, ec);
   }
 
+  /// Close this connection.
+  void Close() { conn_->Close(); }
+
+  /// Enable zero-copy writes on this connection.
+  ///
+  /// \return Whether zero-copy writes are enabled.
+  bool EnableZeroCopyWrites() { return conn_->EnableZeroCopyWrites(); }
+
+  /// \return Whether zero-copy writes are enabled on this connection.
+  bool ZeroCopyWritesEnabled() const { return conn_->ZeroCopyWritesEnabled(); }
+
+  /// Write a message followed by a buffer to this connection asynchronously,
+  /// without copying the buffer into the socket's send buffer as far as it has
+  /// room. The buffer must stay valid until on_complete runs.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message.
+  /// \param message A pointer to the message buffer.
+  /// \param buffer The buffer to write after the message.
+  /// \param on_complete A callback to run once the kernel no longer references
+  /// the buffer.
+  /// \param handler A callback to run once the write has completed or failed.
+  void WriteMessageWithBufferZeroCopyAsync(
+      int64_t type, uint64_t length, const uint8_t *message,
+      const boost::asio::const_buffer &buffer, const std::function<void()> &on_complete,
+      const std::function<void(const ray::Status &)> &handler) {
+    conn_->WriteMessageWithBufferZeroCopyAsync(type, length, message, buffer,
+                                               on_complete, handler);
+  }
+
+  /// Run the completion callbacks of the finished zero-copy writes.
+  ///
+  /// \param timeout_ms How long to wait for a completion if none is ready.
+  /// \return The number of zero-copy writes that are still pending.
+  size_t ReapZeroCopyCompletions(int timeout_ms) {
+    return conn_->ReapZeroCopyCompletions(timeout_ms);
+  }
+
   /// \return The ClientID of this connection.
   const ClientID &GetClientID() { return client_id_; }
 
@@ -1,3 +1,5 @@
+#include <time.h>
+
 #include <chrono>
 #include <iostream>
 #include <random>
@@ -138,6 +140,7 @@ class TestObjectManagerBase : public ::testing::Test {
     om_config_1.max_receives = max_receives_a;
     om_config_1.object_chunk_size = object_chunk_size;
     om_config_1.push_timeout_ms = push_timeout_ms;
+    om_config_1.broadcast_fanout = 0;
     server1.reset(new MockServer(main_service, om_config_1, gcs_client_1));
 
     // start second server
@@ -150,6 +153,7 @@ class TestObjectManagerBase : public ::testing::Test {
     om_config_2.max_receives = max_receives_b;
     om_config_2.object_chunk_size = object_chunk_size;
     om_config_2.push_timeout_ms = push_timeout_ms;
+    om_config_2.broadcast_fanout = 0;
     server2.reset(new MockServer(main_service, om_config_2, gcs_client_2));
 
     // connect to stores.
@@ -212,6 +216,7 @@ class StressTestObjectManager : public TestObjectManagerBase {
     PULL_B_A,
     BIDIRECTIONAL_PULL,
     BIDIRECTIONAL_PULL_VARIABLE_DATA_SIZE,
+    BATCH_PULL_A_B,
   };
 
   int async_loop_index = -1;
@@ -224,7 +229,8 @@ class StressTestObjectManager : public TestObjectManagerBase {
       TransferPattern::PULL_A_B,
       TransferPattern::PULL_B_A,
       TransferPattern::BIDIRECTIONAL_PULL,
-      TransferPattern::BIDIRECTIONAL_PULL_VARIABLE_DATA_SIZE};
+      TransferPattern::BIDIRECTIONAL_PULL_VARIABLE_DATA_SIZE,
+      TransferPattern::BATCH_PULL_A_B};
 
   int num_connected_clients = 0;
 
@@ -414,6 +420,13 @@ class StressTestObjectManager : public TestObjectManagerBase {
         status = server1->object_manager_.Pull(oid2);
       }
     } break;
+    case TransferPattern::BATCH_PULL_A_B: {
+      std::vector<ObjectID> object_ids;
+      for (int i = -1; ++i < num_trials;) {
+        object_ids.push_back(WriteDataToClient(client1, data_size));
+      }
+      status = server2->object_manager_.PullObjects(object_ids);
+    } break;
     default: {
       RAY_LOG(FATAL) << "No case for transfer_pattern "
                      << static_cast<int>(transfer_pattern);
@@ -450,6 +463,197 @@ TEST_F(StressTestObjectManager, StartStressTestObjectManager) {
   main_service.run();
 }
 
+/// Asynchronously send chunks to a peer, one at a time, each after the
+/// previous one has been written.
+void SendChunksAsync(std::shared_ptr<LocalServerConnection> conn,
+                     const std::vector<uint8_t> &header,
+                     const std::vector<uint8_t> &chunk, int num_chunks) {
+  if (num_chunks == 0) {
+    return;
+  }
+  conn->WriteMessageWithBufferAsync(
+      0, header.size(), header.data(), boost::asio::buffer(chunk),
+      [conn, &header, &chunk, num_chunks](const ray::Status &status) {
+        RAY_CHECK_OK(status);
+        SendChunksAsync(conn, header, chunk, num_chunks - 1);
+      });
+}
+
+/// Send chunks from a few send threads to peers that each drain their
+/// connection slowly.
+///
+/// \param use_async_writes Whether to write the chunks asynchronously, with
+/// one chunk in flight per peer. Otherwise, each send thread writes one chunk
+/// at a time with blocking writes, in the order that a push queues them.
+/// \return The time in milliseconds until every peer received all of its
+/// chunks.
+int64_t MeasureSlowPeerSendTime(bool use_async_writes) {
+  const int num_peers = 8;
+  const int num_chunks_per_peer = 32;
+  const int num_send_threads = 2;
+  const size_t chunk_size = 64 * 1024;
+  const std::vector<uint8_t> header(16, 1);
+  const std::vector<uint8_t> chunk(chunk_size, 2);
+  const size_t bytes_per_peer =
+      num_chunks_per_peer * (3 * sizeof(int64_t) + header.size() + chunk_size);
+
+  boost::asio::io_service send_service;
+  std::vector<std::shared_ptr<LocalServerConnection>> connections;
+  std::vector<std::thread> receivers;
+  for (int i = 0; i < num_peers; i++) {
+    boost::asio::local::stream_protocol::socket sender(send_service);
+    boost::asio::local::stream_protocol::socket receiver(send_service);
+    boost::asio::local::connect_pair(sender, receiver);
+    connections.push_back(LocalServerConnection::Create(std::move(sender)));
+    // Each peer reads at most one chunk per millisecond.
+    receivers.emplace_back(
+        [bytes_per_peer, chunk_size](boost::asio::local::stream_protocol::socket socket) {
+          std::vector<uint8_t> buffer(chunk_size);
+          boost::system::error_code error;
+          size_t bytes_read = 0;
+          while (bytes_read < bytes_per_peer && !error) {
+            bytes_read += socket.read_some(boost::asio::buffer(buffer), error);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+          RAY_CHECK(bytes_read == bytes_per_peer);
+        },
+        std::move(receiver));
+  }
+
+  int64_t start_time = current_time_ms();
+  for (const auto &conn : connections) {
+    if (use_async_writes) {
+      send_service.post([conn, &header, &chunk, num_chunks_per_peer]() {
+        SendChunksAsync(conn, header, chunk, num_chunks_per_peer);
+      });
+    } else {
+      for (int i = 0; i < num_chunks_per_peer; i++) {
+        send_service.post([conn, &header, &chunk]() {
+          RAY_CHECK_OK(conn->WriteMessage(0, header.size(), header.data()));
+          RAY_CHECK_OK(conn->WriteBuffer({boost::asio::buffer(chunk)}));
+        });
+      }
+    }
+  }
+  std::vector<std::thread> send_threads;
+  for (int i = 0; i < num_send_threads; i++) {
+    send_threads.emplace_back([&send_service]() { send_service.run(); });
+  }
+  for (auto &thread : send_threads) {
+    thread.join();
+  }
+  for (auto &thread : receivers) {
+    thread.join();
+  }
+  return current_time_ms() - start_time;
+}
+
+// The benchmarks below depend on the machine's load, so they are disabled by
+// default. Run them with --gtest_also_run_disabled_tests.
+TEST(ObjectManagerSendBenchmark, DISABLED_TestSendTimeWithSlowPeers) {
+  const int64_t blocking_send_ms = MeasureSlowPeerSendTime(/*use_async_writes=*/false);
+  const int64_t async_send_ms = MeasureSlowPeerSendTime(/*use_async_writes=*/true);
+  RAY_LOG(INFO) << "Time to send to slow peers: blocking writes " << blocking_send_ms
+                << "ms, asynchronous writes " << async_send_ms << "ms";
+  // Blocking writes pin each send thread to one slow peer until its chunks
+  // drain, while asynchronous writes keep every peer busy at once.
+  ASSERT_LT(async_send_ms, blocking_send_ms);
+}
+
+/// \return The CPU time that the calling thread has used, in milliseconds.
+double ThreadCpuTimeMs() {
+  struct timespec time;
+  RAY_CHECK(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0);
+  return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+/// Send chunks over a loopback TCP connection, and measure the CPU time that
+/// the sending thread uses.
+///
+/// \param use_zero_copy Whether to write the chunks with MSG_ZEROCOPY.
+/// Otherwise, the chunks are copied into the socket buffer.
+/// \return The sending thread's CPU time in milliseconds per GB sent, or -1 if
+/// zero-copy writes are not supported.
+double MeasureSendCpuTimePerGb(bool use_zero_copy) {
+  const int num_chunks = 512;
+  const size_t chunk_size = 1024 * 1024;
+  const std::vector<uint8_t> header(16, 1);
+  const std::vector<uint8_t> chunk(chunk_size, 2);
+  const size_t total_bytes =
+      num_chunks * (3 * sizeof(int64_t) + header.size() + chunk_size);
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::acceptor acceptor(
+      io_service,
+      boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+  boost::asio::ip::tcp::socket sender(io_service);
+  RAY_CHECK_OK(TcpConnect(sender, "127.0.0.1", acceptor.local_endpoint().port()));
+  boost::asio::ip::tcp::socket receiver(io_service);
+  acceptor.accept(receiver);
+  auto conn = TcpServerConnection::Create(std::move(sender));
+  if (use_zero_copy && !conn->EnableZeroCopyWrites()) {
+    return -1;
+  }
+  std::thread receiver_thread(
+      [total_bytes, chunk_size](boost::asio::ip::tcp::socket socket) {
+        std::vector<uint8_t> buffer(chunk_size);
+        boost::system::error_code error;
+        size_t bytes_read = 0;
+        while (bytes_read < total_bytes && !error) {
+          bytes_read += socket.read_some(boost::asio::buffer(buffer), error);
+        }
+        RAY_CHECK(bytes_read == total_bytes);
+      },
+      std::move(receiver));
+
+  const double start_time = ThreadCpuTimeMs();
+  int num_sent = 0;
+  int num_completed = 0;
+  // Send one chunk at a time, as the object manager does on each connection.
+  std::function<void(const ray::Status &)> send_next = [&](const ray::Status &status) {
+    RAY_CHECK_OK(status);
+    if (num_sent == num_chunks) {
+      return;
+    }
+    num_sent++;
+    if (use_zero_copy) {
+      conn->WriteMessageWithBufferZeroCopyAsync(
+          0, header.size(), header.data(), boost::asio::buffer(chunk),
+          [&num_completed]() { num_completed++; }, send_next);
+    } else {
+      conn->WriteMessageWithBufferAsync(
+          0, header.size(), header.data(), boost::asio::buffer(chunk),
+          [&num_completed, &send_next](const ray::Status &status) {
+            num_completed++;
+            send_next(status);
+          });
+    }
+  };
+  send_next(ray::Status::OK());
+  io_service.run();
+  // The chunk must stay valid until the kernel no longer references it.
+  while (conn->ReapZeroCopyCompletions(/*timeout_ms=*/100) > 0) {
+  }
+  const double cpu_time_ms = ThreadCpuTimeMs() - start_time;
+  RAY_CHECK(num_completed == num_chunks);
+  receiver_thread.join();
+  return cpu_time_ms * (1 << 30) / total_bytes;
+}
+
+TEST(ObjectManagerSendBenchmark, DISABLED_TestSendCpuTimeWithZeroCopy) {
+  const double copy_cpu_ms = MeasureSendCpuTimePerGb(/*use_zero_copy=*/false);
+  const double zero_copy_cpu_ms = MeasureSendCpuTimePerGb(/*use_zero_copy=*/true);
+  if (zero_copy_cpu_ms < 0) {
+    RAY_LOG(INFO) << "Zero-copy writes are not supported, sender CPU time per GB: "
+                  << copy_cpu_ms << "ms";
+    return;
+  }
+  // Over loopback, the kernel still copies zero-copy data when it delivers it
+  // to the receiving socket, so this only measures the sender's share.
+  RAY_LOG(INFO) << "Sender CPU time per GB: copying writes " << copy_cpu_ms
+                << "ms, zero-copy writes " << zero_copy_cpu_ms << "ms";
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 
 #include "ray/object_manager/object_manager.h"
+#include "ray/util/util.h"
 
 namespace ray {
 
@@ -123,6 +124,7 @@ class TestObjectManagerBase : public ::testing::Test {
     om_config_1.max_receives = max_receives;
     om_config_1.object_chunk_size = object_chunk_size;
     om_config_1.push_timeout_ms = push_timeout_ms;
+    om_config_1.broadcast_fanout = 1;
     server1.reset(new MockServer(main_service, om_config_1, gcs_client_1));
 
     // start second server
@@ -135,6 +137,7 @@ class TestObjectManagerBase : public ::testing::Test {
     om_config_2.max_receives = max_receives;
     om_config_2.object_chunk_size = object_chunk_size;
     om_config_2.push_timeout_ms = push_timeout_ms;
+    om_config_2.broadcast_fanout = 0;
     server2.reset(new MockServer(main_service, om_config_2, gcs_client_2));
 
     // connect to stores.
@@ -459,6 +462,96 @@ class TestObjectManager : public TestObjectManagerBase {
     RAY_LOG(DEBUG) << "Server 2 ClientPort=" << data2.node_manager_port;
     ASSERT_EQ(client_id_2, ClientID::from_binary(data2.client_id));
   }
+
+  /// Start a striped pull of an object on server 1 that requests one stripe
+  /// from each source. The requests fail to be sent, since the sources are
+  /// not in the client table.
+  ///
+  /// \param object_id The object to pull.
+  /// \param sources The sources, in the order of their stripes.
+  /// \param client_locations The other locations of the object.
+  /// \return The pull request.
+  ObjectManager::PullRequest &StartStripedPull(
+      const ObjectID &object_id, const std::vector<ClientID> &sources,
+      const std::vector<ClientID> &client_locations) {
+    ObjectManager &object_manager = server1->object_manager_;
+    auto &pull_request = object_manager.pull_requests_[object_id];
+    pull_request.client_locations = client_locations;
+    pull_request.striped_pull.reset(new ObjectManager::StripedPull(sources.size()));
+    for (size_t stripe_index = 0; stripe_index < sources.size(); stripe_index++) {
+      pull_request.striped_pull->sources[sources[stripe_index]] = {
+          static_cast<int64_t>(stripe_index), {}, false};
+    }
+    object_manager.SetStripedPullTimer(object_id);
+    return pull_request;
+  }
+
+  /// Receive a chunk of an object on server 1, as if it was sent by a source
+  /// of the object's striped pull.
+  void ReceiveChunk(const ObjectID &object_id, const ClientID &client_id,
+                    uint64_t chunk_index, uint64_t data_size, uint64_t metadata_size) {
+    ObjectManager &object_manager = server1->object_manager_;
+    ASSERT_TRUE(object_manager.buffer_pool_
+                    .CreateChunk(object_id, data_size, metadata_size, chunk_index)
+                    .second.ok());
+    object_manager.buffer_pool_.SealChunk(object_id, chunk_index);
+    object_manager.HandlePullChunkReceived(object_id, client_id, chunk_index, data_size,
+                                           metadata_size);
+  }
+
+  /// Check the sources of a striped pull on server 1 for stalls, as if its
+  /// timer fired.
+  void CheckStripedPull(const ObjectID &object_id) {
+    server1->object_manager_.CheckStripedPull(object_id);
+  }
+
+  /// Ask server 1 whether to forward a pull of an object that it holds, as if
+  /// it last served the object directly just now. Server 1 serves an object to
+  /// one node at a time.
+  bool RedirectPull(const ObjectID &object_id, const ClientID &requester_id,
+                    uint64_t num_forwards) {
+    ObjectManager &object_manager = server1->object_manager_;
+    object_manager.broadcast_states_[object_id].last_served_ms = current_time_ms();
+    return object_manager.RedirectPull(object_id, requester_id, /*num_stripes=*/1,
+                                       /*stripe_index=*/0, {}, num_forwards);
+  }
+
+  /// \return The objects whose pull requests are waiting to be sent from
+  /// server 1 to a remote object manager.
+  std::vector<ObjectID> GetQueuedPullRequests(const ClientID &client_id) {
+    return server1->object_manager_.queued_pull_requests_[client_id];
+  }
+
+  /// Check that server 2 sees server 1 as a partial holder of an object while
+  /// server 1 pulls it, and no longer once server 1 cancels the pull.
+  void TestCancelPartialPull() {
+    ObjectManager &object_manager = server1->object_manager_;
+    const ClientID client_id = gcs_client_1->client_table().GetLocalClientId();
+    const ObjectID object_id = ObjectID::from_random();
+    const uint64_t metadata_size = 1;
+    const uint64_t data_size = 2 * object_chunk_size;
+    RAY_CHECK_OK(object_manager.Pull(object_id));
+    ReceiveChunk(object_id, ClientID::from_random(), 0, data_size, metadata_size);
+    ASSERT_EQ(object_manager.partial_objects_.count(object_id), 1u);
+
+    RAY_CHECK_OK(server2->object_manager_.object_directory_->SubscribeObjectLocations(
+        UniqueID::from_random(), object_id,
+        [this, &object_manager, client_id](const std::vector<ClientID> &client_ids,
+                                          const ObjectID &object_id) {
+          ASSERT_TRUE(client_ids.empty());
+          std::vector<ClientID> partial_client_ids;
+          server2->object_manager_.object_directory_->GetCachedPartialLocations(
+              object_id, &partial_client_ids);
+          if (object_manager.pull_requests_.count(object_id) != 0) {
+            if (partial_client_ids == std::vector<ClientID>({client_id})) {
+              object_manager.CancelPull(object_id);
+              ASSERT_EQ(object_manager.partial_objects_.count(object_id), 0u);
+            }
+          } else if (partial_client_ids.empty()) {
+            main_service.stop();
+          }
+        }));
+  }
 };
 
 TEST_F(TestObjectManager, StartTestObjectManager) {
@@ -467,6 +560,204 @@ TEST_F(TestObjectManager, StartTestObjectManager) {
   main_service.run();
 }
 
+TEST_F(TestObjectManager, TestCancelPullRemovesPartialHolder) {
+  auto AsyncStartTests = main_service.wrap([this]() { TestCancelPartialPull(); });
+  AsyncStartTests();
+  main_service.run();
+}
+
+TEST_F(TestObjectManager, TestBufferPoolMissingChunks) {
+  ObjectBufferPool buffer_pool(store_id_1, object_chunk_size,
+                               plasma::kPlasmaDefaultReleaseDelay);
+  ObjectID object_id = ObjectID::from_random();
+  const uint64_t metadata_size = 1;
+  const uint64_t data_size = 4 * object_chunk_size;
+  uint64_t num_chunks;
+  std::vector<uint64_t> missing_chunks;
+  ASSERT_FALSE(buffer_pool.GetMissingChunks(object_id, &num_chunks, &missing_chunks));
+
+  // Failing to receive the only chunk that is being received aborts the
+  // object's creation.
+  ASSERT_TRUE(
+      buffer_pool.CreateChunk(object_id, data_size, metadata_size, 1).second.ok());
+  ASSERT_TRUE(buffer_pool.AbortCreateChunk(object_id, 1));
+  ASSERT_FALSE(buffer_pool.GetMissingChunks(object_id, &num_chunks, &missing_chunks));
+
+  // Receive chunk 0, and fail to receive chunk 2.
+  ASSERT_TRUE(
+      buffer_pool.CreateChunk(object_id, data_size, metadata_size, 0).second.ok());
+  buffer_pool.SealChunk(object_id, 0);
+  ASSERT_TRUE(
+      buffer_pool.CreateChunk(object_id, data_size, metadata_size, 2).second.ok());
+  ASSERT_FALSE(buffer_pool.AbortCreateChunk(object_id, 2));
+  ASSERT_TRUE(buffer_pool.GetMissingChunks(object_id, &num_chunks, &missing_chunks));
+  ASSERT_EQ(num_chunks, 4u);
+  ASSERT_EQ(missing_chunks, std::vector<uint64_t>({1, 2, 3}));
+
+  // Receive the missing chunks. The object is sealed once all are received.
+  for (uint64_t chunk_index : {1, 2, 3}) {
+    ASSERT_TRUE(buffer_pool.CreateChunk(object_id, data_size, metadata_size, chunk_index)
+                    .second.ok());
+    buffer_pool.SealChunk(object_id, chunk_index);
+  }
+  ASSERT_FALSE(buffer_pool.GetMissingChunks(object_id, &num_chunks, &missing_chunks));
+  bool has_object;
+  ARROW_CHECK_OK(client1.Contains(object_id.to_plasma_id(), &has_object));
+  ASSERT_TRUE(has_object);
+}
+
+TEST_F(TestObjectManager, TestBufferPoolRelayChunks) {
+  ObjectBufferPool buffer_pool(store_id_1, object_chunk_size,
+                               plasma::kPlasmaDefaultReleaseDelay);
+  ObjectID object_id = ObjectID::from_random();
+  const uint64_t metadata_size = 1;
+  const uint64_t data_size = 2 * object_chunk_size;
+
+  // A chunk of an object that is being received can be read once it is sealed.
+  ASSERT_TRUE(
+      buffer_pool.CreateChunk(object_id, data_size, metadata_size, 0).second.ok());
+  ASSERT_FALSE(buffer_pool.GetChunk(object_id, data_size, metadata_size, 0).second.ok());
+  buffer_pool.SealChunk(object_id, 0);
+  ASSERT_TRUE(buffer_pool.GetChunk(object_id, data_size, metadata_size, 0).second.ok());
+  ASSERT_FALSE(buffer_pool.GetChunk(object_id, data_size, metadata_size, 1).second.ok());
+  uint64_t relayed_data_size;
+  uint64_t relayed_metadata_size;
+  ASSERT_TRUE(
+      buffer_pool.GetCreateSizes(object_id, &relayed_data_size, &relayed_metadata_size));
+  ASSERT_EQ(relayed_data_size, data_size);
+  ASSERT_EQ(relayed_metadata_size, metadata_size);
+
+  // The object is sealed while the chunk is being read, and the chunk stays
+  // readable until it is released.
+  ASSERT_TRUE(
+      buffer_pool.CreateChunk(object_id, data_size, metadata_size, 1).second.ok());
+  buffer_pool.SealChunk(object_id, 1);
+  bool has_object;
+  ARROW_CHECK_OK(client1.Contains(object_id.to_plasma_id(), &has_object));
+  ASSERT_TRUE(has_object);
+  ASSERT_FALSE(
+      buffer_pool.GetCreateSizes(object_id, &relayed_data_size, &relayed_metadata_size));
+  buffer_pool.ReleaseGetChunk(object_id, 0);
+
+  // Once released, the chunks are read from the sealed object.
+  ASSERT_TRUE(buffer_pool.GetChunk(object_id, data_size, metadata_size, 1).second.ok());
+  buffer_pool.ReleaseGetChunk(object_id, 1);
+}
+
+TEST(ObjectManagerTest, TestStripeRanges) {
+  // The first chunks are spread over the stripes when the number of chunks is
+  // not divisible by the number of stripes.
+  ASSERT_EQ(GetStripeRange(10, 3, 0), std::pair<uint64_t, uint64_t>(0, 3));
+  ASSERT_EQ(GetStripeRange(10, 3, 1), std::pair<uint64_t, uint64_t>(3, 6));
+  ASSERT_EQ(GetStripeRange(10, 3, 2), std::pair<uint64_t, uint64_t>(6, 10));
+
+  // A striped pull uses at most one stripe per chunk.
+  for (uint64_t num_stripes = 1; num_stripes <= 8; num_stripes++) {
+    for (uint64_t num_chunks = num_stripes; num_chunks <= 64; num_chunks++) {
+      // The stripes are contiguous, disjoint and non-empty, they differ in size
+      // by at most one chunk, and together they cover all of the chunks.
+      uint64_t next_chunk = 0;
+      for (uint64_t stripe_index = 0; stripe_index < num_stripes; stripe_index++) {
+        auto range = GetStripeRange(num_chunks, num_stripes, stripe_index);
+        ASSERT_EQ(range.first, next_chunk);
+        ASSERT_GE(range.second - range.first, num_chunks / num_stripes);
+        ASSERT_LE(range.second - range.first,
+                  (num_chunks + num_stripes - 1) / num_stripes);
+        ASSERT_GT(range.second, range.first);
+        next_chunk = range.second;
+      }
+      ASSERT_EQ(next_chunk, num_chunks);
+    }
+  }
+}
+
+TEST_F(TestObjectManager, TestStripedPullReroutesStalledSources) {
+  const ObjectID object_id = ObjectID::from_random();
+  const uint64_t metadata_size = 1;
+  const uint64_t data_size = 4 * object_chunk_size;
+  const ClientID source_1 = ClientID::from_random();
+  const ClientID source_2 = ClientID::from_random();
+  const ClientID other_location = ClientID::from_random();
+  auto &pull_request = StartStripedPull(object_id, {source_1, source_2}, {other_location});
+  auto &sources = pull_request.striped_pull->sources;
+
+  // Source 1 owes chunks 0 and 1 and sends chunk 0. Source 2 owes chunks 2 and
+  // 3 and sends nothing, so its chunks are re-routed to source 1.
+  ReceiveChunk(object_id, source_1, 0, data_size, metadata_size);
+  CheckStripedPull(object_id);
+  ASSERT_EQ(pull_request.striped_pull->num_chunks, 4u);
+  ASSERT_EQ(sources.size(), 1u);
+  ASSERT_EQ(sources.at(source_1).stripe_index, 0);
+  ASSERT_EQ(sources.at(source_1).chunk_indices, std::vector<uint64_t>({2, 3}));
+  ASSERT_FALSE(sources.at(source_1).made_progress);
+  ASSERT_TRUE(pull_request.timer_set);
+
+  // A source that makes progress is not re-routed, even if it still owes
+  // chunks.
+  ReceiveChunk(object_id, source_1, 2, data_size, metadata_size);
+  CheckStripedPull(object_id);
+  ASSERT_EQ(sources.size(), 1u);
+  ASSERT_EQ(sources.count(source_1), 1u);
+
+  // Once every source stalls, its missing chunks are re-routed to the other
+  // locations of the object.
+  CheckStripedPull(object_id);
+  ASSERT_EQ(sources.size(), 1u);
+  ASSERT_EQ(sources.at(other_location).stripe_index, -1);
+  ASSERT_EQ(sources.at(other_location).chunk_indices, std::vector<uint64_t>({1, 3}));
+
+  // With no other locations left, the chunks are requested from the stalled
+  // sources again.
+  pull_request.client_locations.clear();
+  CheckStripedPull(object_id);
+  ASSERT_EQ(sources.size(), 1u);
+  ASSERT_EQ(sources.at(other_location).chunk_indices, std::vector<uint64_t>({1, 3}));
+  ASSERT_TRUE(pull_request.timer_set);
+}
+
+TEST_F(TestObjectManager, TestStripedPullFallsBackToPull) {
+  const ObjectID object_id = ObjectID::from_random();
+  const ClientID location_1 = ClientID::from_random();
+  const ClientID location_2 = ClientID::from_random();
+  auto &pull_request =
+      StartStripedPull(object_id, {ClientID::from_random(), ClientID::from_random()},
+                       {location_1, location_2});
+
+  // No source sent a chunk before the check, so the chunks cannot be
+  // re-routed. The object is pulled whole from one location at a time, with a
+  // timer set to try the next one.
+  CheckStripedPull(object_id);
+  ASSERT_TRUE(pull_request.striped_pull == nullptr);
+  ASSERT_EQ(GetQueuedPullRequests(location_2), std::vector<ObjectID>({object_id}));
+  ASSERT_EQ(pull_request.client_locations, std::vector<ClientID>({location_1}));
+  ASSERT_TRUE(pull_request.timer_set);
+
+  // With no other locations to fall back to, the pull waits for new
+  // locations of the object.
+  const ObjectID other_object_id = ObjectID::from_random();
+  auto &other_pull_request = StartStripedPull(
+      other_object_id, {ClientID::from_random(), ClientID::from_random()}, {});
+  CheckStripedPull(other_object_id);
+  ASSERT_TRUE(other_pull_request.striped_pull == nullptr);
+  ASSERT_FALSE(other_pull_request.timer_set);
+}
+
+TEST_F(TestObjectManager, TestRedirectPullBoundsForwards) {
+  const ObjectID object_id = ObjectID::from_random();
+  const ClientID child_id = ClientID::from_random();
+  const ClientID requester_id = ClientID::from_random();
+  const uint64_t max_forwards = RayConfig::instance().object_manager_max_pull_forwards();
+
+  // The first requester is served directly, and so is its next request.
+  ASSERT_FALSE(RedirectPull(object_id, child_id, 0));
+  ASSERT_FALSE(RedirectPull(object_id, child_id, max_forwards - 1));
+
+  // Other requests are forwarded to it until they were forwarded too often.
+  ASSERT_TRUE(RedirectPull(object_id, requester_id, 0));
+  ASSERT_TRUE(RedirectPull(object_id, requester_id, max_forwards - 1));
+  ASSERT_FALSE(RedirectPull(object_id, requester_id, max_forwards));
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
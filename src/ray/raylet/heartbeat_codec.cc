@@ -0,0 +1,147 @@
+#include "ray/raylet/heartbeat_codec.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+HeartbeatEncoder::HeartbeatEncoder(int64_t full_heartbeat_period)
+    : full_heartbeat_period_(full_heartbeat_period), num_heartbeats_(0) {
+  RAY_CHECK(full_heartbeat_period_ > 0);
+}
+
+void HeartbeatEncoder::Encode(const SchedulingResources &resources,
+                              HeartbeatTableDataT *heartbeat_data) {
+  const bool is_full = num_heartbeats_ % full_heartbeat_period_ == 0;
+  num_heartbeats_++;
+  if (is_full) {
+    announced_resource_ids_.clear();
+  }
+  heartbeat_data->is_full = is_full;
+
+  // Full heartbeats also carry the labels of the resources, so that readers
+  // that do not track resource IDs can use them.
+  const auto &available_resources = resources.GetAvailableResources();
+  const auto &load_resources = resources.GetLoadResources();
+  if (!is_full && available_resources.IsEqual(last_available_resources_) &&
+      load_resources.IsEqual(last_load_resources_)) {
+    heartbeat_data->resources_unchanged = true;
+  } else {
+    AppendResources(available_resources, &heartbeat_data->resources_available_id,
+                    &heartbeat_data->resources_available_capacity,
+                    is_full ? &heartbeat_data->resources_available_label : nullptr,
+                    heartbeat_data);
+    AppendResources(load_resources, &heartbeat_data->resource_load_id,
+                    &heartbeat_data->resource_load_capacity,
+                    is_full ? &heartbeat_data->resource_load_label : nullptr,
+                    heartbeat_data);
+    last_available_resources_ = available_resources;
+    last_load_resources_ = load_resources;
+  }
+
+  const auto &total_resources = resources.GetTotalResources();
+  if (is_full || !total_resources.IsEqual(last_total_resources_)) {
+    AppendResources(total_resources, &heartbeat_data->resources_total_id,
+                    &heartbeat_data->resources_total_capacity,
+                    is_full ? &heartbeat_data->resources_total_label : nullptr,
+                    heartbeat_data);
+    last_total_resources_ = total_resources;
+  }
+}
+
+void HeartbeatEncoder::AppendResources(const ResourceSet &resource_set,
+                                       std::vector<int32_t> *resource_ids,
+                                       std::vector<double> *resource_capacity,
+                                       std::vector<std::string> *resource_labels,
+                                       HeartbeatTableDataT *heartbeat_data) {
+  std::vector<int64_t> ids;
+  resource_set.GetResourceIds(&ids, resource_capacity);
+  for (const int64_t resource_id : ids) {
+    resource_ids->push_back(resource_id);
+    if (resource_labels != nullptr) {
+      resource_labels->push_back(ResourceLabelTable::instance().GetLabel(resource_id));
+    }
+    if (announced_resource_ids_.insert(resource_id).second) {
+      heartbeat_data->resource_label_id.push_back(resource_id);
+      heartbeat_data->resource_label.push_back(
+          ResourceLabelTable::instance().GetLabel(resource_id));
+    }
+  }
+}
+
+HeartbeatDecoder::HeartbeatDecoder() : synced_(false) {}
+
+bool HeartbeatDecoder::Decode(const HeartbeatTableDataT &heartbeat_data) {
+  if (heartbeat_data.is_full) {
+    resource_ids_.clear();
+    synced_ = true;
+  } else if (!synced_) {
+    return false;
+  }
+
+  RAY_CHECK(heartbeat_data.resource_label_id.size() ==
+            heartbeat_data.resource_label.size());
+  for (size_t i = 0; i < heartbeat_data.resource_label_id.size(); i++) {
+    resource_ids_[heartbeat_data.resource_label_id[i]] =
+        ResourceLabelTable::instance().GetOrAddId(heartbeat_data.resource_label[i]);
+  }
+
+  if (!heartbeat_data.resources_unchanged) {
+    ResourceSet available_resources;
+    ResourceSet load_resources;
+    if (!DecodeResources(heartbeat_data.resources_available_id,
+                         heartbeat_data.resources_available_capacity,
+                         &available_resources) ||
+        !DecodeResources(heartbeat_data.resource_load_id,
+                         heartbeat_data.resource_load_capacity, &load_resources)) {
+      // A label announcement was missed.
+      synced_ = false;
+      return false;
+    }
+    available_resources_ = std::move(available_resources);
+    load_resources_ = std::move(load_resources);
+  }
+
+  if (heartbeat_data.is_full || !heartbeat_data.resources_total_id.empty()) {
+    ResourceSet total_resources;
+    if (!DecodeResources(heartbeat_data.resources_total_id,
+                         heartbeat_data.resources_total_capacity, &total_resources)) {
+      synced_ = false;
+      return false;
+    }
+    total_resources_ = std::move(total_resources);
+  }
+  return true;
+}
+
+bool HeartbeatDecoder::DecodeResources(const std::vector<int32_t> &resource_ids,
+                                       const std::vector<double> &resource_capacity,
+                                       ResourceSet *resource_set) const {
+  RAY_CHECK(resource_ids.size() == resource_capacity.size());
+  std::vector<int64_t> local_ids;
+  local_ids.reserve(resource_ids.size());
+  for (const int32_t resource_id : resource_ids) {
+    auto it = resource_ids_.find(resource_id);
+    if (it == resource_ids_.end()) {
+      return false;
+    }
+    local_ids.push_back(it->second);
+  }
+  *resource_set = ResourceSet(local_ids, resource_capacity);
+  return true;
+}
+
+const ResourceSet &HeartbeatDecoder::GetAvailableResources() const {
+  return available_resources_;
+}
+
+const ResourceSet &HeartbeatDecoder::GetTotalResources() const {
+  return total_resources_;
+}
+
+const ResourceSet &HeartbeatDecoder::GetLoadResources() const { return load_resources_; }
+
+}  // namespace raylet
+
+}  // namespace ray
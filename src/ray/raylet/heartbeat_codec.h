@@ -0,0 +1,121 @@
+#ifndef RAY_RAYLET_HEARTBEAT_CODEC_H
+#define RAY_RAYLET_HEARTBEAT_CODEC_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ray/gcs/format/gcs_generated.h"
+#include "ray/raylet/scheduling_resources.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class HeartbeatEncoder
+///
+/// Encodes the resources of the local node manager into heartbeats. Resources
+/// are sent by their interned IDs, the total resources are only sent when they
+/// change, and a heartbeat whose available resources and load did not change
+/// only carries a flag. Periodically, a full heartbeat with all resources and
+/// their labels is sent, so that receivers recover from missed heartbeats.
+class HeartbeatEncoder {
+ public:
+  /// Create a heartbeat encoder.
+  ///
+  /// \param full_heartbeat_period Send a full heartbeat every this many
+  /// heartbeats. If this is 1, every heartbeat is a full heartbeat.
+  HeartbeatEncoder(int64_t full_heartbeat_period);
+
+  /// Fill in the resource fields of the next heartbeat.
+  ///
+  /// \param resources The current resources of the local node manager.
+  /// \param[out] heartbeat_data The heartbeat to fill in.
+  /// \return Void.
+  void Encode(const SchedulingResources &resources, HeartbeatTableDataT *heartbeat_data);
+
+ private:
+  /// Append a resource set to a heartbeat, announcing the labels of the
+  /// resource IDs that have not been sent since the last full heartbeat.
+  ///
+  /// \param resource_set The resources to append.
+  /// \param[out] resource_ids The heartbeat field to append the IDs to.
+  /// \param[out] resource_capacity The heartbeat field to append the
+  /// capacities to.
+  /// \param[out] resource_labels The heartbeat field to append the labels to,
+  /// or nullptr if the labels should not be sent.
+  /// \param[out] heartbeat_data The heartbeat whose label announcements to
+  /// append to.
+  /// \return Void.
+  void AppendResources(const ResourceSet &resource_set,
+                       std::vector<int32_t> *resource_ids,
+                       std::vector<double> *resource_capacity,
+                       std::vector<std::string> *resource_labels,
+                       HeartbeatTableDataT *heartbeat_data);
+
+  /// The number of heartbeats between full heartbeats.
+  const int64_t full_heartbeat_period_;
+  /// The number of heartbeats encoded so far.
+  int64_t num_heartbeats_;
+  /// The resources sent in previous heartbeats.
+  ResourceSet last_available_resources_;
+  ResourceSet last_total_resources_;
+  ResourceSet last_load_resources_;
+  /// The IDs of the resources whose labels were sent since the last full
+  /// heartbeat.
+  std::unordered_set<int64_t> announced_resource_ids_;
+};
+
+/// \class HeartbeatDecoder
+///
+/// Decodes the heartbeats of a remote node manager and keeps the resources
+/// they describe.
+class HeartbeatDecoder {
+ public:
+  /// Create a heartbeat decoder. No heartbeats can be decoded until the first
+  /// full heartbeat is received.
+  HeartbeatDecoder();
+
+  /// Decode a heartbeat.
+  ///
+  /// \param heartbeat_data The heartbeat to decode.
+  /// \return True if the resources were updated. False if the heartbeat
+  /// depends on a heartbeat that was missed. In that case, the resources are
+  /// not updated again until the next full heartbeat.
+  bool Decode(const HeartbeatTableDataT &heartbeat_data);
+
+  /// \return The available resources from the last decoded heartbeat.
+  const ResourceSet &GetAvailableResources() const;
+
+  /// \return The total resources from the last decoded heartbeat.
+  const ResourceSet &GetTotalResources() const;
+
+  /// \return The resource load from the last decoded heartbeat.
+  const ResourceSet &GetLoadResources() const;
+
+ private:
+  /// Translate resources from the remote node manager's IDs to a ResourceSet.
+  ///
+  /// \param resource_ids The remote IDs of the resources.
+  /// \param resource_capacity The capacities of the resources.
+  /// \param[out] resource_set The decoded resources.
+  /// \return True if all of the remote IDs are known and false otherwise.
+  bool DecodeResources(const std::vector<int32_t> &resource_ids,
+                       const std::vector<double> &resource_capacity,
+                       ResourceSet *resource_set) const;
+
+  /// Whether a full heartbeat was received and no heartbeats were missed since.
+  bool synced_;
+  /// A map from the remote node manager's resource IDs to the local IDs.
+  std::unordered_map<int64_t, int64_t> resource_ids_;
+  /// The resources from the last decoded heartbeat.
+  ResourceSet available_resources_;
+  ResourceSet total_resources_;
+  ResourceSet load_resources_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // RAY_RAYLET_HEARTBEAT_CODEC_H
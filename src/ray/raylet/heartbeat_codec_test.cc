@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include "ray/raylet/heartbeat_codec.h"
+
+namespace ray {
+
+namespace raylet {
+
+static inline ResourceSet MakeResourceSet(
+    const std::unordered_map<std::string, double> &resource_map) {
+  return ResourceSet(resource_map);
+}
+
+TEST(HeartbeatCodecTest, TestDeltaHeartbeats) {
+  HeartbeatEncoder encoder(3);
+  HeartbeatDecoder decoder;
+  SchedulingResources resources(MakeResourceSet({{"CPU", 4}, {"custom", 2}}));
+  resources.SetLoadResources(MakeResourceSet({{"CPU", 1}}));
+
+  // The first heartbeat is full and carries every resource and label.
+  HeartbeatTableDataT full_heartbeat;
+  encoder.Encode(resources, &full_heartbeat);
+  ASSERT_TRUE(full_heartbeat.is_full);
+  ASSERT_EQ(full_heartbeat.resources_available_label.size(), 2u);
+  ASSERT_EQ(full_heartbeat.resource_label.size(), 2u);
+  ASSERT_TRUE(decoder.Decode(full_heartbeat));
+  ASSERT_TRUE(decoder.GetAvailableResources().IsEqual(resources.GetAvailableResources()));
+  ASSERT_TRUE(decoder.GetTotalResources().IsEqual(resources.GetTotalResources()));
+  ASSERT_TRUE(decoder.GetLoadResources().IsEqual(resources.GetLoadResources()));
+
+  // Nothing changed, so the next heartbeat only carries a flag.
+  HeartbeatTableDataT unchanged_heartbeat;
+  encoder.Encode(resources, &unchanged_heartbeat);
+  ASSERT_FALSE(unchanged_heartbeat.is_full);
+  ASSERT_TRUE(unchanged_heartbeat.resources_unchanged);
+  ASSERT_TRUE(unchanged_heartbeat.resources_available_id.empty());
+  ASSERT_TRUE(unchanged_heartbeat.resources_total_id.empty());
+  ASSERT_TRUE(unchanged_heartbeat.resource_label.empty());
+  ASSERT_TRUE(decoder.Decode(unchanged_heartbeat));
+  ASSERT_TRUE(decoder.GetLoadResources().IsEqual(resources.GetLoadResources()));
+
+  // A change sends the available resources and load by ID, announcing only
+  // the new label.
+  resources.Acquire(MakeResourceSet({{"CPU", 1}}));
+  resources.SetLoadResources(MakeResourceSet({{"CPU", 1}, {"new_label", 1}}));
+  HeartbeatTableDataT changed_heartbeat;
+  encoder.Encode(resources, &changed_heartbeat);
+  ASSERT_FALSE(changed_heartbeat.resources_unchanged);
+  ASSERT_TRUE(changed_heartbeat.resources_available_label.empty());
+  ASSERT_TRUE(changed_heartbeat.resources_total_id.empty());
+  ASSERT_EQ(changed_heartbeat.resource_label,
+            std::vector<std::string>({std::string("new_label")}));
+  ASSERT_TRUE(decoder.Decode(changed_heartbeat));
+  ASSERT_TRUE(decoder.GetAvailableResources().IsEqual(resources.GetAvailableResources()));
+  ASSERT_TRUE(decoder.GetLoadResources().IsEqual(resources.GetLoadResources()));
+
+  // The period is 3, so the fourth heartbeat is full again.
+  HeartbeatTableDataT resync_heartbeat;
+  encoder.Encode(resources, &resync_heartbeat);
+  ASSERT_TRUE(resync_heartbeat.is_full);
+  ASSERT_FALSE(resync_heartbeat.resources_total_id.empty());
+  ASSERT_EQ(resync_heartbeat.resource_label.size(), 3u);
+}
+
+TEST(HeartbeatCodecTest, TestMissedHeartbeat) {
+  HeartbeatEncoder encoder(3);
+  SchedulingResources resources(MakeResourceSet({{"CPU", 4}}));
+  HeartbeatTableDataT full_heartbeat;
+  encoder.Encode(resources, &full_heartbeat);
+
+  // A decoder that misses the full heartbeat cannot decode the deltas.
+  HeartbeatDecoder decoder;
+  resources.SetLoadResources(MakeResourceSet({{"CPU", 2}, {"missed_label", 1}}));
+  HeartbeatTableDataT missed_heartbeat;
+  encoder.Encode(resources, &missed_heartbeat);
+  ASSERT_FALSE(decoder.Decode(missed_heartbeat));
+
+  // A decoder that misses a label announcement waits for the next full
+  // heartbeat.
+  HeartbeatDecoder resynced_decoder;
+  ASSERT_TRUE(resynced_decoder.Decode(full_heartbeat));
+  resources.SetLoadResources(MakeResourceSet({{"missed_label", 2}}));
+  HeartbeatTableDataT delta_heartbeat;
+  encoder.Encode(resources, &delta_heartbeat);
+  ASSERT_TRUE(delta_heartbeat.resource_label.empty());
+  ASSERT_FALSE(resynced_decoder.Decode(delta_heartbeat));
+
+  HeartbeatTableDataT resync_heartbeat;
+  encoder.Encode(resources, &resync_heartbeat);
+  ASSERT_TRUE(resync_heartbeat.is_full);
+  ASSERT_TRUE(resynced_decoder.Decode(resync_heartbeat));
+  ASSERT_TRUE(
+      resynced_decoder.GetLoadResources().IsEqual(resources.GetLoadResources()));
+}
+
+}  // namespace raylet
+
+}  // namespace ray
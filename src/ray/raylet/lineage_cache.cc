@@ -69,6 +69,15 @@ Lineage::Lineage(const protocol::ForwardTaskRequest &task_request) {
   }
 }
 
+Lineage::Lineage(const protocol::ForwardTaskBatchRequest &task_batch_request) {
+  // Deserialize and set entries for the uncommitted tasks.
+  auto tasks = task_batch_request.uncommitted_tasks();
+  for (auto it = tasks->begin(); it != tasks->end(); it++) {
+    const auto &task = **it;
+    RAY_CHECK(SetEntry(task, GcsStatus::UNCOMMITTED_REMOTE));
+  }
+}
+
 boost::optional<const LineageEntry &> Lineage::GetEntry(const TaskID &task_id) const {
   auto entry = entries_.find(task_id);
   if (entry != entries_.end()) {
@@ -135,6 +144,22 @@ flatbuffers::Offset<protocol::ForwardTaskRequest> Lineage::ToFlatbuffer(
   return request;
 }
 
+flatbuffers::Offset<protocol::ForwardTaskBatchRequest> Lineage::ToFlatbuffer(
+    flatbuffers::FlatBufferBuilder &fbb, const std::vector<TaskID> &task_ids) const {
+  for (const auto &task_id : task_ids) {
+    RAY_CHECK(GetEntry(task_id));
+  }
+  // Serialize the task and object entries.
+  std::vector<flatbuffers::Offset<protocol::Task>> uncommitted_tasks;
+  for (const auto &entry : entries_) {
+    uncommitted_tasks.push_back(entry.second.TaskData().ToFlatbuffer(fbb));
+  }
+
+  auto request = protocol::CreateForwardTaskBatchRequest(
+      fbb, to_flatbuf(fbb, task_ids), fbb.CreateVector(uncommitted_tasks));
+  return request;
+}
+
 LineageCache::LineageCache(const ClientID &client_id,
                            gcs::TableInterface<TaskID, protocol::Task> &task_storage,
                            gcs::PubsubInterface<TaskID> &task_pubsub,
@@ -334,6 +359,26 @@ Lineage LineageCache::GetUncommittedLineage(const TaskID &task_id,
   return uncommitted_lineage;
 }
 
+Lineage LineageCache::GetUncommittedLineage(const std::vector<TaskID> &task_ids,
+                                            const ClientID &node_id) const {
+  Lineage uncommitted_lineage;
+  for (const auto &task_id : task_ids) {
+    // Add all uncommitted ancestors of the task. The DFS stops at entries that
+    // are already in the union, so shared ancestors are only visited once.
+    MergeLineageHelper(
+        task_id, lineage_, uncommitted_lineage, [&](const LineageEntry &entry) {
+          return entry.WasExplicitlyForwarded(node_id);
+        });
+    // The lineage always includes the requested tasks.
+    if (!uncommitted_lineage.GetEntry(task_id)) {
+      auto entry = lineage_.GetEntry(task_id);
+      RAY_CHECK(entry);
+      RAY_CHECK(uncommitted_lineage.SetEntry(entry->TaskData(), entry->GetStatus()));
+    }
+  }
+  return uncommitted_lineage;
+}
+
 bool LineageCache::FlushTask(const TaskID &task_id) {
   auto entry = lineage_.GetEntry(task_id);
   RAY_CHECK(entry);
@@ -137,6 +137,12 @@ class Lineage {
   /// uncommitted tasks in the request will be added to the lineage.
   Lineage(const protocol::ForwardTaskRequest &task_request);
 
+  /// Construct a Lineage from a ForwardTaskBatchRequest.
+  ///
+  /// \param task_batch_request The request to construct the lineage from. All
+  /// uncommitted tasks in the request will be added to the lineage.
+  Lineage(const protocol::ForwardTaskBatchRequest &task_batch_request);
+
   /// Get an entry from the lineage.
   ///
   /// \param entry_id The ID of the entry to get.
@@ -176,6 +182,15 @@ class Lineage {
   flatbuffers::Offset<protocol::ForwardTaskRequest> ToFlatbuffer(
       flatbuffers::FlatBufferBuilder &fbb, const TaskID &entry_id) const;
 
+  /// Serialize this lineage to a ForwardTaskBatchRequest flatbuffer.
+  ///
+  /// \param entry_ids The task IDs to include in the ForwardTaskBatchRequest
+  /// flatbuffer. These must all be in the lineage.
+  /// \return An offset to the serialized lineage. The serialization includes
+  /// all task and object entries in the lineage.
+  flatbuffers::Offset<protocol::ForwardTaskBatchRequest> ToFlatbuffer(
+      flatbuffers::FlatBufferBuilder &fbb, const std::vector<TaskID> &entry_ids) const;
+
  private:
   /// The lineage entries.
   std::unordered_map<const TaskID, LineageEntry> entries_;
@@ -242,6 +257,17 @@ class LineageCache {
   /// includes the entry for the requested entry_id.
   Lineage GetUncommittedLineage(const TaskID &task_id, const ClientID &node_id) const;
 
+  /// Get the union of the uncommitted lineage of several tasks that haven't
+  /// been forwarded to a node yet. Each task in the union appears only once,
+  /// even if it is in the lineage of several of the given tasks.
+  ///
+  /// \param task_ids The IDs of the tasks to get the uncommitted lineage for.
+  /// \param node_id The ID of the receiving node.
+  /// \return The union of the uncommitted, unforwarded lineage of the tasks.
+  /// The returned lineage includes the entries for all of the requested tasks.
+  Lineage GetUncommittedLineage(const std::vector<TaskID> &task_ids,
+                                const ClientID &node_id) const;
+
   /// Asynchronously write any tasks that are in the UNCOMMITTED_READY state
   /// and for which all parents have been committed to the GCS. These tasks
   /// will be transitioned in this method to state COMMITTING. Once the write
@@ -336,6 +336,39 @@ TEST_F(LineageCacheTest, TestForwardTasksRoundTrip) {
   }
 }
 
+TEST_F(LineageCacheTest, TestForwardTaskBatchRoundTrip) {
+  // Insert a chain of dependent tasks.
+  std::vector<Task> tasks;
+  InsertTaskChain(lineage_cache_, tasks, 4, std::vector<ObjectID>(), 1);
+  std::vector<TaskID> task_ids;
+  for (const auto &task : tasks) {
+    task_ids.push_back(task.GetTaskSpecification().TaskId());
+  }
+
+  // Forward the last two tasks together. Their lineage overlaps, so the union
+  // should contain each task in the chain exactly once.
+  std::vector<TaskID> forwarded_task_ids = {task_ids[3], task_ids[2]};
+  auto uncommitted_lineage =
+      lineage_cache_.GetUncommittedLineage(forwarded_task_ids, ClientID::nil());
+  ASSERT_EQ(uncommitted_lineage.GetEntries().size(), tasks.size());
+  for (const auto &task_id : forwarded_task_ids) {
+    ASSERT_TRUE(lineage_cache_.RemoveWaitingTask(task_id));
+  }
+
+  // Simulate receiving the tasks again. Make sure we can add the tasks back.
+  flatbuffers::FlatBufferBuilder fbb;
+  auto uncommitted_lineage_message =
+      uncommitted_lineage.ToFlatbuffer(fbb, forwarded_task_ids);
+  fbb.Finish(uncommitted_lineage_message);
+  auto request =
+      flatbuffers::GetRoot<protocol::ForwardTaskBatchRequest>(fbb.GetBufferPointer());
+  ASSERT_EQ(from_flatbuf(*request->task_ids()), forwarded_task_ids);
+  uncommitted_lineage = Lineage(*request);
+  ASSERT_EQ(uncommitted_lineage.GetEntries().size(), tasks.size());
+  ASSERT_TRUE(lineage_cache_.AddWaitingTask(tasks[3], uncommitted_lineage));
+  ASSERT_TRUE(lineage_cache_.AddWaitingTask(tasks[2], uncommitted_lineage));
+}
+
 TEST_F(LineageCacheTest, TestForwardTask) {
   // Insert a chain of dependent tasks.
   size_t num_tasks_flushed = 0;
@@ -62,6 +62,10 @@ int main(int argc, char *argv[]) {
     node_manager_config.worker_commands.emplace(
         make_pair(Language::JAVA, parse_worker_command(java_worker_command)));
   }
+  if (!python_worker_command.empty() &&
+      RayConfig::instance().use_python_worker_fork_server()) {
+    node_manager_config.fork_server_languages.insert(Language::PYTHON);
+  }
   if (python_worker_command.empty() && java_worker_command.empty()) {
     RAY_CHECK(0)
         << "Either Python worker command or Java worker command should be provided.";
@@ -79,6 +83,8 @@ int main(int argc, char *argv[]) {
       RayConfig::instance().object_manager_pull_timeout_ms();
   object_manager_config.push_timeout_ms =
       RayConfig::instance().object_manager_push_timeout_ms();
+  object_manager_config.broadcast_fanout =
+      RayConfig::instance().object_manager_broadcast_fanout();
 
   int num_cpus = static_cast<int>(static_resource_conf["CPU"]);
   object_manager_config.max_sends = std::max(1, num_cpus / 4);
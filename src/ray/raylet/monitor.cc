@@ -9,7 +9,8 @@ namespace raylet {
 
 /// \class Monitor
 ///
-/// The monitor is responsible for listening for heartbeats from Raylets and
+/// The monitor is responsible for listening for heartbeats from Raylets,
+/// broadcasting them to the Raylets in one batch per heartbeat period, and
 /// deciding when a Raylet has died. If the monitor does not hear from a Raylet
 /// within heartbeat_timeout_milliseconds * num_heartbeats_timeout (defined in
 /// the Ray configuration), then the monitor will mark that Raylet as dead in
@@ -22,14 +23,16 @@ Monitor::Monitor(boost::asio::io_service &io_service, const std::string &redis_a
   RAY_CHECK_OK(gcs_client_.Attach(io_service));
 }
 
-void Monitor::HandleHeartbeat(const ClientID &client_id) {
+void Monitor::HandleHeartbeat(const ClientID &client_id,
+                              const HeartbeatTableDataT &heartbeat_data) {
   heartbeats_[client_id] = num_heartbeats_timeout_;
+  heartbeat_buffer_.push_back(heartbeat_data);
 }
 
 void Monitor::Start() {
   const auto heartbeat_callback = [this](gcs::AsyncGcsClient *client, const ClientID &id,
                                          const HeartbeatTableDataT &heartbeat_data) {
-    HandleHeartbeat(id);
+    HandleHeartbeat(id, heartbeat_data);
   };
   RAY_CHECK_OK(gcs_client_.heartbeat_table().Subscribe(
       UniqueID::nil(), UniqueID::nil(), heartbeat_callback, nullptr, nullptr));
@@ -65,6 +68,17 @@ void Monitor::Tick() {
     }
   }
 
+  // Publish the heartbeats received since the last tick as one batch.
+  if (!heartbeat_buffer_.empty()) {
+    auto batch = std::make_shared<HeartbeatBatchTableDataT>();
+    for (auto &heartbeat : heartbeat_buffer_) {
+      batch->batch.emplace_back(new HeartbeatTableDataT(std::move(heartbeat)));
+    }
+    heartbeat_buffer_.clear();
+    RAY_CHECK_OK(gcs_client_.heartbeat_batch_table().Add(UniqueID::nil(), UniqueID::nil(),
+                                                         batch, nullptr));
+  }
+
   auto heartbeat_period = boost::posix_time::milliseconds(
       RayConfig::instance().heartbeat_timeout_milliseconds());
   heartbeat_timer_.expires_from_now(heartbeat_period);
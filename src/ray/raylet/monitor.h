@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "ray/gcs/client.h"
 #include "ray/id.h"
@@ -27,13 +28,16 @@ class Monitor {
 
   /// A periodic timer that fires on every heartbeat period. Raylets that have
   /// not sent a heartbeat within the last num_heartbeats_timeout ticks will be
-  /// marked as dead in the client table.
+  /// marked as dead in the client table. The heartbeats received since the
+  /// last tick are published to the Raylets as a single batch.
   void Tick();
 
   /// Handle a heartbeat from a Raylet.
   ///
   /// \param client_id The client ID of the Raylet that sent the heartbeat.
-  void HandleHeartbeat(const ClientID &client_id);
+  /// \param heartbeat_data The heartbeat sent by the Raylet.
+  void HandleHeartbeat(const ClientID &client_id,
+                       const HeartbeatTableDataT &heartbeat_data);
 
  private:
   /// A client to the GCS, through which heartbeats are received.
@@ -47,6 +51,11 @@ class Monitor {
   std::unordered_map<ClientID, int64_t> heartbeats_;
   /// The Raylets that have been marked as dead in the client table.
   std::unordered_set<ClientID> dead_clients_;
+  /// The heartbeats received since the last tick, in the order that they were
+  /// received. Heartbeats may only describe what changed since the Raylet's
+  /// previous heartbeat, so all of them are kept instead of the latest per
+  /// Raylet.
+  std::vector<HeartbeatTableDataT> heartbeat_buffer_;
 };
 
 }  // namespace raylet
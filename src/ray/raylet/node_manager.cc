@@ -1,5 +1,7 @@
 #include "ray/raylet/node_manager.h"
 
+#include <algorithm>
+
 #include "common_protocol.h"
 // TODO: While removing "local_scheduler_generated.h", remove the dependency
 //       gen_local_scheduler_fbs from src/ray/CMakeLists.txt.
@@ -83,12 +85,30 @@ NodeManager::NodeManager(boost::asio::io_service &io_service,
       gcs_client_(gcs_client),
       heartbeat_timer_(io_service),
       heartbeat_period_(std::chrono::milliseconds(config.heartbeat_period_ms)),
+      schedule_tasks_pending_(false),
+      heartbeat_encoder_(RayConfig::instance().num_heartbeats_full_resync()),
       local_resources_(config.resource_config),
       local_available_resources_(config.resource_config),
       worker_pool_(config.num_initial_workers, config.num_workers_per_process,
-                   config.maximum_startup_concurrency, config.worker_commands),
+                   config.maximum_startup_concurrency, config.worker_commands,
+                   config.fork_server_languages),
+      worker_languages_(),
+      worker_pool_controller_(
+          config.num_initial_workers * config.num_workers_per_process,
+          config.maximum_startup_concurrency * config.num_workers_per_process,
+          RayConfig::instance().worker_pool_demand_smoothing()),
+      worker_pool_timer_(io_service),
       local_queues_(SchedulingQueue()),
-      scheduling_policy_(local_queues_),
+      scheduling_policy_(
+          local_queues_,
+          RayConfig::instance().locality_aware_scheduling()
+              ? ObjectLocationLookup([this](const ObjectID &object_id,
+                                            std::vector<ClientID> *client_ids,
+                                            int64_t *object_size) {
+                  return object_manager_.GetObjectLocations(object_id, client_ids,
+                                                            object_size);
+                })
+              : nullptr),
       reconstruction_policy_(
           io_service_,
           [this](const TaskID &task_id) { HandleTaskReconstruction(task_id); },
@@ -100,7 +120,9 @@ NodeManager::NodeManager(boost::asio::io_service &io_service,
           object_manager, reconstruction_policy_, io_service,
           gcs_client_->client_table().GetLocalClientId(),
           RayConfig::instance().initial_reconstruction_timeout_milliseconds(),
+          RayConfig::instance().task_lease_renewal_tick_milliseconds(),
           gcs_client->task_lease_table()),
+      task_pipeline_(local_queues_, task_dependency_manager_),
       lineage_cache_(gcs_client_->client_table().GetLocalClientId(),
                      gcs_client->raylet_task_table(), gcs_client->raylet_task_table(),
                      config.max_lineage_size),
@@ -108,6 +130,9 @@ NodeManager::NodeManager(boost::asio::io_service &io_service,
       remote_server_connections_(),
       actor_registry_() {
   RAY_CHECK(heartbeat_period_.count() > 0);
+  for (const auto &entry : config.worker_commands) {
+    worker_languages_.push_back(entry.first);
+  }
   // Initialize the resource map with own cluster resource configuration.
   ClientID local_client_id = gcs_client_->client_table().GetLocalClientId();
   cluster_resource_map_.emplace(local_client_id,
@@ -183,15 +208,17 @@ ray::Status NodeManager::RegisterGcs() {
   };
   gcs_client_->client_table().RegisterClientRemovedCallback(node_manager_client_removed);
 
-  // Subscribe to node manager heartbeats.
-  const auto heartbeat_added = [this](gcs::AsyncGcsClient *client, const ClientID &id,
-                                      const HeartbeatTableDataT &heartbeat_data) {
-    HeartbeatAdded(client, id, heartbeat_data);
+  // Subscribe to the batches of node manager heartbeats that the monitor
+  // publishes once per heartbeat period.
+  const auto heartbeat_batch_added = [this](
+      gcs::AsyncGcsClient *client, const ClientID &id,
+      const HeartbeatBatchTableDataT &heartbeat_batch) {
+    HeartbeatBatchAdded(client, heartbeat_batch);
   };
-  RAY_RETURN_NOT_OK(gcs_client_->heartbeat_table().Subscribe(
-      UniqueID::nil(), UniqueID::nil(), heartbeat_added, nullptr,
+  RAY_RETURN_NOT_OK(gcs_client_->heartbeat_batch_table().Subscribe(
+      UniqueID::nil(), UniqueID::nil(), heartbeat_batch_added, nullptr,
       [](gcs::AsyncGcsClient *client) {
-        RAY_LOG(DEBUG) << "heartbeat table subscription done callback called.";
+        RAY_LOG(DEBUG) << "heartbeat batch table subscription done callback called.";
       }));
 
   // Subscribe to driver table updates.
@@ -207,6 +234,11 @@ ray::Status NodeManager::RegisterGcs() {
   last_heartbeat_at_ms_ = current_time_ms();
   Heartbeat();
 
+  // Start resizing the worker pool based on the demand for workers.
+  if (RayConfig::instance().worker_pool_resize_period_milliseconds() > 0) {
+    ResizeWorkerPool();
+  }
+
   return ray::Status::OK();
 }
 
@@ -270,25 +302,10 @@ void NodeManager::Heartbeat() {
   const auto &my_client_id = gcs_client_->client_table().GetLocalClientId();
   SchedulingResources &local_resources = cluster_resource_map_[my_client_id];
   heartbeat_data->client_id = my_client_id.binary();
-  // TODO(atumanov): modify the heartbeat table protocol to use the ResourceSet directly.
-  // TODO(atumanov): implement a ResourceSet const_iterator.
   RAY_LOG(DEBUG) << "[Heartbeat] resources available: "
                  << local_resources.GetAvailableResources().ToString();
-  for (const auto &resource_pair :
-       local_resources.GetAvailableResources().GetResourceMap()) {
-    heartbeat_data->resources_available_label.push_back(resource_pair.first);
-    heartbeat_data->resources_available_capacity.push_back(resource_pair.second);
-  }
-  for (const auto &resource_pair : local_resources.GetTotalResources().GetResourceMap()) {
-    heartbeat_data->resources_total_label.push_back(resource_pair.first);
-    heartbeat_data->resources_total_capacity.push_back(resource_pair.second);
-  }
-
   local_resources.SetLoadResources(local_queues_.GetResourceLoad());
-  for (const auto &resource_pair : local_resources.GetLoadResources().GetResourceMap()) {
-    heartbeat_data->resource_load_label.push_back(resource_pair.first);
-    heartbeat_data->resource_load_capacity.push_back(resource_pair.second);
-  }
+  heartbeat_encoder_.Encode(local_resources, heartbeat_data.get());
 
   ray::Status status = heartbeat_table.Add(
       UniqueID::nil(), gcs_client_->client_table().GetLocalClientId(), heartbeat_data,
@@ -311,6 +328,51 @@ void NodeManager::Heartbeat() {
   });
 }
 
+void NodeManager::ResizeWorkerPool() {
+  for (const auto &language : worker_languages_) {
+    // The demand for workers is the number of ready non-actor tasks. Actor
+    // tasks can only run on their actor's worker.
+    const auto resize = worker_pool_controller_.Resize(
+        language, local_queues_.GetNumReadyNonActorTasks(language),
+        worker_pool_.NumIdleWorkers(language),
+        worker_pool_.NumStartingWorkers(language));
+    // Each worker process registers num_workers_per_process workers.
+    const int64_t num_workers_per_process =
+        RayConfig::instance().num_workers_per_process();
+    const int64_t num_processes_to_start =
+        (resize.num_workers_to_start + num_workers_per_process - 1) /
+        num_workers_per_process;
+    for (int64_t i = 0; i < num_processes_to_start; i++) {
+      worker_pool_.StartWorkerProcess(language);
+    }
+    int64_t num_workers_reaped = 0;
+    if (resize.num_workers_to_reap > 0) {
+      for (const auto &worker : worker_pool_.ReapIdleWorkers(
+               language, RayConfig::instance().worker_pool_idle_timeout_milliseconds(),
+               resize.num_workers_to_reap)) {
+        worker->MarkDead();
+        KillWorker(worker);
+        num_workers_reaped++;
+      }
+      worker_pool_controller_.RecordReapedWorkers(language, num_workers_reaped);
+    }
+    if (num_processes_to_start > 0 || num_workers_reaped > 0) {
+      RAY_LOG(DEBUG) << "Resized worker pool, started " << num_processes_to_start
+                     << " worker processes and reaped " << num_workers_reaped
+                     << " workers: "
+                     << worker_pool_controller_.GetMetrics(language).ToString();
+    }
+  }
+
+  // Reset the timer.
+  worker_pool_timer_.expires_from_now(std::chrono::milliseconds(
+      RayConfig::instance().worker_pool_resize_period_milliseconds()));
+  worker_pool_timer_.async_wait([this](const boost::system::error_code &error) {
+    RAY_CHECK(!error);
+    ResizeWorkerPool();
+  });
+}
+
 void NodeManager::ClientAdded(const ClientTableDataT &client_data) {
   const ClientID client_id = ClientID::from_binary(client_data.client_id);
 
@@ -356,7 +418,7 @@ void NodeManager::ClientAdded(const ClientTableDataT &client_data) {
   }
 
   // The client is connected.
-  auto server_conn = TcpServerConnection(std::move(socket));
+  auto server_conn = TcpServerConnection::Create(std::move(socket));
   remote_server_connections_.emplace(client_id, std::move(server_conn));
 
   ResourceSet resources_total(client_data.resources_total_label,
@@ -383,9 +445,13 @@ void NodeManager::ClientRemoved(const ClientTableDataT &client_data) {
 
   // Remove the client from the resource map.
   cluster_resource_map_.erase(client_id);
+  heartbeat_decoders_.erase(client_id);
 
   // Remove the remote server connection.
   remote_server_connections_.erase(client_id);
+
+  // Stop sending objects to the removed node.
+  object_manager_.HandleClientRemoved(client_id);
 }
 
 void NodeManager::HeartbeatAdded(gcs::AsyncGcsClient *client, const ClientID &client_id,
@@ -407,28 +473,52 @@ void NodeManager::HeartbeatAdded(gcs::AsyncGcsClient *client, const ClientID &cl
   }
   SchedulingResources &remote_resources = it->second;
 
-  ResourceSet remote_available(heartbeat_data.resources_available_label,
-                               heartbeat_data.resources_available_capacity);
-  ResourceSet remote_load(heartbeat_data.resource_load_label,
-                          heartbeat_data.resource_load_capacity);
+  auto &heartbeat_decoder = heartbeat_decoders_[client_id];
+  if (!heartbeat_decoder.Decode(heartbeat_data)) {
+    // We missed an earlier heartbeat from this client, so keep its resources
+    // until the next full heartbeat.
+    RAY_LOG(DEBUG) << "[HeartbeatAdded]: waiting for a full heartbeat from client id "
+                   << client_id;
+    return;
+  }
   // TODO(atumanov): assert that the load is a non-empty ResourceSet.
-  RAY_LOG(DEBUG) << "[HeartbeatAdded]: received load: " << remote_load.ToString();
-  remote_resources.SetAvailableResources(std::move(remote_available));
+  RAY_LOG(DEBUG) << "[HeartbeatAdded]: received load: "
+                 << heartbeat_decoder.GetLoadResources().ToString();
+  remote_resources.SetAvailableResources(
+      ResourceSet(heartbeat_decoder.GetAvailableResources()));
   // Extract the load information and save it locally.
-  remote_resources.SetLoadResources(std::move(remote_load));
+  remote_resources.SetLoadResources(ResourceSet(heartbeat_decoder.GetLoadResources()));
+
+  // Do not spill more tasks over to the remote node manager while the
+  // connection to it has not drained the messages already queued for it.
+  auto conn_it = remote_server_connections_.find(client_id);
+  if (conn_it != remote_server_connections_.end() &&
+      conn_it->second->IsWriteQueueFull()) {
+    RAY_LOG(DEBUG) << "[HeartbeatAdded]: not spilling over to client id " << client_id
+                   << " with " << conn_it->second->PendingWriteBytes()
+                   << " bytes queued";
+    return;
+  }
 
-  auto decision = scheduling_policy_.SpillOver(remote_resources);
-  // Extract decision for this local scheduler.
-  std::unordered_set<TaskID> local_task_ids;
+  auto decision = scheduling_policy_.SpillOver(client_id, remote_resources);
+  std::vector<Task> spilled_tasks;
   for (const auto &task_id : decision) {
     // (See design_docs/task_states.rst for the state transition diagram.)
-    const auto task = local_queues_.RemoveTask(task_id);
+    spilled_tasks.push_back(local_queues_.RemoveTask(task_id));
     // Since we are spilling back from the ready and waiting queues, we need
     // to unsubscribe the dependencies.
     task_dependency_manager_.UnsubscribeDependencies(task_id);
-    // Attempt to forward the task. If this fails to forward the task,
-    // the task will be resubmit locally.
-    ForwardTaskOrResubmit(task, client_id);
+  }
+  // Attempt to forward the tasks in one batch. If this fails to forward the
+  // tasks, the tasks will be resubmit locally.
+  ForwardTasksOrResubmit(spilled_tasks, client_id);
+}
+
+void NodeManager::HeartbeatBatchAdded(gcs::AsyncGcsClient *client,
+                                      const HeartbeatBatchTableDataT &heartbeat_batch) {
+  for (const auto &heartbeat_data : heartbeat_batch.batch) {
+    HeartbeatAdded(client, ClientID::from_binary(heartbeat_data->client_id),
+                   *heartbeat_data);
   }
 }
 
@@ -509,27 +599,169 @@ void NodeManager::ProcessNewClient(LocalClientConnection &client) {
 }
 
 void NodeManager::DispatchTasks() {
-  // Work with a copy of scheduled tasks.
+  // Ready tasks are grouped by priority and resource demand, with the highest
+  // priority first. Dispatching a task only removes it from its own group, or
+  // queues it again at the back of that group, so the next group stays valid.
+  // A group is erased once its last task is removed. If that task cannot be
+  // assigned, its group is created again at the end of its priority, so it is
+  // tried at most once more.
   // (See design_docs/task_states.rst for the state transition diagram.)
-  auto ready_tasks = local_queues_.GetReadyTasks();
-  // Return if there are no tasks to schedule.
-  if (ready_tasks.empty()) {
-    return;
+  const auto &buckets = local_queues_.GetReadyTasksByShape();
+  auto bucket = buckets.begin();
+  while (bucket != buckets.end()) {
+    auto next_bucket = std::next(bucket);
+    // Try each task that was in the group when dispatch reached it.
+    const size_t num_tasks = bucket->task_ids.size();
+    for (size_t i = 0; i < num_tasks; i++) {
+      if (!local_available_resources_.Contains(bucket->resources)) {
+        // Not enough local resources for tasks with this demand right now, skip
+        // the rest of the group.
+        // TODO(rkn): We should always skip node managers that have 0 CPUs.
+        break;
+      }
+      const bool is_last_task = bucket->task_ids.size() == 1;
+      // We have enough resources for this task. Assign task.
+      // TODO(atumanov): perform the task state/queue transition inside AssignTask.
+      // (See design_docs/task_states.rst for the state transition diagram.)
+      auto dispatched_task = local_queues_.RemoveTask(bucket->task_ids.front());
+      const bool is_actor_task = dispatched_task.GetTaskSpecification().IsActorTask();
+      if (!AssignTask(dispatched_task) && !is_actor_task) {
+        // There are no idle workers for the group's tasks, so the rest of the
+        // group would only be queued again. Each actor task waits for its own
+        // actor's worker, so the other actor tasks in the group are still tried.
+        break;
+      }
+      if (is_last_task) {
+        // The group was erased.
+        break;
+      }
+    }
+    bucket = next_bucket;
   }
 
-  for (const auto &task : ready_tasks) {
-    const auto &task_resources = task.GetTaskSpecification().GetRequiredResources();
-    if (!local_available_resources_.Contains(task_resources)) {
-      // Not enough local resources for this task right now, skip this task.
-      // TODO(rkn): We should always skip node managers that have 0 CPUs.
-      continue;
+  if (RayConfig::instance().max_tasks_in_flight_per_worker() > 1) {
+    PipelineTasks();
+  }
+}
+
+void NodeManager::PipelineTasks() {
+  const size_t max_pipelined_tasks =
+      RayConfig::instance().max_tasks_in_flight_per_worker() - 1;
+  for (const auto &worker : worker_pool_.GetWorkersRunningTasks()) {
+    if (local_queues_.GetReadyTasks().empty()) {
+      return;
     }
-    // We have enough resources for this task. Assign task.
-    // TODO(atumanov): perform the task state/queue transition inside AssignTask.
-    // (See design_docs/task_states.rst for the state transition diagram.)
-    auto dispatched_task = local_queues_.RemoveTask(task.GetTaskSpecification().TaskId());
-    AssignTask(dispatched_task);
+    for (const auto &task : task_pipeline_.PipelineReadyTasks(
+             *worker, local_available_resources_, max_pipelined_tasks)) {
+      SendPipelinedTask(worker, task);
+    }
+  }
+}
+
+void NodeManager::SendPipelinedTask(const std::shared_ptr<Worker> &worker,
+                                    const Task &task) {
+  const TaskSpecification &spec = task.GetTaskSpecification();
+  RAY_LOG(DEBUG) << "Pipelining task " << spec.TaskId() << " to worker with pid "
+                 << worker->Pid();
+  // The worker may run the task as soon as it reads it after finishing the
+  // tasks before it, so the task was recorded before the write completes. If
+  // the write fails, the worker is disconnected and its pipelined tasks are
+  // queued again.
+  flatbuffers::FlatBufferBuilder fbb;
+  // The task reuses the resources of the task that runs before it.
+  ResourceIdSet resource_id_set =
+      worker->GetTaskResourceIds().Plus(worker->GetLifetimeResourceIds());
+  auto message = protocol::CreateGetTaskReply(
+      fbb, spec.ToFlatbuffer(fbb), fbb.CreateVector(resource_id_set.ToFlatbuf(fbb)));
+  fbb.Finish(message);
+  worker->Connection()->WriteMessageAsync(
+      static_cast<int64_t>(protocol::MessageType::ExecuteTask), fbb.GetSize(),
+      fbb.GetBufferPointer(), [this, worker](const ray::Status &status) {
+        if (!status.ok() &&
+            worker_pool_.GetRegisteredWorker(worker->Connection()) != nullptr) {
+          RAY_LOG(WARNING) << "Failed to send task to worker, disconnecting client";
+          ProcessClientMessage(
+              worker->Connection(),
+              static_cast<int64_t>(protocol::MessageType::DisconnectClient), nullptr);
+        }
+      });
+}
+
+void NodeManager::StartPipelinedTask(Worker &worker) {
+  const auto &my_client_id = gcs_client_->client_table().GetLocalClientId();
+  Task task =
+      task_pipeline_.StartPipelinedTask(worker, cluster_resource_map_[my_client_id]);
+  const TaskSpecification &spec = task.GetTaskSpecification();
+  RAY_LOG(DEBUG) << "Worker with pid " << worker.Pid() << " started pipelined task "
+                 << spec.TaskId();
+  if (spec.IsActorTask()) {
+    // The method was pipelined behind the method that created its cursor, so
+    // it cannot have been executed already.
+    RAY_CHECK(!CheckDuplicateActorTask(actor_registry_, spec));
+    ExtendActorFrontier(task);
   }
+  if (!lineage_cache_.AddReadyTask(task)) {
+    RAY_LOG(WARNING) << "Task " << spec.TaskId()
+                     << " already in lineage cache. This is most likely due "
+                        "to reconstruction.";
+  }
+  // (See design_docs/task_states.rst for the state transition diagram.)
+  local_queues_.QueueRunningTasks(std::vector<Task>({task}));
+}
+
+void NodeManager::PipelineActorTasks(const std::shared_ptr<Worker> &worker) {
+  // A blocked actor may be waiting for a method that would be pipelined
+  // behind it.
+  if (worker->GetAssignedTaskId().is_nil() || worker->IsBlocked() || worker->IsDead()) {
+    return;
+  }
+  const size_t max_pipelined_tasks =
+      RayConfig::instance().max_tasks_in_flight_per_worker() - 1;
+  const ResourceSet worker_resources = worker->GetTaskResourceIds().ToResourceSet();
+  // The tasks that the actor runs before any newly pipelined method.
+  std::unordered_set<TaskID> sent_task_ids = {worker->GetAssignedTaskId()};
+  for (const auto &task : worker->GetPipelinedTasks()) {
+    sent_task_ids.insert(task.GetTaskSpecification().TaskId());
+  }
+  bool pipelined_task = true;
+  while (pipelined_task && worker->GetPipelinedTasks().size() < max_pipelined_tasks) {
+    pipelined_task = false;
+    // A method whose missing dependencies are all created by tasks sent to
+    // the actor, e.g., the method's cursor, can run right after them.
+    const auto task_ids = task_dependency_manager_.GetTasksWaitingOnlyFor(sent_task_ids);
+    std::unordered_set<TaskID> other_task_ids(task_ids.begin(), task_ids.end());
+    local_queues_.FilterState(other_task_ids, TaskState::WAITING);
+    for (const auto &task_id : task_ids) {
+      if (worker->GetPipelinedTasks().size() >= max_pipelined_tasks) {
+        break;
+      }
+      if (other_task_ids.count(task_id) == 1) {
+        continue;
+      }
+      // Leave the tasks that the actor cannot run in place in the queue.
+      const auto &spec = local_queues_.GetTaskOfState(task_id, TaskState::WAITING)
+                             .GetTaskSpecification();
+      if (!spec.IsActorTask() || spec.ActorId() != worker->GetActorId() ||
+          !spec.GetRequiredResources().IsEqual(worker_resources)) {
+        continue;
+      }
+      // (See design_docs/task_states.rst for the state transition diagram.)
+      auto task = local_queues_.RemoveTask(task_id);
+      task_pipeline_.PipelineTask(*worker, task);
+      SendPipelinedTask(worker, task);
+      sent_task_ids.insert(task_id);
+      pipelined_task = true;
+    }
+  }
+}
+
+void NodeManager::RevokePipelinedTasks(Worker &worker) {
+  if (worker.GetPipelinedTasks().empty()) {
+    return;
+  }
+  const auto tasks = task_pipeline_.RevokePipelinedTasks(worker);
+  RAY_LOG(DEBUG) << "Revoked " << tasks.size() << " tasks pipelined to worker with pid "
+                 << worker.Pid();
 }
 
 void NodeManager::ProcessClientMessage(
@@ -554,7 +786,7 @@ void NodeManager::ProcessClientMessage(
     ProcessRegisterClientRequestMessage(client, message_data);
   } break;
   case protocol::MessageType::GetTask: {
-    ProcessGetTaskMessage(client);
+    ProcessGetTaskMessage(client, message_data);
   } break;
   case protocol::MessageType::DisconnectClient: {
     ProcessDisconnectClientMessage(client);
@@ -619,15 +851,49 @@ void NodeManager::ProcessRegisterClientRequestMessage(
 }
 
 void NodeManager::ProcessGetTaskMessage(
-    const std::shared_ptr<LocalClientConnection> &client) {
+    const std::shared_ptr<LocalClientConnection> &client, const uint8_t *message_data) {
   std::shared_ptr<Worker> worker = worker_pool_.GetRegisteredWorker(client);
   RAY_CHECK(worker);
-  // If the worker was assigned a task, mark it as finished.
-  if (!worker->GetAssignedTaskId().is_nil()) {
-    FinishAssignedTask(*worker);
+  auto message = flatbuffers::GetRoot<protocol::GetTaskRequest>(message_data);
+  const TaskID started_task_id = from_flatbuf(*message->started_task_id());
+  if (message->revoke_pipelined_tasks()) {
+    // The worker blocked since it last heard from us, so we may have revoked
+    // some of its pipelined tasks already. It will not start any of them, so
+    // queue the rest again too. The worker drops the tasks it reads before the
+    // reply. If the write fails, the worker is disconnected anyway.
+    RAY_CHECK(started_task_id.is_nil());
+    RevokePipelinedTasks(*worker);
+    worker->Connection()->WriteMessageAsync(
+        static_cast<int64_t>(protocol::MessageType::CancelPipelinedTasks), 0, nullptr,
+        [](const ray::Status &status) {});
+  }
+  if (!worker->GetPipelinedTasks().empty()) {
+    // The worker has started its next pipelined task, or starts it as soon as
+    // it reads it. The task reuses the resources of the task that it finished.
+    RAY_CHECK(started_task_id.is_nil() ||
+              started_task_id ==
+                  worker->GetPipelinedTasks().front().GetTaskSpecification().TaskId())
+        << "Worker with pid " << worker->Pid() << " started task " << started_task_id
+        << " out of order";
+    FinishAssignedTask(*worker, /*release_task_resources=*/false);
+    StartPipelinedTask(*worker);
+    if (!worker->GetActorId().is_nil()) {
+      // Refill the actor's pipeline.
+      PipelineActorTasks(worker);
+    }
+  } else {
+    // A worker only starts a task without waiting for a reply if the task was
+    // pipelined to it and cannot have been revoked.
+    RAY_CHECK(started_task_id.is_nil())
+        << "Worker with pid " << worker->Pid() << " started task " << started_task_id
+        << ", which is not pipelined to it";
+    // If the worker was assigned a task, mark it as finished.
+    if (!worker->GetAssignedTaskId().is_nil()) {
+      FinishAssignedTask(*worker);
+    }
+    // Return the worker to the idle pool.
+    worker_pool_.PushWorker(std::move(worker));
   }
-  // Return the worker to the idle pool.
-  worker_pool_.PushWorker(std::move(worker));
   // Local resource availability changed: invoke scheduling policy for local node.
   const ClientID &local_client_id = gcs_client_->client_table().GetLocalClientId();
   cluster_resource_map_[local_client_id].SetLoadResources(
@@ -676,6 +942,8 @@ void NodeManager::ProcessDisconnectClientMessage(
       task_dependency_manager_.TaskCanceled(spec.TaskId());
       local_queues_.RemoveTask(spec.TaskId());
     }
+    // The worker did not start its pipelined tasks, so queue them again.
+    RevokePipelinedTasks(*worker);
 
     worker_pool_.DisconnectWorker(worker);
 
@@ -798,9 +1066,12 @@ void NodeManager::ProcessWaitRequestMessage(
         flatbuffers::Offset<protocol::WaitReply> wait_reply = protocol::CreateWaitReply(
             fbb, to_flatbuf(fbb, found), to_flatbuf(fbb, remaining));
         fbb.Finish(wait_reply);
-        RAY_CHECK_OK(
-            client->WriteMessage(static_cast<int64_t>(protocol::MessageType::WaitReply),
-                                 fbb.GetSize(), fbb.GetBufferPointer()));
+        // Write the reply on the same path as the other messages to the
+        // worker, so that it is not reordered with the writes in flight. If
+        // the write fails, the worker is disconnected by its read handler.
+        client->WriteMessageAsync(static_cast<int64_t>(protocol::MessageType::WaitReply),
+                                  fbb.GetSize(), fbb.GetBufferPointer(),
+                                  [](const ray::Status &status) {});
         // The client is unblocked now because the wait call has returned.
         if (client_blocked) {
           HandleClientUnblocked(client);
@@ -839,6 +1110,17 @@ void NodeManager::ProcessNodeManagerMessage(TcpClientConnection &node_manager_cl
                    << " spillback=" << task.GetTaskExecutionSpec().NumForwards();
     SubmitTask(task, uncommitted_lineage, /* forwarded = */ true);
   } break;
+  case protocol::MessageType::ForwardTaskBatchRequest: {
+    auto message = flatbuffers::GetRoot<protocol::ForwardTaskBatchRequest>(message_data);
+    Lineage uncommitted_lineage(*message);
+    // Submit the tasks in the order that the sender chose.
+    for (const auto &task_id : from_flatbuf(*message->task_ids())) {
+      const Task &task = uncommitted_lineage.GetEntry(task_id)->TaskData();
+      RAY_LOG(DEBUG) << "got task " << task_id
+                     << " spillback=" << task.GetTaskExecutionSpec().NumForwards();
+      SubmitTask(task, uncommitted_lineage, /* forwarded = */ true);
+    }
+  } break;
   case protocol::MessageType::DisconnectClient: {
     // TODO(rkn): We need to do some cleanup here.
     RAY_LOG(DEBUG) << "Received disconnect message from remote node manager. "
@@ -874,6 +1156,7 @@ void NodeManager::ScheduleTasks(
 
   // Extract decision for this local scheduler.
   std::unordered_set<TaskID> local_task_ids;
+  std::vector<std::pair<Task, ClientID>> remote_tasks;
   // Iterate over (taskid, clientid) pairs, extract tasks assigned to the local node.
   for (const auto &task_client_pair : policy_decision) {
     const TaskID &task_id = task_client_pair.first;
@@ -883,13 +1166,31 @@ void NodeManager::ScheduleTasks(
     } else {
       // TODO(atumanov): need a better interface for task exit on forward.
       // (See design_docs/task_states.rst for the state transition diagram.)
-      const auto task = local_queues_.RemoveTask(task_id);
-      // Attempt to forward the task. If this fails to forward the task,
-      // the task will be resubmit locally.
-      ForwardTaskOrResubmit(task, client_id);
+      remote_tasks.emplace_back(local_queues_.RemoveTask(task_id), client_id);
     }
   }
 
+  // Forward the tasks with the highest priority first, so that they are queued
+  // at the remote node managers ahead of the tasks with a lower priority.
+  std::stable_sort(remote_tasks.begin(), remote_tasks.end(),
+                   [](const std::pair<Task, ClientID> &lhs,
+                      const std::pair<Task, ClientID> &rhs) {
+                     return lhs.first.GetTaskSpecification().Priority() >
+                            rhs.first.GetTaskSpecification().Priority();
+                   });
+  // Group the tasks by destination, so that each remote node manager receives
+  // a single message with all of its tasks.
+  std::unordered_map<ClientID, std::vector<Task>> tasks_by_destination;
+  for (auto &task_client_pair : remote_tasks) {
+    tasks_by_destination[task_client_pair.second].push_back(
+        std::move(task_client_pair.first));
+  }
+  for (const auto &destination_tasks_pair : tasks_by_destination) {
+    // Attempt to forward the tasks. If this fails to forward the tasks,
+    // the tasks will be resubmit locally.
+    ForwardTasksOrResubmit(destination_tasks_pair.second, destination_tasks_pair.first);
+  }
+
   // Transition locally placed tasks to waiting or ready for dispatch.
   if (local_task_ids.size() > 0) {
     std::vector<Task> tasks = local_queues_.RemoveTasks(local_task_ids);
@@ -973,6 +1274,18 @@ void NodeManager::TreatTaskAsFailed(const TaskSpecification &spec) {
   }
 }
 
+void NodeManager::ScheduleTasksDeferred() {
+  if (schedule_tasks_pending_) {
+    return;
+  }
+  schedule_tasks_pending_ = true;
+  io_service_.post([this]() {
+    schedule_tasks_pending_ = false;
+    ScheduleTasks(cluster_resource_map_);
+    DispatchTasks();
+  });
+}
+
 void NodeManager::SubmitTask(const Task &task, const Lineage &uncommitted_lineage,
                              bool forwarded) {
   const TaskID task_id = task.GetTaskSpecification().TaskId();
@@ -1016,7 +1329,7 @@ void NodeManager::SubmitTask(const Task &task, const Lineage &uncommitted_lineag
         } else {
           // Attempt to forward the task. If this fails to forward the task,
           // the task will be resubmit locally.
-          ForwardTaskOrResubmit(task, node_manager_id);
+          ForwardTasksOrResubmit({task}, node_manager_id);
         }
       }
     } else {
@@ -1056,8 +1369,7 @@ void NodeManager::SubmitTask(const Task &task, const Lineage &uncommitted_lineag
     } else {
       // (See design_docs/task_states.rst for the state transition diagram.)
       local_queues_.QueuePlaceableTasks({task});
-      ScheduleTasks(cluster_resource_map_);
-      DispatchTasks();
+      ScheduleTasksDeferred();
       // TODO(atumanov): assert that !placeable.isempty() => insufficient available
       // resources locally.
     }
@@ -1076,7 +1388,7 @@ void NodeManager::HandleWorkerBlocked(std::shared_ptr<Worker> worker) {
   // (See design_docs/task_states.rst for the state transition diagram.)
   const auto task = local_queues_.RemoveTask(worker->GetAssignedTaskId());
   // Get the CPU resources required by the running task.
-  const auto required_resources = task.GetTaskSpecification().GetRequiredResources();
+  const auto &required_resources = task.GetTaskSpecification().GetRequiredResources();
   double required_cpus = required_resources.GetNumCpus();
   const std::unordered_map<std::string, double> cpu_resources = {
       {kCPU_ResourceLabel, required_cpus}};
@@ -1091,6 +1403,11 @@ void NodeManager::HandleWorkerBlocked(std::shared_ptr<Worker> worker) {
   local_queues_.QueueBlockedTasks({task});
   worker->MarkBlocked();
 
+  // The blocked task may be waiting for a task that was pipelined behind it,
+  // so let other workers run the pipelined tasks. The worker does not start
+  // any task that was pipelined to it before it blocked.
+  RevokePipelinedTasks(*worker);
+
   DispatchTasks();
 }
 
@@ -1103,7 +1420,7 @@ void NodeManager::HandleWorkerUnblocked(std::shared_ptr<Worker> worker) {
   // (See design_docs/task_states.rst for the state transition diagram.)
   const auto task = local_queues_.RemoveTask(worker->GetAssignedTaskId());
   // Get the CPU resources required by the running task.
-  const auto required_resources = task.GetTaskSpecification().GetRequiredResources();
+  const auto &required_resources = task.GetTaskSpecification().GetRequiredResources();
   double required_cpus = required_resources.GetNumCpus();
   const ResourceSet cpu_resources(
       std::unordered_map<std::string, double>({{kCPU_ResourceLabel, required_cpus}}));
@@ -1213,16 +1530,27 @@ void NodeManager::EnqueuePlaceableTask(const Task &task) {
   // has been forwarded to another node, the task must be marked as canceled in
   // the TaskDependencyManager.
   task_dependency_manager_.TaskPending(task);
+
+  const TaskSpecification &spec = task.GetTaskSpecification();
+  if (!args_ready && spec.IsActorTask() &&
+      RayConfig::instance().max_tasks_in_flight_per_worker() > 1) {
+    // The method may only be waiting for the methods that its actor is
+    // running, in which case it can be sent to the actor right away.
+    auto worker = worker_pool_.GetActorWorker(spec.ActorId());
+    if (worker != nullptr) {
+      PipelineActorTasks(worker);
+    }
+  }
 }
 
-void NodeManager::AssignTask(Task &task) {
+bool NodeManager::AssignTask(Task &task) {
   const TaskSpecification &spec = task.GetTaskSpecification();
 
   // If this is an actor task, check that the new task has the correct counter.
   if (spec.IsActorTask()) {
     if (CheckDuplicateActorTask(actor_registry_, spec)) {
       // Drop tasks that have already been executed.
-      return;
+      return true;
     }
   }
 
@@ -1239,7 +1567,7 @@ void NodeManager::AssignTask(Task &task) {
     // worker once one becomes available.
     // (See design_docs/task_states.rst for the state transition diagram.)
     local_queues_.QueueReadyTasks(std::vector<Task>({task}));
-    return;
+    return false;
   }
 
   RAY_LOG(DEBUG) << "Assigning task to worker with pid " << worker->Pid();
@@ -1265,61 +1593,94 @@ void NodeManager::AssignTask(Task &task) {
   auto message = protocol::CreateGetTaskReply(fbb, spec.ToFlatbuffer(fbb),
                                               fbb.CreateVector(resource_id_set_flatbuf));
   fbb.Finish(message);
-  auto status = worker->Connection()->WriteMessage(
-      static_cast<int64_t>(protocol::MessageType::ExecuteTask), fbb.GetSize(),
-      fbb.GetBufferPointer());
-  if (status.ok()) {
-    // We successfully assigned the task to the worker.
-    worker->AssignTaskId(spec.TaskId());
-    worker->AssignDriverId(spec.DriverId());
-    // If the task was an actor task, then record this execution to guarantee
-    // consistency in the case of reconstruction.
-    if (spec.IsActorTask()) {
-      auto actor_entry = actor_registry_.find(spec.ActorId());
-      RAY_CHECK(actor_entry != actor_registry_.end());
-      auto execution_dependency = actor_entry->second.GetExecutionDependency();
-      // The execution dependency is initialized to the actor creation task's
-      // return value, and is subsequently updated to the assigned tasks'
-      // return values, so it should never be nil.
-      RAY_CHECK(!execution_dependency.is_nil());
-      // Update the task's execution dependencies to reflect the actual
-      // execution order, to support deterministic reconstruction.
-      // NOTE(swang): The update of an actor task's execution dependencies is
-      // performed asynchronously. This means that if this node manager dies,
-      // we may lose updates that are in flight to the task table. We only
-      // guarantee deterministic reconstruction ordering for tasks whose
-      // updates are reflected in the task table.
-      task.SetExecutionDependencies({execution_dependency});
-      // Extend the frontier to include the executing task.
-      actor_entry->second.ExtendFrontier(spec.ActorHandleId(), spec.ActorDummyObject());
-    }
-    // We started running the task, so the task is ready to write to GCS.
-    if (!lineage_cache_.AddReadyTask(task)) {
-      RAY_LOG(WARNING)
-          << "Task " << spec.TaskId()
-          << " already in lineage cache. This is most likely due to reconstruction.";
-    }
-    // Mark the task as running.
-    // (See design_docs/task_states.rst for the state transition diagram.)
-    local_queues_.QueueRunningTasks(std::vector<Task>({task}));
-    // Notify the task dependency manager that we no longer need this task's
-    // object dependencies.
-    task_dependency_manager_.UnsubscribeDependencies(spec.TaskId());
-  } else {
-    RAY_LOG(WARNING) << "Failed to send task to worker, disconnecting client";
-    // We failed to send the task to the worker, so disconnect the worker.
-    ProcessClientMessage(worker->Connection(),
-                         static_cast<int64_t>(protocol::MessageType::DisconnectClient),
-                         nullptr);
-    // Queue this task for future assignment. The task will be assigned to a
-    // worker once one becomes available.
-    // (See design_docs/task_states.rst for the state transition diagram.)
-    local_queues_.QueueReadyTasks(std::vector<Task>({task}));
-    DispatchTasks();
+
+  // Mark the task as running before the write completes, so that the task is
+  // always in a queue and a disconnect while the write is in flight finds it.
+  worker->AssignTaskId(spec.TaskId());
+  worker->AssignDriverId(spec.DriverId());
+  // If the task was an actor task, then record this execution to guarantee
+  // consistency in the case of reconstruction.
+  if (spec.IsActorTask()) {
+    ExtendActorFrontier(task);
   }
+  // (See design_docs/task_states.rst for the state transition diagram.)
+  local_queues_.QueueRunningTasks(std::vector<Task>({task}));
+  // Notify the task dependency manager that we no longer need this task's
+  // object dependencies.
+  task_dependency_manager_.UnsubscribeDependencies(spec.TaskId());
+
+  // Write the task to the worker asynchronously, so that a slow worker does
+  // not stall the event loop.
+  worker->Connection()->WriteMessageAsync(
+      static_cast<int64_t>(protocol::MessageType::ExecuteTask), fbb.GetSize(),
+      fbb.GetBufferPointer(), [this, worker, task](const ray::Status &status) {
+        const TaskSpecification &spec = task.GetTaskSpecification();
+        // If the worker disconnected or was killed while the write was in
+        // flight, then the running task was already handled.
+        if (worker_pool_.GetRegisteredWorker(worker->Connection()) == nullptr ||
+            worker->IsDead() || worker->GetAssignedTaskId() != spec.TaskId()) {
+          return;
+        }
+        if (status.ok()) {
+          // We started running the task, so the task is ready to write to GCS.
+          if (!lineage_cache_.AddReadyTask(task)) {
+            RAY_LOG(WARNING) << "Task " << spec.TaskId()
+                             << " already in lineage cache. This is most likely due "
+                                "to reconstruction.";
+          }
+          if (spec.IsActorTask() &&
+              RayConfig::instance().max_tasks_in_flight_per_worker() > 1) {
+            // Send the actor the methods that are only waiting for this one.
+            PipelineActorTasks(worker);
+          }
+          return;
+        }
+
+        RAY_LOG(WARNING) << "Failed to send task to worker, disconnecting client";
+        // Roll back the assignment, so that disconnecting the worker does not
+        // treat the task as failed.
+        // (See design_docs/task_states.rst for the state transition diagram.)
+        local_queues_.RemoveTask(spec.TaskId());
+        worker->AssignTaskId(TaskID::nil());
+        // We failed to send the task to the worker, so disconnect the worker.
+        ProcessClientMessage(
+            worker->Connection(),
+            static_cast<int64_t>(protocol::MessageType::DisconnectClient), nullptr);
+        // Queue this task for future assignment. The task will be assigned to a
+        // worker once one becomes available.
+        if (task_dependency_manager_.SubscribeDependencies(spec.TaskId(),
+                                                           task.GetDependencies())) {
+          local_queues_.QueueReadyTasks(std::vector<Task>({task}));
+        } else {
+          local_queues_.QueueWaitingTasks(std::vector<Task>({task}));
+        }
+        DispatchTasks();
+      });
+  return true;
 }
 
-void NodeManager::FinishAssignedTask(Worker &worker) {
+void NodeManager::ExtendActorFrontier(Task &task) {
+  const TaskSpecification &spec = task.GetTaskSpecification();
+  auto actor_entry = actor_registry_.find(spec.ActorId());
+  RAY_CHECK(actor_entry != actor_registry_.end());
+  auto execution_dependency = actor_entry->second.GetExecutionDependency();
+  // The execution dependency is initialized to the actor creation task's
+  // return value, and is subsequently updated to the assigned tasks'
+  // return values, so it should never be nil.
+  RAY_CHECK(!execution_dependency.is_nil());
+  // Update the task's execution dependencies to reflect the actual
+  // execution order, to support deterministic reconstruction.
+  // NOTE(swang): The update of an actor task's execution dependencies is
+  // performed asynchronously. This means that if this node manager dies,
+  // we may lose updates that are in flight to the task table. We only
+  // guarantee deterministic reconstruction ordering for tasks whose
+  // updates are reflected in the task table.
+  task.SetExecutionDependencies({execution_dependency});
+  // Extend the frontier to include the executing task.
+  actor_entry->second.ExtendFrontier(spec.ActorHandleId(), spec.ActorDummyObject());
+}
+
+void NodeManager::FinishAssignedTask(Worker &worker, bool release_task_resources) {
   TaskID task_id = worker.GetAssignedTaskId();
   RAY_LOG(DEBUG) << "Finished task " << task_id;
 
@@ -1350,9 +1711,12 @@ void NodeManager::FinishAssignedTask(Worker &worker) {
     // Resources required by an actor creation task are acquired for the
     // lifetime of the actor, so we do not release any resources here.
   } else {
-    // Release task's resources.
-    local_available_resources_.Release(worker.GetTaskResourceIds());
-    worker.ResetTaskResourceIds();
+    // Release task's resources. The specific resource IDs stay with the worker
+    // if its next pipelined task reuses them.
+    if (release_task_resources) {
+      local_available_resources_.Release(worker.GetTaskResourceIds());
+      worker.ResetTaskResourceIds();
+    }
 
     RAY_CHECK(this->cluster_resource_map_[gcs_client_->client_table().GetLocalClientId()]
                   .Release(task.GetTaskSpecification().GetRequiredResources()));
@@ -1481,14 +1845,27 @@ void NodeManager::HandleObjectMissing(const ObjectID &object_id) {
   }
 }
 
-void NodeManager::ForwardTaskOrResubmit(const Task &task,
-                                        const ClientID &node_manager_id) {
+void NodeManager::ForwardTasksOrResubmit(const std::vector<Task> &tasks,
+                                         const ClientID &node_manager_id) {
   /// TODO(rkn): Should we check that the node manager is remote and not local?
   /// TODO(rkn): Should we check if the remote node manager is known to be dead?
-  const TaskID task_id = task.GetTaskSpecification().TaskId();
+  if (tasks.empty()) {
+    return;
+  }
 
-  // Attempt to forward the task.
-  if (!ForwardTask(task, node_manager_id).ok()) {
+  // Attempt to forward the tasks.
+  ForwardTasks(tasks, node_manager_id,
+               [this, node_manager_id](const ray::Status &status,
+                                       const std::vector<Task> &failed_tasks) {
+                 ResubmitFailedForwards(failed_tasks, node_manager_id);
+               });
+}
+
+void NodeManager::ResubmitFailedForwards(const std::vector<Task> &tasks,
+                                         const ClientID &node_manager_id) {
+  bool resubmitted_placeable_tasks = false;
+  for (const auto &task : tasks) {
+    const TaskID task_id = task.GetTaskSpecification().TaskId();
     RAY_LOG(INFO) << "Failed to forward task " << task_id << " to node manager "
                   << node_manager_id;
     // Mark the failed task as pending to let other raylets know that we still
@@ -1524,46 +1901,66 @@ void NodeManager::ForwardTaskOrResubmit(const Task &task,
       // The task is not for an actor and may therefore be placed on another
       // node immediately. Send it to the scheduling policy to be placed again.
       local_queues_.QueuePlaceableTasks({task});
-      ScheduleTasks(cluster_resource_map_);
-      DispatchTasks();
+      resubmitted_placeable_tasks = true;
     }
   }
+  if (resubmitted_placeable_tasks) {
+    ScheduleTasks(cluster_resource_map_);
+    DispatchTasks();
+  }
 }
 
-ray::Status NodeManager::ForwardTask(const Task &task, const ClientID &node_id) {
-  const auto &spec = task.GetTaskSpecification();
-  auto task_id = spec.TaskId();
-
-  // Get and serialize the task's unforwarded, uncommitted lineage.
-  auto uncommitted_lineage = lineage_cache_.GetUncommittedLineage(task_id, node_id);
-  Task &lineage_cache_entry_task =
-      uncommitted_lineage.GetEntryMutable(task_id)->TaskDataMutable();
+void NodeManager::ForwardTasks(
+    const std::vector<Task> &tasks, const ClientID &node_id,
+    const std::function<void(const ray::Status &, const std::vector<Task> &)>
+        &on_error) {
+  std::vector<TaskID> task_ids;
+  for (const auto &task : tasks) {
+    task_ids.push_back(task.GetTaskSpecification().TaskId());
+  }
 
-  // Increment forward count for the forwarded task.
-  lineage_cache_entry_task.IncrementNumForwards();
+  // Get and serialize the union of the tasks' unforwarded, uncommitted
+  // lineage, so that ancestors shared by several tasks are only sent once.
+  auto uncommitted_lineage = lineage_cache_.GetUncommittedLineage(task_ids, node_id);
+  for (const auto &task_id : task_ids) {
+    Task &lineage_cache_entry_task =
+        uncommitted_lineage.GetEntryMutable(task_id)->TaskDataMutable();
+    // Increment forward count for the forwarded task.
+    lineage_cache_entry_task.IncrementNumForwards();
+    RAY_LOG(DEBUG) << "Forwarding task " << task_id << " to " << node_id
+                   << " spillback="
+                   << lineage_cache_entry_task.GetTaskExecutionSpec().NumForwards();
+  }
 
   flatbuffers::FlatBufferBuilder fbb;
-  auto request = uncommitted_lineage.ToFlatbuffer(fbb, task_id);
+  auto request = uncommitted_lineage.ToFlatbuffer(fbb, task_ids);
   fbb.Finish(request);
 
-  RAY_LOG(DEBUG) << "Forwarding task " << task_id << " to " << node_id << " spillback="
-                 << lineage_cache_entry_task.GetTaskExecutionSpec().NumForwards();
-
-  auto client_info = gcs_client_->client_table().GetClient(node_id);
-
   // Lookup remote server connection for this node_id and use it to send the request.
   auto it = remote_server_connections_.find(node_id);
   if (it == remote_server_connections_.end()) {
-    // TODO(atumanov): caller must handle failure to ensure tasks are not lost.
     RAY_LOG(INFO) << "No NodeManager connection found for GCS client id " << node_id;
-    return ray::Status::IOError("NodeManager connection not found");
+    on_error(ray::Status::IOError("NodeManager connection not found"), tasks);
+    return;
   }
 
-  auto &server_conn = it->second;
-  auto status = server_conn.WriteMessage(
-      static_cast<int64_t>(protocol::MessageType::ForwardTaskRequest), fbb.GetSize(),
-      fbb.GetBufferPointer());
-  if (status.ok()) {
+  it->second->WriteMessageAsync(
+      static_cast<int64_t>(protocol::MessageType::ForwardTaskBatchRequest),
+      fbb.GetSize(), fbb.GetBufferPointer(),
+      [this, tasks, node_id, on_error](const ray::Status &status) {
+        if (status.ok()) {
+          FinishForwardedTasks(tasks, node_id);
+        } else {
+          on_error(status, tasks);
+        }
+      });
+}
+
+void NodeManager::FinishForwardedTasks(const std::vector<Task> &tasks,
+                                       const ClientID &node_id) {
+  for (const auto &task : tasks) {
+    const auto &spec = task.GetTaskSpecification();
+    const TaskID task_id = spec.TaskId();
     // If we were able to forward the task, remove the forwarded task from the
     // lineage cache since the receiving node is now responsible for writing
     // the task to the GCS.
@@ -1598,7 +1995,6 @@ ray::Status NodeManager::ForwardTask(const Task &task, const ClientID &node_id)
       }
     }
   }
-  return status;
 }
 
 }  // namespace raylet
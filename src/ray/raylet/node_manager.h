@@ -1,6 +1,8 @@
 #ifndef RAY_RAYLET_NODE_MANAGER_H
 #define RAY_RAYLET_NODE_MANAGER_H
 
+#include <unordered_set>
+
 #include <boost/asio/steady_timer.hpp>
 
 // clang-format off
@@ -9,13 +11,16 @@
 #include "ray/common/client_connection.h"
 #include "ray/gcs/format/util.h"
 #include "ray/raylet/actor_registration.h"
+#include "ray/raylet/heartbeat_codec.h"
 #include "ray/raylet/lineage_cache.h"
 #include "ray/raylet/scheduling_policy.h"
 #include "ray/raylet/scheduling_queue.h"
 #include "ray/raylet/scheduling_resources.h"
 #include "ray/raylet/reconstruction_policy.h"
 #include "ray/raylet/task_dependency_manager.h"
+#include "ray/raylet/task_pipeline.h"
 #include "ray/raylet/worker_pool.h"
+#include "ray/raylet/worker_pool_controller.h"
 // clang-format on
 
 namespace ray {
@@ -31,6 +36,8 @@ struct NodeManagerConfig {
   int maximum_startup_concurrency;
   /// The commands used to start the worker process, grouped by language.
   std::unordered_map<Language, std::vector<std::string>> worker_commands;
+  /// The languages whose workers are forked from a fork server.
+  std::unordered_set<Language> fork_server_languages;
   uint64_t heartbeat_period_ms;
   uint64_t max_lineage_size;
   /// The store socket name.
@@ -98,6 +105,11 @@ class NodeManager {
   void ClientRemoved(const ClientTableDataT &client_data);
   /// Send heartbeats to the GCS.
   void Heartbeat();
+  /// Start workers ahead of demand and reap idle workers above the demand,
+  /// then schedule the next resize.
+  ///
+  /// \return Void.
+  void ResizeWorkerPool();
   /// Handler for a heartbeat notification from the GCS.
   ///
   /// \param client The GCS client.
@@ -106,6 +118,14 @@ class NodeManager {
   /// \return Void.
   void HeartbeatAdded(gcs::AsyncGcsClient *client, const ClientID &id,
                       const HeartbeatTableDataT &data);
+  /// Handler for a batch of heartbeats published by the monitor.
+  ///
+  /// \param client The GCS client.
+  /// \param heartbeat_batch The heartbeats that the monitor received during the
+  /// last heartbeat period.
+  /// \return Void.
+  void HeartbeatBatchAdded(gcs::AsyncGcsClient *client,
+                           const HeartbeatBatchTableDataT &heartbeat_batch);
 
   /// Methods for task scheduling.
 
@@ -135,13 +155,59 @@ class NodeManager {
   /// Assign a task. The task is assumed to not be queued in local_queues_.
   ///
   /// \param task The task in question.
-  /// \return Void.
-  void AssignTask(Task &task);
+  /// \return False if no worker could execute the task, in which case the
+  /// task was queued as ready again. True otherwise.
+  bool AssignTask(Task &task);
   /// Handle a worker finishing its assigned task.
   ///
   /// \param The worker that fiished the task.
+  /// \param release_task_resources Whether to release the task's resources.
+  /// This is false if the worker's next pipelined task reuses them.
+  /// \return Void.
+  void FinishAssignedTask(Worker &worker, bool release_task_resources = true);
+  /// Send ready tasks ahead to busy workers whose running task has the same
+  /// resource demand, so that each worker starts its next task as soon as it
+  /// finishes one. Tasks are only pipelined if there are not enough local
+  /// resources to run them now.
+  ///
+  /// \return Void.
+  void PipelineTasks();
+  /// Send a task that was pipelined to a busy worker to the worker. The task
+  /// reuses the assigned task's resources.
+  ///
+  /// \param worker The busy worker.
+  /// \param task The task to send. It must already be pipelined to the worker.
+  /// \return Void.
+  void SendPipelinedTask(const std::shared_ptr<Worker> &worker, const Task &task);
+  /// Make a worker's next pipelined task its assigned task, once the worker
+  /// has finished its previous task.
+  ///
+  /// \param worker The worker.
+  /// \return Void.
+  void StartPipelinedTask(Worker &worker);
+  /// Send an actor the waiting methods whose missing dependencies are all
+  /// created by the tasks already sent to it, so that the actor runs them
+  /// back to back. The frontier is only extended once the actor starts a
+  /// method.
+  ///
+  /// \param worker The actor's worker.
   /// \return Void.
-  void FinishAssignedTask(Worker &worker);
+  void PipelineActorTasks(const std::shared_ptr<Worker> &worker);
+  /// Record that an actor started to execute a task. This sets the task's
+  /// execution dependency to the actor's previous task and extends the
+  /// actor's frontier to include the task.
+  ///
+  /// \param task The actor task.
+  /// \return Void.
+  void ExtendActorFrontier(Task &task);
+  /// Take back the tasks that were pipelined to a worker and queue them
+  /// again. The worker is not told. It only starts a pipelined task without
+  /// waiting for a reply if it cannot have been revoked, and otherwise asks
+  /// for its pipelined tasks to be revoked in its next GetTaskRequest.
+  ///
+  /// \param worker The worker.
+  /// \return Void.
+  void RevokePipelinedTasks(Worker &worker);
   /// Make a placement decision for placeable tasks given the resource_map
   /// provided. This will perform task state transitions and task forwarding.
   ///
@@ -151,6 +217,13 @@ class NodeManager {
   /// resource_map argument.
   /// \return Void.
   void ScheduleTasks(std::unordered_map<ClientID, SchedulingResources> &resource_map);
+  /// Schedule and dispatch the placeable tasks once the event loop has handled
+  /// the events that are already queued. Tasks submitted in a burst are then
+  /// placed by a single scheduling pass instead of one pass per task. At most
+  /// one such pass is outstanding at a time.
+  ///
+  /// \return Void.
+  void ScheduleTasksDeferred();
   /// Handle a task whose return value(s) must be reconstructed.
   ///
   /// \param task_id The relevant task ID.
@@ -162,22 +235,45 @@ class NodeManager {
   /// \param task The task being resubmitted.
   /// \return Void.
   void ResubmitTask(const Task &task);
-  /// Attempt to forward a task to a remote different node manager. If this
-  /// fails, the task will be resubmit locally.
+  /// Attempt to forward tasks to a remote different node manager. If this
+  /// fails, the tasks will be resubmit locally.
   ///
-  /// \param task The task in question.
+  /// \param tasks The tasks in question.
   /// \param node_manager_id The ID of the remote node manager.
   /// \return Void.
-  void ForwardTaskOrResubmit(const Task &task, const ClientID &node_manager_id);
-  /// Forward a task to another node to execute. The task is assumed to not be
-  /// queued in local_queues_.
+  void ForwardTasksOrResubmit(const std::vector<Task> &tasks,
+                              const ClientID &node_manager_id);
+  /// Resubmit tasks locally that could not be forwarded to a remote node
+  /// manager.
   ///
-  /// \param task The task to forward.
-  /// \param node_id The ID of the node to forward the task to.
-  /// \return A status indicating whether the forward succeeded or not. Note
-  /// that a status of OK is not a reliable indicator that the forward succeeded
-  /// or even that the remote node is still alive.
-  ray::Status ForwardTask(const Task &task, const ClientID &node_id);
+  /// \param tasks The tasks that could not be forwarded.
+  /// \param node_manager_id The ID of the remote node manager.
+  /// \return Void.
+  void ResubmitFailedForwards(const std::vector<Task> &tasks,
+                              const ClientID &node_manager_id);
+  /// Forward tasks to another node to execute, in a single message that
+  /// carries the union of the tasks' uncommitted lineage. The message is
+  /// written asynchronously. The tasks are assumed to not be queued in
+  /// local_queues_.
+  ///
+  /// \param tasks The tasks to forward, in the order that the receiving node
+  /// should submit them.
+  /// \param node_id The ID of the node to forward the tasks to.
+  /// \param on_error A callback to run with the tasks if the message could not
+  /// be written. Note that a successful write is not a reliable indicator that
+  /// the forward succeeded or even that the remote node is still alive.
+  /// \return Void.
+  void ForwardTasks(
+      const std::vector<Task> &tasks, const ClientID &node_id,
+      const std::function<void(const ray::Status &, const std::vector<Task> &)>
+          &on_error);
+  /// Hand responsibility for tasks over to the node that they were forwarded
+  /// to, once the message that forwards them has been written.
+  ///
+  /// \param tasks The forwarded tasks.
+  /// \param node_id The ID of the node that the tasks were forwarded to.
+  /// \return Void.
+  void FinishForwardedTasks(const std::vector<Task> &tasks, const ClientID &node_id);
   /// Dispatch locally scheduled tasks. This attempts the transition from "scheduled" to
   /// "running" task state.
   void DispatchTasks();
@@ -277,8 +373,10 @@ class NodeManager {
   /// Process client message of GetTask
   //
   /// \param client The client that sent the message.
+  /// \param message_data A pointer to the message data.
   /// \return Void.
-  void ProcessGetTaskMessage(const std::shared_ptr<LocalClientConnection> &client);
+  void ProcessGetTaskMessage(const std::shared_ptr<LocalClientConnection> &client,
+                             const uint8_t *message_data);
 
   /// Process client message of DisconnectClient
   //
@@ -330,13 +428,26 @@ class NodeManager {
   /// The time that the last heartbeat was sent at. Used to make sure we are
   /// keeping up with heartbeats.
   uint64_t last_heartbeat_at_ms_;
+  /// Whether a scheduling pass has been posted to the event loop and has not
+  /// run yet.
+  bool schedule_tasks_pending_;
+  /// Encodes the local resources into heartbeats.
+  HeartbeatEncoder heartbeat_encoder_;
   /// The resources local to this node.
   const SchedulingResources local_resources_;
   /// The resources (and specific resource IDs) that are currently available.
   ResourceIdSet local_available_resources_;
   std::unordered_map<ClientID, SchedulingResources> cluster_resource_map_;
+  /// The heartbeat decoder for each remote node manager.
+  std::unordered_map<ClientID, HeartbeatDecoder> heartbeat_decoders_;
   /// A pool of workers.
   WorkerPool worker_pool_;
+  /// The languages that the worker pool starts workers for.
+  std::vector<Language> worker_languages_;
+  /// Decides how to resize the worker pool based on the demand for workers.
+  WorkerPoolController worker_pool_controller_;
+  /// The timer used to resize the worker pool.
+  boost::asio::steady_timer worker_pool_timer_;
   /// A set of queues to maintain tasks.
   SchedulingQueue local_queues_;
   /// The scheduling policy in effect for this local scheduler.
@@ -345,10 +456,13 @@ class NodeManager {
   ReconstructionPolicy reconstruction_policy_;
   /// A manager to make waiting tasks's missing object dependencies available.
   TaskDependencyManager task_dependency_manager_;
+  /// The tasks pipelined to busy workers.
+  TaskPipeline task_pipeline_;
   /// The lineage cache for the GCS object and task tables.
   LineageCache lineage_cache_;
   std::vector<ClientID> remote_clients_;
-  std::unordered_map<ClientID, TcpServerConnection> remote_server_connections_;
+  std::unordered_map<ClientID, std::shared_ptr<TcpServerConnection>>
+      remote_server_connections_;
   /// A mapping from actor ID to registration information about that actor
   /// (including which node manager owns it).
   std::unordered_map<ActorID, ActorRegistration> actor_registry_;
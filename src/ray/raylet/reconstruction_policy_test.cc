@@ -7,6 +7,7 @@
 
 #include "ray/raylet/format/node_manager_generated.h"
 #include "ray/raylet/reconstruction_policy.h"
+#include "ray/raylet/task_lease_manager.h"
 
 #include "ray/object_manager/object_directory.h"
 
@@ -42,10 +43,19 @@ class MockObjectDirectory : public ObjectDirectoryInterface {
   MOCK_METHOD3(SubscribeObjectLocations,
                ray::Status(const ray::UniqueID &, const ObjectID &,
                            const OnLocationsFound &));
+  MOCK_METHOD3(SubscribeObjectLocations,
+               ray::Status(const ray::UniqueID &, const std::vector<ObjectID> &,
+                           const OnLocationsFound &));
   MOCK_METHOD2(UnsubscribeObjectLocations,
                ray::Status(const ray::UniqueID &, const ObjectID &));
+  MOCK_CONST_METHOD3(GetCachedLocations,
+                     bool(const ObjectID &, std::vector<ClientID> *, int64_t *));
+  MOCK_CONST_METHOD2(GetCachedPartialLocations,
+                     void(const ObjectID &, std::vector<ClientID> *));
   MOCK_METHOD3(ReportObjectAdded,
                ray::Status(const ObjectID &, const ClientID &, const ObjectInfoT &));
+  MOCK_METHOD2(ReportPartialObjectAdded,
+               ray::Status(const ObjectID &, const ClientID &));
   MOCK_METHOD2(ReportObjectRemoved, ray::Status(const ObjectID &, const ClientID &));
   MOCK_METHOD1(RunFunctionForEachClient, void(const InfoSuccessCallback &success_cb));
 
@@ -55,9 +65,13 @@ class MockObjectDirectory : public ObjectDirectoryInterface {
 };
 
 class MockGcs : public gcs::PubsubInterface<TaskID>,
+                public gcs::TableInterface<TaskID, TaskLeaseData>,
                 public ray::gcs::LogInterface<TaskID, TaskReconstructionData> {
  public:
-  MockGcs() : notification_callback_(nullptr), failure_callback_(nullptr){};
+  MockGcs()
+      : notification_callback_(nullptr),
+        failure_callback_(nullptr),
+        num_lease_writes_(0){};
 
   void Subscribe(const gcs::TaskLeaseTable::WriteCallback &notification_callback,
                  const gcs::TaskLeaseTable::FailureCallback &failure_callback) {
@@ -73,6 +87,19 @@ class MockGcs : public gcs::PubsubInterface<TaskID>,
     }
   }
 
+  Status Add(const JobID &job_id, const TaskID &task_id,
+             std::shared_ptr<TaskLeaseDataT> &task_lease_data,
+             const gcs::TableInterface<TaskID, TaskLeaseData>::WriteCallback &done) {
+    num_lease_writes_++;
+    Add(job_id, task_id, task_lease_data);
+    if (done != nullptr) {
+      done(nullptr, task_id, *task_lease_data);
+    }
+    return Status::OK();
+  }
+
+  int NumLeaseWrites() const { return num_lease_writes_; }
+
   Status RequestNotifications(const JobID &job_id, const TaskID &task_id,
                               const ClientID &client_id) {
     subscribed_tasks_.insert(task_id);
@@ -121,6 +148,7 @@ class MockGcs : public gcs::PubsubInterface<TaskID>,
  private:
   gcs::TaskLeaseTable::WriteCallback notification_callback_;
   gcs::TaskLeaseTable::FailureCallback failure_callback_;
+  int num_lease_writes_;
   std::unordered_map<TaskID, std::shared_ptr<TaskLeaseDataT>> task_lease_table_;
   std::unordered_set<TaskID> subscribed_tasks_;
   std::unordered_map<TaskID, std::vector<TaskReconstructionDataT>>
@@ -386,6 +414,39 @@ TEST_F(ReconstructionPolicyTest, TestSimultaneousReconstructionSuppressed) {
   ASSERT_EQ(reconstructed_tasks_[task_id], 1);
 }
 
+TEST_F(ReconstructionPolicyTest, TestReconstructionSuppressedByTaskLeaseManager) {
+  // Hold the leases for many tasks with a lease manager that shares the GCS,
+  // starting with leases as long as the reconstruction timeout.
+  TaskLeaseManager task_lease_manager(io_service_, ClientID::from_random(),
+                                      reconstruction_timeout_ms_,
+                                      /*tick_period_ms=*/5, mock_gcs_);
+  std::vector<TaskID> task_ids;
+  for (int i = 0; i < 100; i++) {
+    TaskID task_id = FinishTaskId(TaskID::from_random());
+    task_ids.push_back(task_id);
+    task_lease_manager.AcquireLease(task_id);
+    reconstruction_policy_->ListenAndMaybeReconstruct(ComputeReturnId(task_id, 1));
+  }
+  ASSERT_EQ(mock_gcs_.NumLeaseWrites(), 100);
+  // Run the test for much longer than the reconstruction timeout.
+  Run(reconstruction_timeout_ms_ * 4);
+  // Check that the renewed leases were observed and reconstruction is
+  // suppressed.
+  ASSERT_TRUE(reconstructed_tasks_.empty());
+  ASSERT_GT(mock_gcs_.NumLeaseWrites(), 100);
+
+  // Release the leases and run the test for longer than the last lease.
+  for (const auto &task_id : task_ids) {
+    task_lease_manager.ReleaseLease(task_id);
+  }
+  ASSERT_EQ(task_lease_manager.NumLeases(), 0u);
+  Run(reconstruction_timeout_ms_ * 12);
+  // Check that this time, reconstruction is triggered for every task.
+  for (const auto &task_id : task_ids) {
+    ASSERT_EQ(reconstructed_tasks_[task_id], 1);
+  }
+}
+
 }  // namespace raylet
 
 }  // namespace ray
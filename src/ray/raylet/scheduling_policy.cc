@@ -1,16 +1,168 @@
 #include "scheduling_policy.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
+#include <limits>
 
+#include "common/state/ray_config.h"
 #include "ray/util/logging.h"
 
 namespace ray {
 
 namespace raylet {
 
-SchedulingPolicy::SchedulingPolicy(const SchedulingQueue &scheduling_queue)
+SchedulingPolicy::SchedulingPolicy(const SchedulingQueue &scheduling_queue,
+                                   const ObjectLocationLookup &object_location_lookup)
     : scheduling_queue_(scheduling_queue),
-      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
+      object_location_lookup_(object_location_lookup),
+      node_selection_strategy_(static_cast<NodeSelectionStrategy>(
+          RayConfig::instance().scheduling_node_selection_strategy())),
+      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
+  const int strategy = RayConfig::instance().scheduling_node_selection_strategy();
+  RAY_CHECK(strategy >= static_cast<int>(NodeSelectionStrategy::kUniformRandom) &&
+            strategy <= static_cast<int>(NodeSelectionStrategy::kLeastLoaded))
+      << "Invalid scheduling_node_selection_strategy " << strategy;
+}
+
+std::unordered_map<ClientID, int64_t> SchedulingPolicy::GetArgumentLocality(
+    const TaskSpecification &spec) const {
+  std::unordered_map<ClientID, int64_t> locality;
+  if (object_location_lookup_ == nullptr) {
+    return locality;
+  }
+  std::vector<ClientID> client_ids;
+  for (int64_t i = 0; i < spec.NumArgs(); ++i) {
+    int count = spec.ArgIdCount(i);
+    for (int j = 0; j < count; j++) {
+      int64_t object_size = 0;
+      client_ids.clear();
+      if (!object_location_lookup_(spec.ArgId(i, j), &client_ids, &object_size)) {
+        continue;
+      }
+      for (const auto &client_id : client_ids) {
+        locality[client_id] += object_size;
+      }
+    }
+  }
+  return locality;
+}
+
+void SchedulingPolicy::SetNodeSelectionStrategy(NodeSelectionStrategy strategy) {
+  node_selection_strategy_ = strategy;
+}
+
+namespace {
+
+/// Get the number of CPUs in a resource set, or 0 if it has none.
+double GetCpus(const ResourceSet &resources) {
+  double num_cpus = 0;
+  if (!resources.GetResourceById(kCPU_ResourceId, &num_cpus)) {
+    return 0;
+  }
+  return num_cpus;
+}
+
+}  // namespace
+
+ClientID SchedulingPolicy::ChooseNode(
+    const TaskSpecification &spec, const std::vector<ClientID> &client_keys,
+    const std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
+    const std::unordered_map<ClientID, ResourceSet> &available_minus_load) {
+  RAY_CHECK(!client_keys.empty());
+  std::vector<ClientID> best_client_keys;
+  if (client_keys.size() > 1) {
+    // Narrow the candidates down to the nodes that already store the most
+    // bytes of the task's arguments.
+    const auto locality = GetArgumentLocality(spec);
+    int64_t best_bytes = 0;
+    for (const auto &client_id : client_keys) {
+      auto it = locality.find(client_id);
+      if (it == locality.end() || it->second < best_bytes) {
+        continue;
+      }
+      if (it->second > best_bytes) {
+        best_bytes = it->second;
+        best_client_keys.clear();
+      }
+      best_client_keys.push_back(client_id);
+    }
+  }
+  // If no argument locations are known, fall back to all candidates.
+  const auto &candidates = best_client_keys.empty() ? client_keys : best_client_keys;
+  if (candidates.size() == 1) {
+    return candidates.front();
+  }
+
+  // The fraction of a node's CPUs that are in use or claimed by its load.
+  // Nodes without CPUs are considered fully utilized.
+  auto utilization = [&cluster_resources,
+                      &available_minus_load](const ClientID &client_id) {
+    const auto &node_resources = cluster_resources.at(client_id);
+    const double total_cpus = GetCpus(node_resources.GetTotalResources());
+    if (total_cpus <= 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return 1 - GetCpus(available_minus_load.at(client_id)) / total_cpus;
+  };
+
+  switch (node_selection_strategy_) {
+  case NodeSelectionStrategy::kCapacityWeighted: {
+    std::vector<double> weights;
+    weights.reserve(candidates.size());
+    double total_weight = 0;
+    for (const auto &client_id : candidates) {
+      weights.push_back(GetCpus(cluster_resources.at(client_id).GetTotalResources()));
+      total_weight += weights.back();
+    }
+    if (total_weight > 0) {
+      std::discrete_distribution<int> distribution(weights.begin(), weights.end());
+      return candidates[distribution(gen_)];
+    }
+  } break;
+  case NodeSelectionStrategy::kPowerOfTwoChoices: {
+    // Sample two distinct candidates and keep the less utilized one.
+    std::uniform_int_distribution<int> first_distribution(0, candidates.size() - 1);
+    std::uniform_int_distribution<int> second_distribution(0, candidates.size() - 2);
+    const int first = first_distribution(gen_);
+    int second = second_distribution(gen_);
+    if (second >= first) {
+      second++;
+    }
+    return utilization(candidates[first]) <= utilization(candidates[second])
+               ? candidates[first]
+               : candidates[second];
+  }
+  case NodeSelectionStrategy::kLeastLoaded: {
+    // Break ties between the least utilized candidates at random.
+    std::vector<ClientID> least_loaded_client_keys;
+    double least_utilization = std::numeric_limits<double>::infinity();
+    for (const auto &client_id : candidates) {
+      const double node_utilization = utilization(client_id);
+      if (node_utilization > least_utilization) {
+        continue;
+      }
+      if (node_utilization < least_utilization) {
+        least_utilization = node_utilization;
+        least_loaded_client_keys.clear();
+      }
+      least_loaded_client_keys.push_back(client_id);
+    }
+    if (!least_loaded_client_keys.empty()) {
+      std::uniform_int_distribution<int> distribution(
+          0, least_loaded_client_keys.size() - 1);
+      return least_loaded_client_keys[distribution(gen_)];
+    }
+  } break;
+  case NodeSelectionStrategy::kUniformRandom:
+    break;
+  }
+
+  // Choose index at random.
+  // Initialize a uniform integer distribution over the key space.
+  std::uniform_int_distribution<int> distribution(0, candidates.size() - 1);
+  return candidates[distribution(gen_)];
+}
 
 std::unordered_map<TaskID, ClientID> SchedulingPolicy::Schedule(
     std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
@@ -30,117 +182,215 @@ std::unordered_map<TaskID, ClientID> SchedulingPolicy::Schedule(
   }
 #endif
 
-  // We expect all placeable tasks to be placed on exit from this policy method.
-  RAY_CHECK(scheduling_queue_.GetPlaceableTasks().size() <= 1);
-  // Iterate over running tasks, get their resource demand and try to schedule.
+  // Group the placeable tasks by priority and resource shape, so that the
+  // candidate nodes are computed once per shape instead of once per task. The
+  // placeable tasks are ordered by decreasing priority, so the groups are too
+  // and higher priority tasks get the first pick of the nodes. There are
+  // usually only a handful of distinct groups, so they are searched linearly.
+  using TaskGroup = std::vector<const Task *>;
+  std::vector<TaskGroup> task_groups;
   for (const auto &t : scheduling_queue_.GetPlaceableTasks()) {
-    // Get task's resource demand
-    const auto &resource_demand = t.GetTaskSpecification().GetRequiredResources();
-    const TaskID &task_id = t.GetTaskSpecification().TaskId();
-    RAY_LOG(DEBUG) << "[SchedulingPolicy]: task=" << task_id
-                   << " numforwards=" << t.GetTaskExecutionSpec().NumForwards()
-                   << " resources="
-                   << t.GetTaskSpecification().GetRequiredResources().ToString();
+    const auto &spec = t.GetTaskSpecification();
+    auto it = std::find_if(task_groups.begin(), task_groups.end(),
+                           [&spec](const TaskGroup &task_group) {
+                             const auto &group_spec =
+                                 task_group.front()->GetTaskSpecification();
+                             return group_spec.Priority() == spec.Priority() &&
+                                    group_spec.GetRequiredResources().IsEqual(
+                                        spec.GetRequiredResources());
+                           });
+    if (it == task_groups.end()) {
+      task_groups.emplace_back();
+      it = std::prev(task_groups.end());
+    }
+    it->push_back(&t);
+  }
+  if (task_groups.empty()) {
+    return decision;
+  }
 
+  // Take a single snapshot of each node's available resources minus its
+  // load. The snapshot is updated incrementally as tasks are assigned below.
+  std::unordered_map<ClientID, ResourceSet> available_minus_load;
+  for (const auto &client_resource_pair : cluster_resources) {
+    // pair = ClientID, SchedulingResources
+    const ClientID &node_client_id = client_resource_pair.first;
+    const auto &node_resources = client_resource_pair.second;
+    ResourceSet available_node_resources =
+        ResourceSet(node_resources.GetAvailableResources());
+    available_node_resources.SubtractResourcesStrict(node_resources.GetLoadResources());
+    RAY_LOG(DEBUG) << "client_id " << node_client_id
+                   << " avail: " << node_resources.GetAvailableResources().ToString()
+                   << " load: " << node_resources.GetLoadResources().ToString()
+                   << " avail-load: " << available_node_resources.ToString();
+    available_minus_load.emplace(node_client_id, std::move(available_node_resources));
+  }
+  // The load added to each node by this scheduling pass.
+  std::unordered_map<ClientID, ResourceSet> added_load;
+
+  for (const auto &task_group : task_groups) {
+    const ResourceSet &resource_demand =
+        task_group.front()->GetTaskSpecification().GetRequiredResources();
     // TODO(atumanov): try to place tasks locally first.
-    // Construct a set of viable node candidates and randomly pick between them.
-    // Get all the client id keys and randomly pick.
+    // Construct a set of viable node candidates for this resource shape.
     std::vector<ClientID> client_keys;
-    for (const auto &client_resource_pair : cluster_resources) {
-      // pair = ClientID, SchedulingResources
-      ClientID node_client_id = client_resource_pair.first;
-      const auto &node_resources = client_resource_pair.second;
-      ResourceSet available_node_resources =
-          ResourceSet(node_resources.GetAvailableResources());
-      available_node_resources.SubtractResourcesStrict(node_resources.GetLoadResources());
-      RAY_LOG(DEBUG) << "client_id " << node_client_id
-                     << " avail: " << node_resources.GetAvailableResources().ToString()
-                     << " load: " << node_resources.GetLoadResources().ToString()
-                     << " avail-load: " << available_node_resources.ToString();
-
-      if (resource_demand.IsSubset(available_node_resources)) {
+    for (const auto &node_resources_pair : available_minus_load) {
+      if (resource_demand.IsSubset(node_resources_pair.second)) {
         // This node is a feasible candidate.
-        client_keys.push_back(node_client_id);
+        client_keys.push_back(node_resources_pair.first);
       }
     }
+    // The nodes whose total resources fit this resource shape. These are only
+    // computed once the shape no longer fits in any node's available resources.
+    std::vector<ClientID> feasible_client_keys;
+    bool feasible_client_keys_computed = false;
 
-    if (!client_keys.empty()) {
-      // Choose index at random.
-      // Initialize a uniform integer distribution over the key space.
-      // TODO(atumanov): change uniform random to discrete, weighted by resource capacity.
-      std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
-      int client_key_index = distribution(gen_);
-      const ClientID &dst_client_id = client_keys[client_key_index];
-      decision[task_id] = dst_client_id;
-      // Update dst_client_id's load to keep track of remote task load until
-      // the next heartbeat.
-      ResourceSet new_load(cluster_resources[dst_client_id].GetLoadResources());
-      new_load.AddResources(resource_demand);
-      cluster_resources[dst_client_id].SetLoadResources(std::move(new_load));
-    } else {
-      // If the task doesn't fit, place randomly subject to hard constraints.
-      for (const auto &client_resource_pair2 : cluster_resources) {
-        // pair = ClientID, SchedulingResources
-        ClientID node_client_id = client_resource_pair2.first;
-        const auto &node_resources = client_resource_pair2.second;
-        if (resource_demand.IsSubset(node_resources.GetTotalResources())) {
-          // This node is a feasible candidate.
-          client_keys.push_back(node_client_id);
-        }
-      }
-      // client candidate list constructed, pick randomly.
+    for (const Task *t : task_group) {
+      const TaskSpecification &spec = t->GetTaskSpecification();
+      const TaskID &task_id = spec.TaskId();
+      RAY_LOG(DEBUG) << "[SchedulingPolicy]: task=" << task_id
+                     << " numforwards=" << t->GetTaskExecutionSpec().NumForwards()
+                     << " resources=" << resource_demand.ToString();
+
+      ClientID dst_client_id;
       if (!client_keys.empty()) {
-        // Choose index at random.
-        // Initialize a uniform integer distribution over the key space.
-        // TODO(atumanov): change uniform random to discrete, weighted by resource
-        // capacity.
-        std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
-        int client_key_index = distribution(gen_);
-        const ClientID &dst_client_id = client_keys[client_key_index];
-        decision[t.GetTaskSpecification().TaskId()] = dst_client_id;
-        // Update dst_client_id's load to keep track of remote task load until
-        // the next heartbeat.
-        ResourceSet new_load(cluster_resources[dst_client_id].GetLoadResources());
-        new_load.AddResources(resource_demand);
-        cluster_resources[dst_client_id].SetLoadResources(std::move(new_load));
+        // Choose a node, preferring nodes that store the task's arguments.
+        dst_client_id =
+            ChooseNode(spec, client_keys, cluster_resources, available_minus_load);
       } else {
-        // There are no nodes that can feasibly execute this task. The task remains
-        // placeable until cluster capacity becomes available.
-        // TODO(rkn): Propagate a warning to the user.
-        RAY_LOG(INFO) << "This task requires "
-                      << t.GetTaskSpecification().GetRequiredResources().ToString()
-                      << ", but no nodes have the necessary resources.";
+        // If the task doesn't fit, place randomly subject to hard constraints.
+        if (!feasible_client_keys_computed) {
+          for (const auto &client_resource_pair : cluster_resources) {
+            // pair = ClientID, SchedulingResources
+            const auto &node_resources = client_resource_pair.second;
+            if (resource_demand.IsSubset(node_resources.GetTotalResources())) {
+              // This node is a feasible candidate.
+              feasible_client_keys.push_back(client_resource_pair.first);
+            }
+          }
+          feasible_client_keys_computed = true;
+        }
+        if (feasible_client_keys.empty()) {
+          // There are no nodes that can feasibly execute this task. The task remains
+          // placeable until cluster capacity becomes available.
+          // TODO(rkn): Propagate a warning to the user.
+          RAY_LOG(INFO) << "This task requires " << resource_demand.ToString()
+                        << ", but no nodes have the necessary resources.";
+          continue;
+        }
+        dst_client_id = ChooseNode(spec, feasible_client_keys, cluster_resources,
+                                   available_minus_load);
       }
+      decision[task_id] = dst_client_id;
+
+      // Account for the task in the snapshot. Only the chosen node's
+      // resources changed, so it is the only candidate that may need to be
+      // dropped.
+      ResourceSet &node_available = available_minus_load[dst_client_id];
+      node_available.SubtractResourcesStrict(resource_demand);
+      if (!resource_demand.IsSubset(node_available)) {
+        auto it = std::find(client_keys.begin(), client_keys.end(), dst_client_id);
+        if (it != client_keys.end()) {
+          *it = client_keys.back();
+          client_keys.pop_back();
+        }
+      }
+      added_load[dst_client_id].AddResources(resource_demand);
     }
   }
 
+  // Update the chosen nodes' load to keep track of remote task load until the
+  // next heartbeat.
+  for (const auto &load_pair : added_load) {
+    SchedulingResources &node_resources = cluster_resources[load_pair.first];
+    ResourceSet new_load(node_resources.GetLoadResources());
+    new_load.AddResources(load_pair.second);
+    node_resources.SetLoadResources(std::move(new_load));
+  }
+
   return decision;
 }
 
 std::vector<TaskID> SchedulingPolicy::SpillOver(
+    const ClientID &remote_client_id,
     SchedulingResources &remote_scheduling_resources) const {
   // The policy decision to be returned.
   std::vector<TaskID> decision;
 
   ResourceSet new_load(remote_scheduling_resources.GetLoadResources());
+  // The resources on the remote node that are not in use or claimed by its
+  // load. The return value is ignored, since the load may exceed the
+  // available resources.
+  ResourceSet headroom(remote_scheduling_resources.GetAvailableResources());
+  headroom.SubtractResourcesStrict(new_load);
 
   // Check if we can accommodate an infeasible task.
   for (const auto &task : scheduling_queue_.GetInfeasibleTasks()) {
-    if (task.GetTaskSpecification().GetRequiredResources().IsSubset(
-            remote_scheduling_resources.GetTotalResources())) {
+    const auto &resource_demand = task.GetTaskSpecification().GetRequiredResources();
+    if (resource_demand.IsSubset(remote_scheduling_resources.GetTotalResources())) {
       decision.push_back(task.GetTaskSpecification().TaskId());
-      new_load.AddResources(task.GetTaskSpecification().GetRequiredResources());
+      new_load.AddResources(resource_demand);
+      headroom.SubtractResourcesStrict(resource_demand);
+    }
+  }
+
+  // Collect the ready tasks that fit in the remote node's headroom, separating
+  // the tasks that have arguments stored on the remote node, which are
+  // cheaper to run there. The ready tasks are visited by resource shape, so
+  // that the shapes that do not fit are skipped without visiting their tasks,
+  // and the number of tasks examined is capped, so that the cost per heartbeat
+  // does not grow with the ready queue. Stop early once enough tasks with
+  // arguments on the remote node have been found.
+  const int64_t max_tasks = RayConfig::instance().max_tasks_to_spillover();
+  const int64_t max_examined = RayConfig::instance().max_tasks_examined_for_spillover();
+  int64_t num_examined = 0;
+  std::vector<const Task *> remote_input_tasks;
+  std::vector<const Task *> other_tasks;
+  auto done = [&]() {
+    return num_examined >= max_examined ||
+           static_cast<int64_t>(remote_input_tasks.size()) >= max_tasks;
+  };
+  for (const auto &bucket : scheduling_queue_.GetReadyTasksByShape()) {
+    if (done()) {
+      break;
+    }
+    if (!bucket.resources.IsSubset(headroom)) {
+      continue;
+    }
+    for (const auto &task_id : bucket.task_ids) {
+      if (done()) {
+        break;
+      }
+      num_examined++;
+      const Task &task = scheduling_queue_.GetReadyTask(task_id);
+      const auto &spec = task.GetTaskSpecification();
+      if (spec.IsActorTask()) {
+        continue;
+      }
+      if (GetArgumentLocality(spec).count(remote_client_id) > 0) {
+        remote_input_tasks.push_back(&task);
+      } else if (static_cast<int64_t>(other_tasks.size()) < max_tasks) {
+        other_tasks.push_back(&task);
+      }
     }
   }
 
-  for (const auto &task : scheduling_queue_.GetReadyTasks()) {
-    if (!task.GetTaskSpecification().IsActorTask()) {
-      if (task.GetTaskSpecification().GetRequiredResources().IsSubset(
-              remote_scheduling_resources.GetTotalResources())) {
-        decision.push_back(task.GetTaskSpecification().TaskId());
-        new_load.AddResources(task.GetTaskSpecification().GetRequiredResources());
+  // Choose tasks until the cap is reached. Each task claims its resources from
+  // the headroom, so later tasks may no longer fit.
+  int64_t num_spilled = 0;
+  for (const auto *candidates : {&remote_input_tasks, &other_tasks}) {
+    for (const Task *task : *candidates) {
+      if (num_spilled >= max_tasks) {
         break;
       }
+      const auto &resource_demand = task->GetTaskSpecification().GetRequiredResources();
+      if (!resource_demand.IsSubset(headroom)) {
+        continue;
+      }
+      decision.push_back(task->GetTaskSpecification().TaskId());
+      new_load.AddResources(resource_demand);
+      headroom.SubtractResourcesStrict(resource_demand);
+      num_spilled++;
     }
   }
   remote_scheduling_resources.SetLoadResources(std::move(new_load));
@@ -1,6 +1,7 @@
 #ifndef RAY_RAYLET_SCHEDULING_POLICY_H
 #define RAY_RAYLET_SCHEDULING_POLICY_H
 
+#include <functional>
 #include <random>
 #include <unordered_map>
 
@@ -11,6 +12,20 @@ namespace ray {
 
 namespace raylet {
 
+/// A function that looks up the known locations and size of an object. It
+/// returns false if nothing is known about the object.
+using ObjectLocationLookup = std::function<bool(
+    const ObjectID &object_id, std::vector<ClientID> *client_ids, int64_t *object_size)>;
+
+/// The strategy used to choose between the candidate nodes for a task. The
+/// values match RayConfig::scheduling_node_selection_strategy().
+enum class NodeSelectionStrategy : int {
+  kUniformRandom = 0,      ///< Pick a node uniformly at random.
+  kCapacityWeighted = 1,   ///< Pick a node at random, weighted by its CPUs.
+  kPowerOfTwoChoices = 2,  ///< Pick the less utilized of two random nodes.
+  kLeastLoaded = 3         ///< Pick the least utilized node.
+};
+
 /// \class SchedulingPolicy
 /// \brief Implements a scheduling policy for the node manager.
 class SchedulingPolicy {
@@ -19,11 +34,19 @@ class SchedulingPolicy {
   ///
   /// \param scheduling_queue: reference to a scheduler queues object for access to
   /// tasks.
+  /// \param object_location_lookup: a function used to look up the known
+  /// locations and sizes of task arguments without contacting the GCS. If
+  /// provided, tasks are preferentially placed on the feasible node that
+  /// stores the most bytes of their arguments.
   /// \return Void.
-  SchedulingPolicy(const SchedulingQueue &scheduling_queue);
+  SchedulingPolicy(const SchedulingQueue &scheduling_queue,
+                   const ObjectLocationLookup &object_location_lookup = nullptr);
 
   /// \brief Perform a scheduling operation, given a set of cluster resources and
-  /// producing a mapping of tasks to raylets.
+  /// producing a mapping of tasks to raylets. All placeable tasks are scheduled
+  /// in one pass against a single snapshot of the cluster resources, in order
+  /// of decreasing priority. Tasks that cannot be placed on any node remain
+  /// placeable.
   ///
   /// \param cluster_resources: a set of cluster resources containing resource and load
   /// information for some subset of the cluster. For all client IDs in the returned
@@ -36,14 +59,64 @@ class SchedulingPolicy {
       std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
       const ClientID &local_client_id);
 
-  std::vector<TaskID> SpillOver(SchedulingResources &remote_scheduling_resources) const;
+  /// \brief Choose tasks to spill over to a remote node. Infeasible tasks that
+  /// fit the remote node's total resources are always chosen. Ready non-actor
+  /// tasks are chosen as long as they fit in the remote node's available
+  /// resources minus its load, up to RayConfig::max_tasks_to_spillover() tasks.
+  /// Ready tasks that have arguments stored on the remote node are chosen
+  /// first, and otherwise tasks are considered in order of decreasing priority.
+  /// At most RayConfig::max_tasks_examined_for_spillover() ready tasks are
+  /// examined.
+  ///
+  /// \param remote_client_id The ID of the remote node.
+  /// \param remote_scheduling_resources The resources of the remote node. Its
+  /// load is incremented by the resource demand of the chosen tasks.
+  /// \return The IDs of the tasks to spill over to the remote node.
+  std::vector<TaskID> SpillOver(const ClientID &remote_client_id,
+                                SchedulingResources &remote_scheduling_resources) const;
+
+  /// \brief Override the node selection strategy configured in RayConfig.
+  ///
+  /// \param strategy: the strategy used to choose between candidate nodes.
+  /// \return Void.
+  void SetNodeSelectionStrategy(NodeSelectionStrategy strategy);
 
   /// \brief SchedulingPolicy destructor.
   virtual ~SchedulingPolicy();
 
  private:
+  /// \brief Compute the number of bytes of a task's by-reference arguments
+  /// that are known to be stored on each node.
+  ///
+  /// \param spec: the specification of the task.
+  /// \return A mapping from node ID to the number of argument bytes stored on
+  /// that node. Nodes that store none of the arguments are omitted.
+  std::unordered_map<ClientID, int64_t> GetArgumentLocality(
+      const TaskSpecification &spec) const;
+
+  /// \brief Choose a node to place a task on from a set of candidate nodes.
+  /// Candidates that store the most bytes of the task's arguments are
+  /// preferred. The remaining ties, including the case where no argument
+  /// locations are known, are broken by the node selection strategy.
+  ///
+  /// \param spec: the specification of the task to place.
+  /// \param client_keys: the non-empty list of candidate nodes.
+  /// \param cluster_resources: the resources of every node in the cluster.
+  /// \param available_minus_load: each node's available resources minus its
+  /// load, including the tasks already placed in this scheduling pass.
+  /// \return The chosen node.
+  ClientID ChooseNode(
+      const TaskSpecification &spec, const std::vector<ClientID> &client_keys,
+      const std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
+      const std::unordered_map<ClientID, ResourceSet> &available_minus_load);
+
   /// An immutable reference to the scheduling task queues.
   const SchedulingQueue &scheduling_queue_;
+  /// A function to look up task argument locations. This is nullptr if tasks
+  /// are placed without regard to where their arguments are stored.
+  ObjectLocationLookup object_location_lookup_;
+  /// The strategy used to choose between candidate nodes.
+  NodeSelectionStrategy node_selection_strategy_;
   /// Internally maintained random number generator.
   std::mt19937_64 gen_;
 };
@@ -0,0 +1,298 @@
+#include <deque>
+
+#include "gtest/gtest.h"
+
+#include "common/state/ray_config.h"
+#include "ray/raylet/scheduling_policy.h"
+#include "ray/raylet/test_util.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// A simulated node that runs 1-CPU tasks for a fixed number of rounds and
+/// queues the tasks it has no free CPUs for.
+struct SimulatedNode {
+  SimulatedNode(int num_cpus) : num_cpus(num_cpus) {}
+
+  int num_cpus;
+  /// The round in which each running task finishes.
+  std::deque<int> running;
+  /// The round in which each queued task was placed.
+  std::deque<int> queued;
+};
+
+/// Simulate bursts of 1-CPU tasks placed by the scheduling policy on a
+/// cluster with a few large and many small nodes.
+///
+/// \param strategy The node selection strategy to use.
+/// \return The mean number of rounds that a task spent queued on its node.
+double MeanQueueingDelay(NodeSelectionStrategy strategy) {
+  const int num_rounds = 400;
+  const int burst_period = 10;
+  const int tasks_per_burst = 480;
+  const int task_duration = 4;
+
+  // 6 nodes with 8 CPUs and 2 nodes with 96 CPUs, i.e., 60 tasks per round,
+  // so the bursts keep the cluster at 80% utilization.
+  std::unordered_map<ClientID, SimulatedNode> nodes;
+  for (int i = 0; i < 6; i++) {
+    nodes.emplace(ClientID::from_random(), SimulatedNode(8));
+  }
+  for (int i = 0; i < 2; i++) {
+    nodes.emplace(ClientID::from_random(), SimulatedNode(96));
+  }
+
+  SchedulingQueue queue;
+  SchedulingPolicy policy(queue);
+  policy.SetNodeSelectionStrategy(strategy);
+
+  int64_t total_delay = 0;
+  int64_t num_started = 0;
+  for (int round = 0; round < num_rounds; round++) {
+    std::unordered_map<ClientID, SchedulingResources> cluster_resources;
+    for (auto &node_pair : nodes) {
+      SimulatedNode &node = node_pair.second;
+      // Finish tasks and start queued ones on the freed CPUs.
+      while (!node.running.empty() && node.running.front() <= round) {
+        node.running.pop_front();
+      }
+      while (!node.queued.empty() &&
+             static_cast<int>(node.running.size()) < node.num_cpus) {
+        total_delay += round - node.queued.front();
+        num_started++;
+        node.queued.pop_front();
+        node.running.push_back(round + task_duration);
+      }
+
+      const double num_cpus = node.num_cpus;
+      const double num_running = node.running.size();
+      const double num_queued = node.queued.size();
+      SchedulingResources resources(ResourceSet(
+          std::unordered_map<std::string, double>({{kCPU_ResourceLabel, num_cpus}})));
+      resources.SetAvailableResources(ResourceSet(std::unordered_map<std::string, double>(
+          {{kCPU_ResourceLabel, num_cpus - num_running}})));
+      resources.SetLoadResources(ResourceSet(
+          std::unordered_map<std::string, double>({{kCPU_ResourceLabel, num_queued}})));
+      cluster_resources.emplace(node_pair.first, std::move(resources));
+    }
+
+    if (round % burst_period != 0) {
+      continue;
+    }
+    std::vector<Task> tasks;
+    for (int i = 0; i < tasks_per_burst; i++) {
+      tasks.push_back(ExampleTask(1));
+    }
+    queue.QueuePlaceableTasks(tasks);
+    auto decision = policy.Schedule(cluster_resources, ClientID::nil());
+    EXPECT_EQ(decision.size(), tasks.size());
+    std::unordered_set<TaskID> task_ids;
+    for (const auto &task_client_pair : decision) {
+      task_ids.insert(task_client_pair.first);
+      nodes.at(task_client_pair.second).queued.push_back(round);
+    }
+    queue.RemoveTasks(task_ids);
+  }
+  return static_cast<double>(total_delay) / num_started;
+}
+
+TEST(SchedulingPolicyTest, TestQueueingDelayWithSkewedNodes) {
+  const double uniform_delay = MeanQueueingDelay(NodeSelectionStrategy::kUniformRandom);
+  const double weighted_delay =
+      MeanQueueingDelay(NodeSelectionStrategy::kCapacityWeighted);
+  const double two_choices_delay =
+      MeanQueueingDelay(NodeSelectionStrategy::kPowerOfTwoChoices);
+  const double least_loaded_delay =
+      MeanQueueingDelay(NodeSelectionStrategy::kLeastLoaded);
+  RAY_LOG(INFO) << "Mean queueing delay in rounds: uniform " << uniform_delay
+                << ", capacity-weighted " << weighted_delay << ", power-of-two-choices "
+                << two_choices_delay << ", least-loaded " << least_loaded_delay;
+  // Uniform placement overloads the small nodes, so every load-aware strategy
+  // should do better.
+  ASSERT_LT(weighted_delay, uniform_delay);
+  ASSERT_LT(two_choices_delay, uniform_delay);
+  ASSERT_LT(least_loaded_delay, uniform_delay);
+}
+
+TEST(SchedulingPolicyTest, TestScheduleManyTasksInOnePass) {
+  SchedulingQueue queue;
+  SchedulingPolicy policy(queue);
+  policy.SetNodeSelectionStrategy(NodeSelectionStrategy::kUniformRandom);
+
+  // 4 nodes with 4 CPUs each, one of which already has 2 CPUs claimed by its
+  // load.
+  std::unordered_map<ClientID, SchedulingResources> cluster_resources;
+  std::vector<ClientID> client_ids;
+  for (int i = 0; i < 4; i++) {
+    client_ids.push_back(ClientID::from_random());
+    cluster_resources.emplace(client_ids.back(),
+                              SchedulingResources(ResourceSet(
+                                  std::unordered_map<std::string, double>(
+                                      {{kCPU_ResourceLabel, 4}}))));
+  }
+  cluster_resources[client_ids[0]].SetLoadResources(ResourceSet(
+      std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 2}})));
+
+  // All 14 tasks that fit in the cluster's available resources minus its load
+  // are placed in one call, without placing more tasks on a node than fit.
+  std::vector<Task> tasks;
+  for (int i = 0; i < 14; i++) {
+    tasks.push_back(ExampleTask(1));
+  }
+  queue.QueuePlaceableTasks(tasks);
+  auto decision = policy.Schedule(cluster_resources, client_ids[0]);
+  ASSERT_EQ(decision.size(), tasks.size());
+  std::unordered_map<ClientID, int> num_tasks_per_node;
+  for (const auto &task_client_pair : decision) {
+    num_tasks_per_node[task_client_pair.second]++;
+  }
+  ASSERT_EQ(num_tasks_per_node[client_ids[0]], 2);
+  for (int i = 1; i < 4; i++) {
+    ASSERT_EQ(num_tasks_per_node[client_ids[i]], 4);
+  }
+  // Each node's load now covers its available resources.
+  for (const auto &client_id : client_ids) {
+    ASSERT_EQ(cluster_resources[client_id].GetLoadResources().GetNumCpus(), 4);
+  }
+}
+
+TEST(SchedulingPolicyTest, TestPlaceNearArguments) {
+  const ClientID small_holder_id = ClientID::from_random();
+  const ClientID large_holder_id = ClientID::from_random();
+  const ClientID other_client_id = ClientID::from_random();
+  const ObjectID small_object_id = ObjectID::from_random();
+  const ObjectID large_object_id = ObjectID::from_random();
+  SchedulingQueue queue;
+  SchedulingPolicy policy(queue, [=](const ObjectID &object_id,
+                                     std::vector<ClientID> *client_ids,
+                                     int64_t *object_size) {
+    if (object_id == small_object_id) {
+      *client_ids = {small_holder_id, large_holder_id};
+      *object_size = 100;
+    } else if (object_id == large_object_id) {
+      *client_ids = {large_holder_id};
+      *object_size = 1000;
+    } else {
+      return false;
+    }
+    return true;
+  });
+
+  for (int i = 0; i < 20; i++) {
+    std::unordered_map<ClientID, SchedulingResources> cluster_resources;
+    for (const auto &client_id : {small_holder_id, large_holder_id, other_client_id}) {
+      cluster_resources.emplace(client_id,
+                                SchedulingResources(ResourceSet(
+                                    std::unordered_map<std::string, double>(
+                                        {{kCPU_ResourceLabel, 4}}))));
+    }
+    // The task is placed on the node that stores the most bytes of its
+    // arguments, and the task with one argument on a node that stores it.
+    const Task both_arguments_task = ExampleTask(1, {small_object_id, large_object_id});
+    const Task small_argument_task = ExampleTask(1, {small_object_id});
+    queue.QueuePlaceableTasks({both_arguments_task, small_argument_task});
+    auto decision = policy.Schedule(cluster_resources, other_client_id);
+    ASSERT_EQ(decision.size(), 2u);
+    ASSERT_EQ(decision[both_arguments_task.GetTaskSpecification().TaskId()],
+              large_holder_id);
+    ASSERT_NE(decision[small_argument_task.GetTaskSpecification().TaskId()],
+              other_client_id);
+    std::unordered_set<TaskID> task_ids = {
+        both_arguments_task.GetTaskSpecification().TaskId(),
+        small_argument_task.GetTaskSpecification().TaskId()};
+    queue.RemoveTasks(task_ids);
+  }
+}
+
+TEST(SchedulingPolicyTest, TestSpillOverMultipleTasks) {
+  const ClientID remote_client_id = ClientID::from_random();
+  const ObjectID remote_object_id = ObjectID::from_random();
+  SchedulingQueue queue;
+  SchedulingPolicy policy(queue, [remote_client_id, remote_object_id](
+                                     const ObjectID &object_id,
+                                     std::vector<ClientID> *client_ids,
+                                     int64_t *object_size) {
+    if (object_id != remote_object_id) {
+      return false;
+    }
+    client_ids->push_back(remote_client_id);
+    *object_size = 100;
+    return true;
+  });
+
+  // The remote node has 8 CPUs, 1 of which is claimed by its load, so 7
+  // 1-CPU tasks fit. The task whose argument is on the remote node goes first.
+  std::vector<Task> tasks;
+  for (int i = 0; i < 9; i++) {
+    tasks.push_back(ExampleTask(1));
+  }
+  tasks.push_back(ExampleTask(1, {remote_object_id}));
+  queue.QueueReadyTasks(tasks);
+  SchedulingResources remote_resources(ResourceSet(
+      std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 8}})));
+  remote_resources.SetLoadResources(ResourceSet(
+      std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 1}})));
+  auto decision = policy.SpillOver(remote_client_id, remote_resources);
+  ASSERT_EQ(decision.size(), 7u);
+  ASSERT_EQ(decision.front(), tasks.back().GetTaskSpecification().TaskId());
+  ASSERT_EQ(remote_resources.GetLoadResources().GetNumCpus(), 8);
+
+  // Now that the remote node's load covers its available resources, nothing
+  // else is spilled over.
+  ASSERT_TRUE(policy.SpillOver(remote_client_id, remote_resources).empty());
+
+  // The number of tasks spilled over at once is capped.
+  SchedulingResources large_remote_resources(ResourceSet(
+      std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 100}})));
+  decision = policy.SpillOver(ClientID::from_random(), large_remote_resources);
+  ASSERT_EQ(decision.size(),
+            static_cast<size_t>(RayConfig::instance().max_tasks_to_spillover()));
+}
+
+TEST(SchedulingPolicyTest, TestSpillOverExaminesBoundedTasks) {
+  const ClientID remote_client_id = ClientID::from_random();
+  const ObjectID remote_object_id = ObjectID::from_random();
+  SchedulingQueue queue;
+  SchedulingPolicy policy(queue, [remote_client_id, remote_object_id](
+                                     const ObjectID &object_id,
+                                     std::vector<ClientID> *client_ids,
+                                     int64_t *object_size) {
+    if (object_id != remote_object_id) {
+      return false;
+    }
+    client_ids->push_back(remote_client_id);
+    *object_size = 100;
+    return true;
+  });
+
+  // Tasks whose shape does not fit the remote node are skipped without being
+  // examined, so they do not count towards the cap.
+  const int64_t max_examined = RayConfig::instance().max_tasks_examined_for_spillover();
+  std::vector<Task> tasks;
+  for (int64_t i = 0; i < 2 * max_examined; i++) {
+    tasks.push_back(ExampleTask(1000));
+  }
+  // The task with an argument on the remote node is queued behind more tasks
+  // than are examined, so it is not found.
+  for (int64_t i = 0; i < max_examined; i++) {
+    tasks.push_back(ExampleTask(1));
+  }
+  tasks.push_back(ExampleTask(1, {remote_object_id}));
+  queue.QueueReadyTasks(tasks);
+  SchedulingResources remote_resources(ResourceSet(
+      std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 100}})));
+  auto decision = policy.SpillOver(remote_client_id, remote_resources);
+  ASSERT_EQ(decision.size(),
+            static_cast<size_t>(RayConfig::instance().max_tasks_to_spillover()));
+  for (const auto &task_id : decision) {
+    ASSERT_NE(task_id, tasks.back().GetTaskSpecification().TaskId());
+    ASSERT_EQ(queue.GetReadyTask(task_id).GetTaskSpecification().GetRequiredResources()
+                  .GetNumCpus(),
+              1);
+  }
+}
+
+}  // namespace raylet
+
+}  // namespace ray
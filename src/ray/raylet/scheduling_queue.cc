@@ -78,8 +78,21 @@ SchedulingQueue::TaskQueue::~TaskQueue() {
 
 bool SchedulingQueue::TaskQueue::AppendTask(const TaskID &task_id, const Task &task) {
   RAY_CHECK(task_map_.find(task_id) == task_map_.end());
-  auto list_iterator = task_list_.insert(task_list_.end(), task);
+  const int64_t priority = task.GetTaskSpecification().Priority();
+  // Insert the task before the first task with a lower priority.
+  auto lower_priority_group = priority_groups_.upper_bound(priority);
+  auto position = lower_priority_group == priority_groups_.end()
+                      ? task_list_.end()
+                      : lower_priority_group->second.first;
+  auto list_iterator = task_list_.insert(position, task);
+  auto group = priority_groups_.find(priority);
+  if (group == priority_groups_.end()) {
+    priority_groups_.emplace(priority, std::make_pair(list_iterator, 1));
+  } else {
+    group->second.second++;
+  }
   task_map_[task_id] = list_iterator;
+  current_resource_load_.AddResources(task.GetTaskSpecification().GetRequiredResources());
   return true;
 }
 
@@ -90,6 +103,8 @@ bool SchedulingQueue::TaskQueue::RemoveTask(const TaskID &task_id) {
   }
 
   auto list_iterator = task_found_iterator->second;
+  SubtractResourceLoad(*list_iterator);
+  RemoveFromPriorityGroup(list_iterator);
   task_map_.erase(task_found_iterator);
   task_list_.erase(list_iterator);
   return true;
@@ -103,6 +118,8 @@ bool SchedulingQueue::TaskQueue::RemoveTask(const TaskID &task_id,
   }
 
   auto list_iterator = task_found_iterator->second;
+  SubtractResourceLoad(*list_iterator);
+  RemoveFromPriorityGroup(list_iterator);
   removed_tasks.push_back(std::move(*list_iterator));
   task_map_.erase(task_found_iterator);
   task_list_.erase(list_iterator);
@@ -115,6 +132,146 @@ bool SchedulingQueue::TaskQueue::HasTask(const TaskID &task_id) const {
 
 const std::list<Task> &SchedulingQueue::TaskQueue::GetTasks() const { return task_list_; }
 
+const Task &SchedulingQueue::TaskQueue::GetTask(const TaskID &task_id) const {
+  auto it = task_map_.find(task_id);
+  RAY_CHECK(it != task_map_.end());
+  return *it->second;
+}
+
+const ResourceSet &SchedulingQueue::TaskQueue::GetCurrentResourceLoad() const {
+  return current_resource_load_;
+}
+
+void SchedulingQueue::TaskQueue::SubtractResourceLoad(const Task &task) {
+  if (task_map_.size() == 1) {
+    // The last task is being removed. Reset the load instead of subtracting,
+    // so that floating point error does not accumulate over time.
+    current_resource_load_ = ResourceSet();
+    return;
+  }
+  // The return value is ignored, since rounding may leave a resource slightly
+  // below zero.
+  current_resource_load_.SubtractResourcesStrict(
+      task.GetTaskSpecification().GetRequiredResources());
+}
+
+void SchedulingQueue::TaskQueue::RemoveFromPriorityGroup(
+    std::list<Task>::iterator list_iterator) {
+  auto group = priority_groups_.find(list_iterator->GetTaskSpecification().Priority());
+  RAY_CHECK(group != priority_groups_.end());
+  if (--group->second.second == 0) {
+    priority_groups_.erase(group);
+  } else if (group->second.first == list_iterator) {
+    // The group is contiguous, so the next task has the same priority.
+    group->second.first = std::next(list_iterator);
+  }
+}
+
+bool SchedulingQueue::ReadyQueue::AppendTask(const TaskID &task_id, const Task &task) {
+  if (!TaskQueue::AppendTask(task_id, task)) {
+    return false;
+  }
+  const int64_t priority = task.GetTaskSpecification().Priority();
+  const auto &resource_demand = task.GetTaskSpecification().GetRequiredResources();
+  auto key = GetShapeKey(priority, resource_demand);
+  auto it = shape_bucket_map_.find(key);
+  std::list<ResourceShapeBucket>::iterator bucket;
+  if (it != shape_bucket_map_.end()) {
+    bucket = it->second;
+  } else {
+    // Insert the group before the first group with a lower priority.
+    auto lower_priority_buckets = priority_buckets_.upper_bound(priority);
+    auto position = lower_priority_buckets == priority_buckets_.end()
+                        ? shape_buckets_.end()
+                        : lower_priority_buckets->second.first;
+    bucket = shape_buckets_.emplace(position, priority, resource_demand);
+    shape_bucket_map_.emplace(std::move(key), bucket);
+    auto same_priority_buckets = priority_buckets_.find(priority);
+    if (same_priority_buckets == priority_buckets_.end()) {
+      priority_buckets_.emplace(priority, std::make_pair(bucket, 1));
+    } else {
+      same_priority_buckets->second.second++;
+    }
+  }
+  auto position = bucket->task_ids.insert(bucket->task_ids.end(), task_id);
+  shape_bucket_index_.emplace(task_id, std::make_pair(bucket, position));
+  UpdateNumNonActorTasks(task, 1);
+  return true;
+}
+
+bool SchedulingQueue::ReadyQueue::RemoveTask(const TaskID &task_id) {
+  if (HasTask(task_id)) {
+    UpdateNumNonActorTasks(GetTask(task_id), -1);
+  }
+  if (!TaskQueue::RemoveTask(task_id)) {
+    return false;
+  }
+  RemoveFromShapeBucket(task_id);
+  return true;
+}
+
+bool SchedulingQueue::ReadyQueue::RemoveTask(const TaskID &task_id,
+                                             std::vector<Task> &removed_tasks) {
+  if (HasTask(task_id)) {
+    UpdateNumNonActorTasks(GetTask(task_id), -1);
+  }
+  if (!TaskQueue::RemoveTask(task_id, removed_tasks)) {
+    return false;
+  }
+  RemoveFromShapeBucket(task_id);
+  return true;
+}
+
+void SchedulingQueue::ReadyQueue::RemoveFromShapeBucket(const TaskID &task_id) {
+  auto it = shape_bucket_index_.find(task_id);
+  RAY_CHECK(it != shape_bucket_index_.end());
+  auto bucket = it->second.first;
+  bucket->task_ids.erase(it->second.second);
+  shape_bucket_index_.erase(it);
+  if (!bucket->task_ids.empty()) {
+    return;
+  }
+  shape_bucket_map_.erase(GetShapeKey(bucket->priority, bucket->resources));
+  auto same_priority_buckets = priority_buckets_.find(bucket->priority);
+  RAY_CHECK(same_priority_buckets != priority_buckets_.end());
+  if (--same_priority_buckets->second.second == 0) {
+    priority_buckets_.erase(same_priority_buckets);
+  } else if (same_priority_buckets->second.first == bucket) {
+    // The groups are contiguous, so the next group has the same priority.
+    same_priority_buckets->second.first = std::next(bucket);
+  }
+  shape_buckets_.erase(bucket);
+}
+
+void SchedulingQueue::ReadyQueue::UpdateNumNonActorTasks(const Task &task,
+                                                         int64_t delta) {
+  const auto &spec = task.GetTaskSpecification();
+  if (spec.IsActorTask()) {
+    return;
+  }
+  auto it = num_non_actor_tasks_.emplace(spec.GetLanguage(), 0).first;
+  it->second += delta;
+  RAY_CHECK(it->second >= 0);
+}
+
+int64_t SchedulingQueue::ReadyQueue::GetNumNonActorTasks(const Language &language) const {
+  auto it = num_non_actor_tasks_.find(language);
+  return it == num_non_actor_tasks_.end() ? 0 : it->second;
+}
+
+SchedulingQueue::ReadyQueue::ShapeKey SchedulingQueue::ReadyQueue::GetShapeKey(
+    int64_t priority, const ResourceSet &resources) {
+  ShapeKey key;
+  std::get<0>(key) = priority;
+  resources.GetResourceIds(&std::get<1>(key), &std::get<2>(key));
+  return key;
+}
+
+const std::list<ResourceShapeBucket> &SchedulingQueue::ReadyQueue::GetShapeBuckets()
+    const {
+  return shape_buckets_;
+}
+
 const std::list<Task> &SchedulingQueue::GetMethodsWaitingForActorCreation() const {
   return this->methods_waiting_for_actor_creation_.GetTasks();
 }
@@ -131,18 +288,24 @@ const std::list<Task> &SchedulingQueue::GetReadyTasks() const {
   return this->ready_tasks_.GetTasks();
 }
 
+const std::list<ResourceShapeBucket> &SchedulingQueue::GetReadyTasksByShape() const {
+  return this->ready_tasks_.GetShapeBuckets();
+}
+
+int64_t SchedulingQueue::GetNumReadyNonActorTasks(const Language &language) const {
+  return this->ready_tasks_.GetNumNonActorTasks(language);
+}
+
+const Task &SchedulingQueue::GetReadyTask(const TaskID &task_id) const {
+  return this->ready_tasks_.GetTask(task_id);
+}
+
 const std::list<Task> &SchedulingQueue::GetInfeasibleTasks() const {
   return this->infeasible_tasks_.GetTasks();
 }
 
 ResourceSet SchedulingQueue::GetQueueResources(const TaskQueue &task_queue) const {
-  // Iterate over all tasks of the specified queue and aggregate total resource
-  // demand in a resource set.
-  ResourceSet queue_resources;
-  for (const auto &task : task_queue.GetTasks()) {
-    queue_resources.AddResources(task.GetTaskSpecification().GetRequiredResources());
-  }
-  return queue_resources;
+  return task_queue.GetCurrentResourceLoad();
 }
 
 ResourceSet SchedulingQueue::GetReadyQueueResources() const {
@@ -201,6 +364,29 @@ void SchedulingQueue::FilterState(std::unordered_set<TaskID> &task_ids,
   }
 }
 
+const Task &SchedulingQueue::GetTaskOfState(const TaskID &task_id,
+                                            TaskState task_state) const {
+  switch (task_state) {
+  case TaskState::PLACEABLE:
+    return placeable_tasks_.GetTask(task_id);
+  case TaskState::WAITING:
+    return waiting_tasks_.GetTask(task_id);
+  case TaskState::READY:
+    return ready_tasks_.GetTask(task_id);
+  case TaskState::RUNNING:
+    return running_tasks_.GetTask(task_id);
+  case TaskState::BLOCKED:
+    return blocked_tasks_.GetTask(task_id);
+  case TaskState::INFEASIBLE:
+    return infeasible_tasks_.GetTask(task_id);
+  default:
+    RAY_LOG(FATAL) << "Attempting to get a task in unrecognized state "
+                   << static_cast<std::underlying_type<TaskState>::type>(task_state);
+  }
+  // Unreachable, since RAY_LOG(FATAL) aborts.
+  return waiting_tasks_.GetTask(task_id);
+}
+
 std::vector<Task> SchedulingQueue::RemoveTasks(std::unordered_set<TaskID> &task_ids) {
   // List of removed tasks to be returned.
   std::vector<Task> removed_tasks;
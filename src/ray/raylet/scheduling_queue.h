@@ -1,11 +1,15 @@
 #ifndef RAY_RAYLET_SCHEDULING_QUEUE_H
 #define RAY_RAYLET_SCHEDULING_QUEUE_H
 
+#include <functional>
 #include <list>
+#include <map>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "ray/gcs/format/util.h"
 #include "ray/raylet/task.h"
 
 namespace ray {
@@ -23,6 +27,21 @@ enum class TaskState {
   INFEASIBLE
 };
 
+/// \struct ResourceShapeBucket
+///
+/// A group of tasks that have the same priority and resource demand.
+struct ResourceShapeBucket {
+  ResourceShapeBucket(int64_t priority, const ResourceSet &resources)
+      : priority(priority), resources(resources) {}
+
+  /// The priority of the tasks.
+  int64_t priority;
+  /// The resource demand of the tasks.
+  ResourceSet resources;
+  /// The IDs of the tasks, in FIFO order.
+  std::list<TaskID> task_ids;
+};
+
 /// \class SchedulingQueue
 ///
 /// Encapsulates task queues.
@@ -78,6 +97,26 @@ class SchedulingQueue {
   /// to execute but that are waiting for a worker.
   const std::list<Task> &GetReadyTasks() const;
 
+  /// Get the tasks in the ready state, grouped by priority and resource demand.
+  ///
+  /// \return A const reference to the groups of ready tasks, in order of
+  /// decreasing priority. Every group is nonempty and no two groups have the
+  /// same priority and resource demand.
+  const std::list<ResourceShapeBucket> &GetReadyTasksByShape() const;
+
+  /// Get the number of ready tasks that need a new or idle worker, i.e., that
+  /// are not actor tasks.
+  ///
+  /// \param language The language of the tasks.
+  /// \return The number of ready non-actor tasks in the language.
+  int64_t GetNumReadyNonActorTasks(const Language &language) const;
+
+  /// Get a task in the ready state.
+  ///
+  /// \param task_id The task ID of the task. The task must be ready.
+  /// \return A const reference to the task.
+  const Task &GetReadyTask(const TaskID &task_id) const;
+
   /// Get the queue of tasks in the running state.
   ///
   /// \return A const reference to the queue of tasks that are currently
@@ -174,6 +213,13 @@ class SchedulingQueue {
   /// \param filter_state The task state to filter out.
   void FilterState(std::unordered_set<TaskID> &task_ids, TaskState filter_state) const;
 
+  /// \brief Get a task without removing it from its queue.
+  ///
+  /// \param task_id The task ID of the task.
+  /// \param task_state The state of the task. The task must be in this state.
+  /// \return A const reference to the task.
+  const Task &GetTaskOfState(const TaskID &task_id, TaskState task_state) const;
+
   /// \brief Get all the task IDs for a driver.
   ///
   /// \param driver_id All the tasks that have the given driver_id are returned.
@@ -198,26 +244,31 @@ class SchedulingQueue {
   /// for debugging purposes.
   const std::string ToString() const;
 
+  /// \class TaskQueue
+  ///
+  /// A queue of tasks ordered by decreasing priority. Tasks with the same
+  /// priority are kept in FIFO order.
   class TaskQueue {
    public:
     /// Creating a task queue.
     TaskQueue() {}
 
     /// Destructor for task queue.
-    ~TaskQueue();
+    virtual ~TaskQueue();
 
-    /// \brief Append a task to queue.
+    /// \brief Append a task to queue, after all tasks with a higher or equal
+    /// priority and before all tasks with a lower priority.
     ///
     /// \param task_id The task ID for the task to append.
     /// \param task The task to append to the queue.
     /// \return Whether the append operation succeeds.
-    bool AppendTask(const TaskID &task_id, const Task &task);
+    virtual bool AppendTask(const TaskID &task_id, const Task &task);
 
     /// \brief Remove a task from queue.
     ///
     /// \param task_id The task ID for the task to remove from the queue.
     /// \return Whether the removal succeeds.
-    bool RemoveTask(const TaskID &task_id);
+    virtual bool RemoveTask(const TaskID &task_id);
 
     /// \brief Remove a task from queue.
     ///
@@ -225,7 +276,7 @@ class SchedulingQueue {
     /// \param removed_tasks If the task specified by task_id is successfully
     //  removed from the queue, the task data is appended to the vector.
     /// \return Whether the removal succeeds.
-    bool RemoveTask(const TaskID &task_id, std::vector<Task> &removed_tasks);
+    virtual bool RemoveTask(const TaskID &task_id, std::vector<Task> &removed_tasks);
 
     /// \brief Check if the queue contains a specific task id.
     ///
@@ -233,15 +284,119 @@ class SchedulingQueue {
     /// \return Whether the task_id exists in this queue.
     bool HasTask(const TaskID &task_id) const;
 
+    /// \brief Get a task in the queue.
+    ///
+    /// \param task_id The task ID for the task. The task must be in the queue.
+    /// \return A const reference to the task.
+    const Task &GetTask(const TaskID &task_id) const;
+
     /// \brief Remove the task list of the queue.
-    /// \return A list of tasks contained in this queue.
+    /// \return A list of tasks contained in this queue, in order of decreasing
+    /// priority.
     const std::list<Task> &GetTasks() const;
 
+    /// \brief Get the total resources required by the tasks in the queue.
+    /// \return The aggregate resource demand of the queued tasks.
+    const ResourceSet &GetCurrentResourceLoad() const;
+
    private:
+    /// \brief Remove a task's resource demand from the queue's aggregate
+    /// resource demand. This must be called before the task is removed.
+    ///
+    /// \param task The task being removed from the queue.
+    void SubtractResourceLoad(const Task &task);
+
+    /// \brief Remove a task from its priority group, erasing the group if it
+    /// becomes empty. This must be called before the task is removed.
+    ///
+    /// \param list_iterator The position of the task being removed.
+    void RemoveFromPriorityGroup(std::list<Task>::iterator list_iterator);
+
     // A list of tasks.
     std::list<Task> task_list_;
     // A hash to speed up looking up a task.
     std::unordered_map<TaskID, std::list<Task>::iterator> task_map_;
+    // The aggregate resource demand of the tasks in the queue, updated as
+    // tasks are appended and removed.
+    ResourceSet current_resource_load_;
+    // A map from priority to the position of the first task with that
+    // priority and the number of such tasks. The tasks with the same priority
+    // are contiguous in the list, so a task is appended before the first task
+    // of the next lower priority.
+    std::map<int64_t, std::pair<std::list<Task>::iterator, size_t>,
+             std::greater<int64_t>>
+        priority_groups_;
+  };
+
+  /// \class ReadyQueue
+  ///
+  /// A task queue that also groups its tasks by priority and resource demand,
+  /// so that the dispatcher can skip all tasks with a given demand as soon as
+  /// one of them does not fit.
+  class ReadyQueue : public TaskQueue {
+   public:
+    /// Create a ready queue.
+    ReadyQueue() {}
+
+    bool AppendTask(const TaskID &task_id, const Task &task) override;
+
+    bool RemoveTask(const TaskID &task_id) override;
+
+    bool RemoveTask(const TaskID &task_id, std::vector<Task> &removed_tasks) override;
+
+    /// \brief Get the tasks in the queue, grouped by priority and resource
+    /// demand.
+    /// \return The nonempty groups of tasks, in order of decreasing priority.
+    const std::list<ResourceShapeBucket> &GetShapeBuckets() const;
+
+    /// \brief Get the number of non-actor tasks in the queue.
+    /// \param language The language of the tasks.
+    /// \return The number of non-actor tasks in the language.
+    int64_t GetNumNonActorTasks(const Language &language) const;
+
+   private:
+    /// A key that identifies a group by its priority, and by the IDs and
+    /// capacities of the resources in its demand.
+    using ShapeKey = std::tuple<int64_t, std::vector<int64_t>, std::vector<double>>;
+
+    /// \brief Get the key of the group for a priority and resource demand.
+    ///
+    /// \param priority The priority.
+    /// \param resources The resource demand.
+    /// \return The key.
+    static ShapeKey GetShapeKey(int64_t priority, const ResourceSet &resources);
+
+    /// \brief Remove a task from its group, erasing the group if it becomes
+    /// empty.
+    ///
+    /// \param task_id The task ID for the task to remove.
+    void RemoveFromShapeBucket(const TaskID &task_id);
+
+    /// \brief Update the number of non-actor tasks for a task that is being
+    /// appended or removed.
+    ///
+    /// \param task The task.
+    /// \param delta 1 if the task is being appended, -1 if it is being removed.
+    void UpdateNumNonActorTasks(const Task &task, int64_t delta);
+
+    // The groups of tasks, in order of decreasing priority. The groups with
+    // the same priority are in the order in which they were created.
+    std::list<ResourceShapeBucket> shape_buckets_;
+    // A map from a group's key to the group.
+    std::map<ShapeKey, std::list<ResourceShapeBucket>::iterator> shape_bucket_map_;
+    // A map from priority to the first group with that priority and the number
+    // of such groups. The groups with the same priority are contiguous in the
+    // list, so a new group is inserted before the first group of the next
+    // lower priority.
+    std::map<int64_t, std::pair<std::list<ResourceShapeBucket>::iterator, size_t>,
+             std::greater<int64_t>>
+        priority_buckets_;
+    // The number of non-actor tasks in the queue, by language.
+    std::unordered_map<Language, int64_t> num_non_actor_tasks_;
+    // A hash from task ID to the task's group and position in that group.
+    std::unordered_map<TaskID, std::pair<std::list<ResourceShapeBucket>::iterator,
+                                         std::list<TaskID>::iterator>>
+        shape_bucket_index_;
   };
 
  private:
@@ -253,7 +408,7 @@ class SchedulingQueue {
   /// waiting to be scheduled.
   TaskQueue placeable_tasks_;
   /// Tasks ready for dispatch, but that are waiting for a worker.
-  TaskQueue ready_tasks_;
+  ReadyQueue ready_tasks_;
   /// Tasks that are running on a worker.
   TaskQueue running_tasks_;
   /// Tasks that were dispatched to a worker but are blocked on a data
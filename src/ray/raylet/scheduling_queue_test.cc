@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+#include "ray/raylet/scheduling_queue.h"
+#include "ray/raylet/test_util.h"
+
+namespace ray {
+
+namespace raylet {
+
+TEST(SchedulingQueueTest, TestResourceLoad) {
+  SchedulingQueue queue;
+  ASSERT_TRUE(queue.GetResourceLoad().IsEmpty());
+
+  std::vector<Task> tasks = {ExampleTask(1), ExampleTask(2), ExampleTask(0.5)};
+  queue.QueueReadyTasks(tasks);
+  ASSERT_EQ(queue.GetResourceLoad().GetNumCpus(), 3.5);
+
+  // Tasks in other queues do not count towards the load.
+  queue.QueueWaitingTasks({ExampleTask(4)});
+  ASSERT_EQ(queue.GetResourceLoad().GetNumCpus(), 3.5);
+
+  // The load follows tasks as they are moved and removed.
+  std::unordered_set<TaskID> task_ids = {tasks[1].GetTaskSpecification().TaskId()};
+  queue.MoveTasks(task_ids, TaskState::READY, TaskState::RUNNING);
+  ASSERT_EQ(queue.GetResourceLoad().GetNumCpus(), 1.5);
+  queue.RemoveTask(tasks[0].GetTaskSpecification().TaskId());
+  ASSERT_EQ(queue.GetResourceLoad().GetNumCpus(), 0.5);
+  queue.RemoveTask(tasks[2].GetTaskSpecification().TaskId());
+  ASSERT_TRUE(queue.GetResourceLoad().IsEmpty());
+}
+
+TEST(SchedulingQueueTest, TestReadyTasksByShape) {
+  SchedulingQueue queue;
+  std::vector<Task> tasks = {ExampleTask(1), ExampleTask(2), ExampleTask(1)};
+  queue.QueueReadyTasks(tasks);
+
+  // Tasks with the same resource demand are grouped together in FIFO order.
+  const auto &buckets = queue.GetReadyTasksByShape();
+  ASSERT_EQ(buckets.size(), 2u);
+  ASSERT_EQ(buckets.front().resources.GetNumCpus(), 1);
+  ASSERT_EQ(buckets.front().task_ids,
+            std::list<TaskID>({tasks[0].GetTaskSpecification().TaskId(),
+                               tasks[2].GetTaskSpecification().TaskId()}));
+  ASSERT_EQ(buckets.back().resources.GetNumCpus(), 2);
+
+  // Groups are removed once they become empty.
+  queue.RemoveTask(tasks[1].GetTaskSpecification().TaskId());
+  ASSERT_EQ(buckets.size(), 1u);
+  queue.RemoveTask(tasks[0].GetTaskSpecification().TaskId());
+  ASSERT_EQ(buckets.front().task_ids.size(), 1u);
+  std::unordered_set<TaskID> task_ids = {tasks[2].GetTaskSpecification().TaskId()};
+  queue.MoveTasks(task_ids, TaskState::READY, TaskState::RUNNING);
+  ASSERT_TRUE(buckets.empty());
+}
+
+TEST(SchedulingQueueTest, TestPriorityOrder) {
+  SchedulingQueue queue;
+  std::vector<Task> tasks = {ExampleTask(1, {}, 0), ExampleTask(1, {}, 2),
+                             ExampleTask(2, {}, 1), ExampleTask(1, {}, 2),
+                             ExampleTask(1, {}, 0)};
+  queue.QueueReadyTasks(tasks);
+  auto task_ids = [](const std::list<Task> &queued_tasks) {
+    std::vector<TaskID> ids;
+    for (const auto &task : queued_tasks) {
+      ids.push_back(task.GetTaskSpecification().TaskId());
+    }
+    return ids;
+  };
+  auto task_id = [&tasks](int i) { return tasks[i].GetTaskSpecification().TaskId(); };
+
+  // Tasks are ordered by decreasing priority and in FIFO order within a
+  // priority.
+  ASSERT_EQ(task_ids(queue.GetReadyTasks()),
+            std::vector<TaskID>(
+                {task_id(1), task_id(3), task_id(2), task_id(0), task_id(4)}));
+  const auto &buckets = queue.GetReadyTasksByShape();
+  ASSERT_EQ(buckets.size(), 3u);
+  ASSERT_EQ(buckets.front().priority, 2);
+  ASSERT_EQ(buckets.back().priority, 0);
+
+  // Removing the first task of a priority keeps the order of the others, and
+  // tasks appended later go behind the existing tasks with their priority.
+  queue.RemoveTask(task_id(1));
+  queue.RemoveTask(task_id(2));
+  queue.QueueReadyTasks({ExampleTask(1, {}, 1), ExampleTask(1, {}, 2)});
+  const auto &ready_tasks = queue.GetReadyTasks();
+  ASSERT_EQ(ready_tasks.size(), 5u);
+  std::vector<int64_t> priorities;
+  for (const auto &task : ready_tasks) {
+    priorities.push_back(task.GetTaskSpecification().Priority());
+  }
+  ASSERT_EQ(priorities, std::vector<int64_t>({2, 2, 1, 0, 0}));
+  ASSERT_EQ(ready_tasks.front().GetTaskSpecification().TaskId(), task_id(3));
+  ASSERT_EQ(ready_tasks.back().GetTaskSpecification().TaskId(), task_id(4));
+}
+
+TEST(SchedulingQueueTest, TestShapeBucketOrder) {
+  SchedulingQueue queue;
+  std::vector<Task> tasks = {ExampleTask(2, {}, 1), ExampleTask(1, {}, 1),
+                             ExampleTask(4, {}, 0), ExampleTask(1, {}, 1)};
+  queue.QueueReadyTasks(tasks);
+  auto bucket_cpus = [&queue]() {
+    std::vector<std::pair<int64_t, double>> cpus;
+    for (const auto &bucket : queue.GetReadyTasksByShape()) {
+      cpus.emplace_back(bucket.priority, bucket.resources.GetNumCpus());
+    }
+    return cpus;
+  };
+
+  // Groups with the same priority are in the order in which they were
+  // created, and a task joins the existing group for its demand.
+  ASSERT_EQ(bucket_cpus(),
+            (std::vector<std::pair<int64_t, double>>({{1, 2}, {1, 1}, {0, 4}})));
+  ASSERT_EQ(queue.GetReadyTasksByShape().front().task_ids.size(), 1u);
+
+  // A group that is created again after becoming empty goes behind the other
+  // groups with its priority, but before the groups with a lower priority.
+  queue.RemoveTask(tasks[0].GetTaskSpecification().TaskId());
+  queue.QueueReadyTasks({ExampleTask(2, {}, 1), ExampleTask(4, {}, 2)});
+  ASSERT_EQ(bucket_cpus(), (std::vector<std::pair<int64_t, double>>(
+                               {{2, 4}, {1, 1}, {1, 2}, {0, 4}})));
+}
+
+TEST(SchedulingQueueTest, TestNumReadyNonActorTasks) {
+  SchedulingQueue queue;
+  std::vector<Task> tasks = {ExampleTask(1), ExampleTask(2), ExampleTask(1)};
+  queue.QueueReadyTasks(tasks);
+  queue.QueueWaitingTasks({ExampleTask(1)});
+  ASSERT_EQ(queue.GetNumReadyNonActorTasks(Language::PYTHON), 3);
+  ASSERT_EQ(queue.GetNumReadyNonActorTasks(Language::JAVA), 0);
+
+  // The count follows tasks as they leave the ready queue.
+  std::unordered_set<TaskID> task_ids = {tasks[0].GetTaskSpecification().TaskId()};
+  queue.MoveTasks(task_ids, TaskState::READY, TaskState::RUNNING);
+  ASSERT_EQ(queue.GetNumReadyNonActorTasks(Language::PYTHON), 2);
+  queue.RemoveTask(tasks[1].GetTaskSpecification().TaskId());
+  queue.RemoveTask(tasks[2].GetTaskSpecification().TaskId());
+  ASSERT_EQ(queue.GetNumReadyNonActorTasks(Language::PYTHON), 0);
+}
+
+TEST(SchedulingQueueTest, TestGetTaskOfState) {
+  SchedulingQueue queue;
+  std::vector<Task> tasks = {ExampleTask(1), ExampleTask(2), ExampleTask(3)};
+  queue.QueueWaitingTasks(tasks);
+  const TaskID task_id = tasks[1].GetTaskSpecification().TaskId();
+  ASSERT_EQ(queue.GetTaskOfState(task_id, TaskState::WAITING)
+                .GetTaskSpecification()
+                .TaskId(),
+            task_id);
+
+  // Looking up a task leaves the queue in the same order.
+  std::vector<TaskID> waiting_task_ids;
+  for (const auto &task : queue.GetWaitingTasks()) {
+    waiting_task_ids.push_back(task.GetTaskSpecification().TaskId());
+  }
+  const std::vector<TaskID> expected_task_ids = {
+      tasks[0].GetTaskSpecification().TaskId(), task_id,
+      tasks[2].GetTaskSpecification().TaskId()};
+  ASSERT_EQ(waiting_task_ids, expected_task_ids);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -1,6 +1,8 @@
 #include "scheduling_resources.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "ray/util/logging.h"
 
@@ -8,19 +10,92 @@ namespace ray {
 
 namespace raylet {
 
+namespace {
+
+/// The capacity value used to mark resources that are not in a ResourceSet.
+const double kAbsentResource = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+/// ResourceLabelTable class implementation
+
+ResourceLabelTable &ResourceLabelTable::instance() {
+  static ResourceLabelTable table;
+  return table;
+}
+
+ResourceLabelTable::ResourceLabelTable() {
+  snapshots_.emplace_back(new Snapshot());
+  snapshot_.store(snapshots_.back().get());
+  RAY_CHECK(GetOrAddId(kCPU_ResourceLabel) == kCPU_ResourceId);
+  RAY_CHECK(GetOrAddId(kGPU_ResourceLabel) == kGPU_ResourceId);
+}
+
+int64_t ResourceLabelTable::GetOrAddId(const std::string &resource_label) {
+  const int64_t existing_id = GetId(resource_label);
+  if (existing_id >= 0) {
+    return existing_id;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Snapshot *snapshot = snapshot_.load(std::memory_order_relaxed);
+  auto it = snapshot->label_to_id.find(resource_label);
+  if (it != snapshot->label_to_id.end()) {
+    // Another thread added the label first.
+    return it->second;
+  }
+  int64_t resource_id = labels_.size();
+  labels_.push_back(resource_label);
+  std::unique_ptr<Snapshot> new_snapshot(new Snapshot(*snapshot));
+  new_snapshot->label_to_id.emplace(resource_label, resource_id);
+  new_snapshot->labels.push_back(&labels_.back());
+  snapshot_.store(new_snapshot.get(), std::memory_order_release);
+  snapshots_.push_back(std::move(new_snapshot));
+  return resource_id;
+}
+
+int64_t ResourceLabelTable::GetId(const std::string &resource_label) const {
+  const Snapshot *snapshot = snapshot_.load(std::memory_order_acquire);
+  auto it = snapshot->label_to_id.find(resource_label);
+  if (it == snapshot->label_to_id.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+const std::string &ResourceLabelTable::GetLabel(int64_t resource_id) const {
+  const Snapshot *snapshot = snapshot_.load(std::memory_order_acquire);
+  RAY_CHECK(resource_id >= 0 &&
+            resource_id < static_cast<int64_t>(snapshot->labels.size()));
+  return *snapshot->labels[resource_id];
+}
+
+/// ResourceSet class implementation
+
 ResourceSet::ResourceSet() {}
 
-ResourceSet::ResourceSet(const std::unordered_map<std::string, double> &resource_map)
-    : resource_capacity_(resource_map) {}
+ResourceSet::ResourceSet(const std::unordered_map<std::string, double> &resource_map) {
+  for (const auto &resource_pair : resource_map) {
+    RAY_CHECK(AddResource(resource_pair.first, resource_pair.second));
+  }
+}
 
 ResourceSet::ResourceSet(const std::vector<std::string> &resource_labels,
-                         const std::vector<double> resource_capacity) {
+                         const std::vector<double> &resource_capacity) {
   RAY_CHECK(resource_labels.size() == resource_capacity.size());
   for (uint i = 0; i < resource_labels.size(); i++) {
     RAY_CHECK(this->AddResource(resource_labels[i], resource_capacity[i]));
   }
 }
 
+ResourceSet::ResourceSet(const std::vector<int64_t> &resource_ids,
+                         const std::vector<double> &resource_capacity) {
+  RAY_CHECK(resource_ids.size() == resource_capacity.size());
+  for (size_t i = 0; i < resource_ids.size(); i++) {
+    RAY_CHECK(resource_ids[i] >= 0 && !std::isnan(resource_capacity[i]));
+    SetResourceById(resource_ids[i], resource_capacity[i]);
+  }
+}
+
 ResourceSet::~ResourceSet() {}
 
 bool ResourceSet::operator==(const ResourceSet &rhs) const {
@@ -28,32 +103,36 @@ bool ResourceSet::operator==(const ResourceSet &rhs) const {
 }
 
 bool ResourceSet::IsEmpty() const {
-  // Check whether the capacity of each resource type is zero. Exit early if not.
-  if (resource_capacity_.empty()) return true;
-  for (const auto &resource_pair : resource_capacity_) {
-    if (resource_pair.second > 0) {
-      return false;
-    }
+  // Check whether the capacity of each resource type is zero. Missing resources
+  // are NaN, which never compares greater than zero.
+  double num_nonempty = 0;
+  for (const double capacity : resource_capacity_) {
+    num_nonempty += std::isgreater(capacity, 0.0) ? 1.0 : 0.0;
   }
-  return true;
+  return num_nonempty == 0;
 }
 
+// The loops below are the scheduler's inner kernels. They are written without
+// early exits or branches, and they count violations in doubles using quiet
+// comparisons, so that the compiler can vectorize them.
+
 bool ResourceSet::IsSubset(const ResourceSet &other) const {
-  // Check to make sure all keys of this are in other.
-  for (const auto &resource_pair : resource_capacity_) {
-    const auto &resource_name = resource_pair.first;
-    const double lhs_quantity = resource_pair.second;
-    double rhs_quantity = 0;
-    if (!other.GetResource(resource_name, &rhs_quantity)) {
-      // Resource not found in rhs, therefore lhs is not a subset of rhs.
-      return false;
-    }
-    if (lhs_quantity > rhs_quantity) {
-      // Resource found in rhs, but lhs capacity exceeds rhs capacity.
-      return false;
-    }
+  const size_t num_resources = resource_capacity_.size();
+  const size_t num_common = std::min(num_resources, other.resource_capacity_.size());
+  const double *lhs = resource_capacity_.data();
+  const double *rhs = other.resource_capacity_.data();
+  // A resource present in this set but missing from other is NaN in other, so
+  // the quiet comparison below fails for it.
+  double num_violations = 0;
+  for (size_t i = 0; i < num_common; i++) {
+    const bool exceeds = !std::isnan(lhs[i]) & !std::islessequal(lhs[i], rhs[i]);
+    num_violations += exceeds ? 1.0 : 0.0;
   }
-  return true;
+  // Resources beyond the end of other must be missing from this set.
+  for (size_t i = num_common; i < num_resources; i++) {
+    num_violations += std::isnan(lhs[i]) ? 0.0 : 1.0;
+  }
+  return num_violations == 0;
 }
 
 /// Test whether this ResourceSet is a superset of the other ResourceSet
@@ -65,53 +144,82 @@ bool ResourceSet::IsEqual(const ResourceSet &rhs) const {
   return (this->IsSubset(rhs) && rhs.IsSubset(*this));
 }
 
+void ResourceSet::SetResourceById(int64_t resource_id, double capacity) {
+  if (resource_id >= static_cast<int64_t>(resource_capacity_.size())) {
+    resource_capacity_.resize(resource_id + 1, kAbsentResource);
+  }
+  resource_capacity_[resource_id] = capacity;
+}
+
 bool ResourceSet::AddResource(const std::string &resource_name, double capacity) {
-  resource_capacity_[resource_name] = capacity;
+  if (std::isnan(capacity)) {
+    return false;
+  }
+  SetResourceById(ResourceLabelTable::instance().GetOrAddId(resource_name), capacity);
   return true;
 }
 bool ResourceSet::RemoveResource(const std::string &resource_name) {
   throw std::runtime_error("Method not implemented");
 }
 bool ResourceSet::SubtractResourcesStrict(const ResourceSet &other) {
+  const size_t num_other = other.resource_capacity_.size();
+  if (num_other > resource_capacity_.size()) {
+    resource_capacity_.resize(num_other, kAbsentResource);
+  }
+  double *lhs = resource_capacity_.data();
+  const double *rhs = other.resource_capacity_.data();
   // Subtract the resources and track whether a resource goes below zero.
-  bool oversubscribed = false;
-  for (const auto &resource_pair : other.GetResourceMap()) {
-    const std::string &resource_label = resource_pair.first;
-    const double &resource_capacity = resource_pair.second;
-    RAY_CHECK(resource_capacity_.count(resource_label) == 1)
-        << "Attempt to acquire unknown resource: " << resource_label;
-    resource_capacity_[resource_label] -= resource_capacity;
-    if (resource_capacity_[resource_label] < 0) {
-      oversubscribed = true;
-    }
+  double num_unknown = 0;
+  double num_oversubscribed = 0;
+  for (size_t i = 0; i < num_other; i++) {
+    const double capacity = lhs[i];
+    const double demand = rhs[i];
+    const double difference = capacity - demand;
+    const double result = std::isnan(demand) ? capacity : difference;
+    num_unknown += (std::isnan(capacity) && !std::isnan(demand)) ? 1.0 : 0.0;
+    // The difference is NaN for resources that are not being subtracted.
+    num_oversubscribed += std::isless(difference, 0.0) ? 1.0 : 0.0;
+    lhs[i] = result;
   }
-  return !oversubscribed;
+  RAY_CHECK(num_unknown == 0) << "Attempt to acquire unknown resource: "
+                              << other.ToString();
+  return num_oversubscribed == 0;
 }
 
 // Perform a left join.
 bool ResourceSet::AddResourcesStrict(const ResourceSet &other) {
-  // Return failure if attempting to perform vector addition with unknown labels.
-  for (const auto &resource_pair : other.GetResourceMap()) {
-    const std::string &resource_label = resource_pair.first;
-    const double &resource_capacity = resource_pair.second;
-    RAY_CHECK(resource_capacity_.count(resource_label) != 0);
-    resource_capacity_[resource_label] += resource_capacity;
+  const size_t num_other = other.resource_capacity_.size();
+  if (num_other > resource_capacity_.size()) {
+    resource_capacity_.resize(num_other, kAbsentResource);
+  }
+  double *lhs = resource_capacity_.data();
+  const double *rhs = other.resource_capacity_.data();
+  // Fail if attempting to perform vector addition with unknown labels.
+  double num_unknown = 0;
+  for (size_t i = 0; i < num_other; i++) {
+    const double sum = lhs[i] + rhs[i];
+    const double result = std::isnan(rhs[i]) ? lhs[i] : sum;
+    num_unknown += (std::isnan(lhs[i]) && !std::isnan(rhs[i])) ? 1.0 : 0.0;
+    lhs[i] = result;
   }
+  RAY_CHECK(num_unknown == 0);
   return true;
 }
 
 // Perform an outer join.
 void ResourceSet::AddResources(const ResourceSet &other) {
-  for (const auto &resource_pair : other.GetResourceMap()) {
-    const std::string &resource_label = resource_pair.first;
-    const double &resource_capacity = resource_pair.second;
-    if (resource_capacity_.count(resource_label) == 0) {
-      // Add the new label if not found.
-      RAY_CHECK(AddResource(resource_label, resource_capacity));
-    } else {
-      // Increment the resource by its capacity.
-      resource_capacity_[resource_label] += resource_capacity;
-    }
+  const size_t num_other = other.resource_capacity_.size();
+  if (num_other > resource_capacity_.size()) {
+    resource_capacity_.resize(num_other, kAbsentResource);
+  }
+  double *lhs = resource_capacity_.data();
+  const double *rhs = other.resource_capacity_.data();
+  for (size_t i = 0; i < num_other; i++) {
+    // Add the new label if not found, otherwise increment the resource by its
+    // capacity.
+    const double sum = lhs[i] + rhs[i];
+    const double joined = std::isnan(lhs[i]) ? rhs[i] : sum;
+    lhs[i] = std::isnan(rhs[i]) ? lhs[i] : joined;
   }
 }
 
@@ -119,33 +227,58 @@ bool ResourceSet::GetResource(const std::string &resource_name, double *value) c
   if (!value) {
     return false;
   }
-  if (this->resource_capacity_.count(resource_name) == 0) {
+  return GetResourceById(ResourceLabelTable::instance().GetId(resource_name), value);
+}
+
+bool ResourceSet::GetResourceById(int64_t resource_id, double *value) const {
+  if (!value) {
+    return false;
+  }
+  if (resource_id < 0 || resource_id >= static_cast<int64_t>(resource_capacity_.size())) {
     *value = std::nan("");
     return false;
   }
-  *value = this->resource_capacity_.at(resource_name);
-  return true;
+  *value = resource_capacity_[resource_id];
+  return !std::isnan(*value);
 }
 
 double ResourceSet::GetNumCpus() const {
-  double num_cpus;
-  RAY_CHECK(GetResource(kCPU_ResourceLabel, &num_cpus));
-  return num_cpus;
+  RAY_CHECK(kCPU_ResourceId < static_cast<int64_t>(resource_capacity_.size()) &&
+            !std::isnan(resource_capacity_[kCPU_ResourceId]));
+  return resource_capacity_[kCPU_ResourceId];
 }
 
 const std::string ResourceSet::ToString() const {
   std::string return_string = "";
-  for (const auto &resource_pair : this->resource_capacity_) {
-    return_string +=
-        "{" + resource_pair.first + "," + std::to_string(resource_pair.second) + "}, ";
+  for (size_t i = 0; i < resource_capacity_.size(); i++) {
+    if (!std::isnan(resource_capacity_[i])) {
+      return_string += "{" + ResourceLabelTable::instance().GetLabel(i) + "," +
+                       std::to_string(resource_capacity_[i]) + "}, ";
+    }
   }
   return return_string;
 }
 
-const std::unordered_map<std::string, double> &ResourceSet::GetResourceMap() const {
-  return this->resource_capacity_;
+std::unordered_map<std::string, double> ResourceSet::GetResourceMap() const {
+  std::unordered_map<std::string, double> resource_map;
+  for (size_t i = 0; i < resource_capacity_.size(); i++) {
+    if (!std::isnan(resource_capacity_[i])) {
+      resource_map[ResourceLabelTable::instance().GetLabel(i)] = resource_capacity_[i];
+    }
+  }
+  return resource_map;
 };
 
+void ResourceSet::GetResourceIds(std::vector<int64_t> *resource_ids,
+                                 std::vector<double> *resource_capacity) const {
+  for (size_t i = 0; i < resource_capacity_.size(); i++) {
+    if (!std::isnan(resource_capacity_[i])) {
+      resource_ids->push_back(i);
+      resource_capacity->push_back(resource_capacity_[i]);
+    }
+  }
+}
+
 /// ResourceIds class implementation
 
 ResourceIds::ResourceIds() {}
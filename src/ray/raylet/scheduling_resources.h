@@ -1,6 +1,10 @@
 #ifndef RAY_RAYLET_SCHEDULING_RESOURCES_H
 #define RAY_RAYLET_SCHEDULING_RESOURCES_H
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -13,6 +17,71 @@ namespace ray {
 namespace raylet {
 
 const std::string kCPU_ResourceLabel = "CPU";
+const std::string kGPU_ResourceLabel = "GPU";
+
+/// \class ResourceLabelTable
+/// \brief Process-wide table that interns resource labels to small, dense
+/// integer IDs. Resource sets are stored as vectors indexed by these IDs, so
+/// that set operations do not need to hash label strings. Labels are never
+/// removed, so an ID remains valid for the lifetime of the process. The CPU
+/// and GPU labels are always assigned IDs 0 and 1. Only adding a label takes a
+/// lock; looking up an existing label or ID does not.
+class ResourceLabelTable {
+ public:
+  /// Get the process-wide resource label table.
+  ///
+  /// \return The singleton resource label table.
+  static ResourceLabelTable &instance();
+
+  /// Get the ID of a resource label, assigning a new ID if the label has not
+  /// been seen before.
+  ///
+  /// \param resource_label The resource label to intern.
+  /// \return The ID of the resource label.
+  int64_t GetOrAddId(const std::string &resource_label);
+
+  /// Get the ID of a resource label without assigning a new one.
+  ///
+  /// \param resource_label The resource label to look up.
+  /// \return The ID of the resource label, or -1 if it has not been interned.
+  int64_t GetId(const std::string &resource_label) const;
+
+  /// Get the resource label for an ID.
+  ///
+  /// \param resource_id An ID previously returned by GetOrAddId.
+  /// \return The resource label. The reference remains valid for the lifetime
+  /// of the process.
+  const std::string &GetLabel(int64_t resource_id) const;
+
+ private:
+  /// The labels that were interned when a label was last added. A snapshot is
+  /// not modified once it is published, so it can be read without a lock.
+  struct Snapshot {
+    /// Map from resource label to its ID.
+    std::unordered_map<std::string, int64_t> label_to_id;
+    /// Resource labels, indexed by ID. These point into labels_.
+    std::vector<const std::string *> labels;
+  };
+
+  ResourceLabelTable();
+
+  /// Serializes the addition of labels. Resource sets may be built outside of
+  /// the raylet's event loop thread, e.g. by task submission in a worker.
+  std::mutex mutex_;
+  /// Resource labels, indexed by ID. A deque keeps references stable as labels
+  /// are added.
+  std::deque<std::string> labels_;
+  /// Every snapshot that was published. Readers may still hold an earlier
+  /// snapshot, and labels are only added a handful of times, so none are
+  /// freed.
+  std::vector<std::unique_ptr<const Snapshot>> snapshots_;
+  /// The latest snapshot.
+  std::atomic<const Snapshot *> snapshot_;
+};
+
+/// The interned IDs of the predefined resources.
+const int64_t kCPU_ResourceId = 0;
+const int64_t kGPU_ResourceId = 1;
 
 /// Resource availability status reports whether the resource requirement is
 /// (1) infeasible, (2) feasible but currently unavailable, or (3) available.
@@ -36,7 +105,12 @@ class ResourceSet {
   /// \brief Constructs ResourceSet from two equal-length vectors with label and capacity
   /// specification.
   ResourceSet(const std::vector<std::string> &resource_labels,
-              const std::vector<double> resource_capacity);
+              const std::vector<double> &resource_capacity);
+
+  /// \brief Constructs ResourceSet from two equal-length vectors with the interned
+  /// IDs (see ResourceLabelTable) and capacities of the resources.
+  ResourceSet(const std::vector<int64_t> &resource_ids,
+              const std::vector<double> &resource_capacity);
 
   /// \brief Empty ResourceSet destructor.
   ~ResourceSet();
@@ -110,6 +184,14 @@ class ResourceSet {
   /// False otherwise.
   bool GetResource(const std::string &resource_name, double *value) const;
 
+  /// Return the capacity value associated with the resource with the given
+  /// interned ID, e.g. kCPU_ResourceId, without looking up its label.
+  ///
+  /// \param resource_id: The ID of the resource.
+  /// \param[out] value: Resource capacity value.
+  /// \return True if the resource is in the set. False otherwise.
+  bool GetResourceById(int64_t resource_id, double *value) const;
+
   /// Return the number of CPUs.
   ///
   /// \return Number of CPUs.
@@ -120,14 +202,33 @@ class ResourceSet {
   /// \return True if the resource capacity is zero. False otherwise.
   bool IsEmpty() const;
 
-  // TODO(atumanov): implement const_iterator class for the ResourceSet container.
-  const std::unordered_map<std::string, double> &GetResourceMap() const;
+  /// Return the resources in this set as a map from label to capacity. This
+  /// materializes the labels, so it should be kept off of hot paths.
+  ///
+  /// \return A map from resource label to capacity.
+  std::unordered_map<std::string, double> GetResourceMap() const;
+
+  /// Return the resources in this set as two equal-length vectors with the
+  /// interned IDs and the capacities of the resources. Unlike GetResourceMap,
+  /// this does not look up the resource labels.
+  ///
+  /// \param[out] resource_ids The IDs of the resources in the set.
+  /// \param[out] resource_capacity The capacities of the resources in the set.
+  /// \return Void.
+  void GetResourceIds(std::vector<int64_t> *resource_ids,
+                      std::vector<double> *resource_capacity) const;
 
   const std::string ToString() const;
 
  private:
-  /// Resource capacity map.
-  std::unordered_map<std::string, double> resource_capacity_;
+  /// Set the capacity of the resource with the given interned ID, growing the
+  /// capacity vector if necessary.
+  void SetResourceById(int64_t resource_id, double capacity);
+
+  /// Resource capacities, indexed by the resource's ID in the ResourceLabelTable.
+  /// Resources that are not in the set have the value NaN, so that a resource
+  /// with zero capacity is distinguishable from a missing one.
+  std::vector<double> resource_capacity_;
 };
 
 /// \class ResourceIds
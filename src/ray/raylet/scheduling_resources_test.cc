@@ -0,0 +1,110 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "ray/raylet/scheduling_resources.h"
+
+namespace ray {
+
+namespace raylet {
+
+ResourceSet MakeResourceSet(const std::unordered_map<std::string, double> &resource_map) {
+  return ResourceSet(resource_map);
+}
+
+TEST(ResourceSetTest, TestLabelInterning) {
+  auto &table = ResourceLabelTable::instance();
+  ASSERT_EQ(table.GetId(kCPU_ResourceLabel), kCPU_ResourceId);
+  ASSERT_EQ(table.GetId(kGPU_ResourceLabel), kGPU_ResourceId);
+  ASSERT_EQ(table.GetId("ResourceSetTestUnknown"), -1);
+  int64_t id = table.GetOrAddId("ResourceSetTestCustom");
+  ASSERT_EQ(table.GetOrAddId("ResourceSetTestCustom"), id);
+  ASSERT_EQ(table.GetLabel(id), "ResourceSetTestCustom");
+}
+
+TEST(ResourceSetTest, TestConcurrentLabelInterning) {
+  // Threads that intern the same labels at once agree on their IDs, while
+  // other threads read the existing labels.
+  auto &table = ResourceLabelTable::instance();
+  const int num_labels = 100;
+  std::vector<std::vector<int64_t>> ids(4);
+  std::vector<std::thread> threads;
+  for (auto &thread_ids : ids) {
+    threads.emplace_back([&table, &thread_ids]() {
+      for (int i = 0; i < num_labels; i++) {
+        thread_ids.push_back(
+            table.GetOrAddId("ResourceSetTestConcurrent" + std::to_string(i)));
+        ASSERT_EQ(table.GetLabel(kCPU_ResourceId), kCPU_ResourceLabel);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &thread_ids : ids) {
+    ASSERT_EQ(thread_ids, ids[0]);
+  }
+  for (int i = 0; i < num_labels; i++) {
+    ASSERT_EQ(table.GetLabel(ids[0][i]), "ResourceSetTestConcurrent" + std::to_string(i));
+  }
+
+  double num_cpus;
+  ASSERT_TRUE(MakeResourceSet({{kCPU_ResourceLabel, 2}})
+                  .GetResourceById(kCPU_ResourceId, &num_cpus));
+  ASSERT_EQ(num_cpus, 2);
+  ASSERT_FALSE(MakeResourceSet({{kCPU_ResourceLabel, 2}})
+                   .GetResourceById(kGPU_ResourceId, &num_cpus));
+}
+
+TEST(ResourceSetTest, TestSubset) {
+  ResourceSet cpu = MakeResourceSet({{kCPU_ResourceLabel, 1}});
+  ResourceSet cpu_zero_gpu =
+      MakeResourceSet({{kCPU_ResourceLabel, 1}, {kGPU_ResourceLabel, 0}});
+  ResourceSet node = MakeResourceSet({{kCPU_ResourceLabel, 4}, {kGPU_ResourceLabel, 0}});
+  ResourceSet custom =
+      MakeResourceSet({{kCPU_ResourceLabel, 1}, {"ResourceSetTestCustom", 1}});
+
+  ASSERT_TRUE(cpu.IsSubset(node));
+  ASSERT_TRUE(cpu_zero_gpu.IsSubset(node));
+  ASSERT_FALSE(node.IsSubset(cpu));
+  // A resource with zero capacity is still required to be present.
+  ASSERT_FALSE(cpu_zero_gpu.IsSubset(cpu));
+  ASSERT_TRUE(cpu.IsSubset(cpu_zero_gpu));
+  ASSERT_FALSE(custom.IsSubset(node));
+  ASSERT_TRUE(ResourceSet().IsSubset(cpu));
+  ASSERT_TRUE(cpu == MakeResourceSet({{kCPU_ResourceLabel, 1}}));
+  ASSERT_FALSE(cpu == cpu_zero_gpu);
+}
+
+TEST(ResourceSetTest, TestArithmetic) {
+  ResourceSet node = MakeResourceSet({{kCPU_ResourceLabel, 2}, {kGPU_ResourceLabel, 1}});
+  ResourceSet task = MakeResourceSet({{kCPU_ResourceLabel, 1}, {kGPU_ResourceLabel, 1}});
+
+  ASSERT_TRUE(node.SubtractResourcesStrict(task));
+  ASSERT_TRUE(node ==
+              MakeResourceSet({{kCPU_ResourceLabel, 1}, {kGPU_ResourceLabel, 0}}));
+  // Going below zero is reported as oversubscription.
+  ASSERT_FALSE(node.SubtractResourcesStrict(task));
+  ASSERT_TRUE(node.AddResourcesStrict(task));
+  ASSERT_TRUE(node.AddResourcesStrict(task));
+  ASSERT_TRUE(node ==
+              MakeResourceSet({{kCPU_ResourceLabel, 2}, {kGPU_ResourceLabel, 1}}));
+
+  // AddResources is an outer join.
+  ResourceSet load;
+  ASSERT_TRUE(load.IsEmpty());
+  load.AddResources(MakeResourceSet({{"ResourceSetTestCustom", 2}}));
+  load.AddResources(task);
+  load.AddResources(task);
+  double value;
+  ASSERT_TRUE(load.GetResource("ResourceSetTestCustom", &value));
+  ASSERT_EQ(value, 2);
+  ASSERT_EQ(load.GetNumCpus(), 2);
+  ASSERT_FALSE(load.GetResource("ResourceSetTestUnknown", &value));
+  ASSERT_FALSE(load.IsEmpty());
+  ASSERT_EQ(load.GetResourceMap().size(), 3u);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -8,14 +8,12 @@ TaskDependencyManager::TaskDependencyManager(
     ObjectManagerInterface &object_manager,
     ReconstructionPolicyInterface &reconstruction_policy,
     boost::asio::io_service &io_service, const ClientID &client_id,
-    int64_t initial_lease_period_ms,
+    int64_t initial_lease_period_ms, int64_t lease_renewal_tick_period_ms,
     gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table)
     : object_manager_(object_manager),
       reconstruction_policy_(reconstruction_policy),
-      io_service_(io_service),
-      client_id_(client_id),
-      initial_lease_period_ms_(initial_lease_period_ms),
-      task_lease_table_(task_lease_table) {}
+      task_lease_manager_(io_service, client_id, initial_lease_period_ms,
+                          lease_renewal_tick_period_ms, task_lease_table) {}
 
 bool TaskDependencyManager::CheckObjectLocal(const ObjectID &object_id) const {
   return local_objects_.count(object_id) == 1;
@@ -45,18 +43,27 @@ bool TaskDependencyManager::CheckObjectRequired(const ObjectID &object_id) const
   return true;
 }
 
-void TaskDependencyManager::HandleRemoteDependencyRequired(const ObjectID &object_id) {
-  bool required = CheckObjectRequired(object_id);
-  // If the object is required, then try to make the object available locally.
-  if (required) {
-    auto inserted = required_objects_.insert(object_id);
-    if (inserted.second) {
-      // If we haven't already, request the object manager to pull it from a
-      // remote node.
-      RAY_CHECK_OK(object_manager_.Pull(object_id));
-      reconstruction_policy_.ListenAndMaybeReconstruct(object_id);
+void TaskDependencyManager::HandleRemoteDependenciesRequired(
+    const std::vector<ObjectID> &object_ids) {
+  // Try to make the required objects available locally.
+  std::vector<ObjectID> remote_object_ids;
+  for (const auto &object_id : object_ids) {
+    if (CheckObjectRequired(object_id)) {
+      auto inserted = required_objects_.insert(object_id);
+      if (inserted.second) {
+        remote_object_ids.push_back(object_id);
+      }
     }
   }
+  if (remote_object_ids.empty()) {
+    return;
+  }
+  // Request the object manager to pull the objects that we haven't already
+  // requested from remote nodes, in one batch.
+  RAY_CHECK_OK(object_manager_.PullObjects(remote_object_ids));
+  for (const auto &object_id : remote_object_ids) {
+    reconstruction_policy_.ListenAndMaybeReconstruct(object_id);
+  }
 }
 
 void TaskDependencyManager::HandleRemoteDependencyCanceled(const ObjectID &object_id) {
@@ -133,7 +140,7 @@ std::vector<TaskID> TaskDependencyManager::HandleObjectMissing(
     }
   }
   // The object is no longer local. Try to make the object local if necessary.
-  HandleRemoteDependencyRequired(object_id);
+  HandleRemoteDependenciesRequired({object_id});
   // Process callbacks for all of the tasks dependent on the object that are
   // now ready to run.
   return waiting_task_ids;
@@ -162,9 +169,7 @@ bool TaskDependencyManager::SubscribeDependencies(
 
   // These dependencies are required by the given task. Try to make them local
   // if necessary.
-  for (const auto &object_id : required_objects) {
-    HandleRemoteDependencyRequired(object_id);
-  }
+  HandleRemoteDependenciesRequired(required_objects);
 
   // Return whether all dependencies are local.
   return (task_entry.num_missing_dependencies == 0);
@@ -211,18 +216,47 @@ void TaskDependencyManager::UnsubscribeDependencies(const TaskID &task_id) {
 std::vector<TaskID> TaskDependencyManager::GetPendingTasks() const {
   std::vector<TaskID> keys;
   keys.reserve(pending_tasks_.size());
-  for (const auto &id_task_pair : pending_tasks_) {
-    keys.push_back(id_task_pair.first);
+  for (const auto &task_id : pending_tasks_) {
+    keys.push_back(task_id);
   }
   return keys;
 }
 
+std::vector<TaskID> TaskDependencyManager::GetTasksWaitingOnlyFor(
+    const std::unordered_set<TaskID> &task_ids) const {
+  // Count the missing dependencies of each subscribed task that are created by
+  // the given tasks.
+  std::unordered_map<TaskID, int64_t> num_dependencies_created;
+  for (const auto &task_id : task_ids) {
+    auto creating_task_entry = required_tasks_.find(task_id);
+    if (creating_task_entry == required_tasks_.end()) {
+      continue;
+    }
+    for (const auto &object_entry : creating_task_entry->second) {
+      if (local_objects_.count(object_entry.first) == 1) {
+        continue;
+      }
+      for (const auto &dependent_task_id : object_entry.second) {
+        num_dependencies_created[dependent_task_id]++;
+      }
+    }
+  }
+
+  std::vector<TaskID> waiting_task_ids;
+  for (const auto &entry : num_dependencies_created) {
+    const auto &task_entry = task_dependencies_.at(entry.first);
+    if (task_entry.num_missing_dependencies == entry.second) {
+      waiting_task_ids.push_back(entry.first);
+    }
+  }
+  return waiting_task_ids;
+}
+
 void TaskDependencyManager::TaskPending(const Task &task) {
   TaskID task_id = task.GetTaskSpecification().TaskId();
 
   // Record that the task is pending execution.
-  auto inserted =
-      pending_tasks_.emplace(task_id, PendingTask(initial_lease_period_ms_, io_service_));
+  auto inserted = pending_tasks_.insert(task_id);
   if (inserted.second) {
     // This is the first time we've heard that this task is pending.  Find any
     // subscribed tasks that are dependent on objects created by the pending
@@ -238,46 +272,10 @@ void TaskDependencyManager::TaskPending(const Task &task) {
     }
 
     // Acquire the lease for the task's execution in the global lease table.
-    AcquireTaskLease(task_id);
+    task_lease_manager_.AcquireLease(task_id);
   }
 }
 
-void TaskDependencyManager::AcquireTaskLease(const TaskID &task_id) {
-  auto it = pending_tasks_.find(task_id);
-  int64_t now_ms = current_time_ms();
-  if (it == pending_tasks_.end()) {
-    return;
-  }
-
-  // Check that we were able to renew the task lease before the previous one
-  // expired.
-  if (now_ms > it->second.expires_at) {
-    RAY_LOG(WARNING) << "Task lease to renew has already expired by "
-                     << (it->second.expires_at - now_ms) << "ms";
-  }
-
-  auto task_lease_data = std::make_shared<TaskLeaseDataT>();
-  task_lease_data->node_manager_id = client_id_.hex();
-  task_lease_data->acquired_at = current_sys_time_ms();
-  task_lease_data->timeout = it->second.lease_period;
-  RAY_CHECK_OK(task_lease_table_.Add(DriverID::nil(), task_id, task_lease_data, nullptr));
-
-  auto period = boost::posix_time::milliseconds(it->second.lease_period / 2);
-  it->second.lease_timer->expires_from_now(period);
-  it->second.lease_timer->async_wait(
-      [this, task_id](const boost::system::error_code &error) {
-        if (!error) {
-          AcquireTaskLease(task_id);
-        } else {
-          // Check that the error was due to the timer being canceled.
-          RAY_CHECK(error == boost::asio::error::operation_aborted);
-        }
-      });
-
-  it->second.expires_at = now_ms + it->second.lease_period;
-  it->second.lease_period *= 2;
-}
-
 void TaskDependencyManager::TaskCanceled(const TaskID &task_id) {
   // Record that the task is no longer pending execution.
   auto it = pending_tasks_.find(task_id);
@@ -285,16 +283,19 @@ void TaskDependencyManager::TaskCanceled(const TaskID &task_id) {
     return;
   }
   pending_tasks_.erase(it);
+  task_lease_manager_.ReleaseLease(task_id);
 
   // Find any subscribed tasks that are dependent on objects created by the
   // canceled task.
   auto remote_task_entry = required_tasks_.find(task_id);
   if (remote_task_entry != required_tasks_.end()) {
+    // The objects created by the task will no longer appear locally since the
+    // task is canceled. Try to make the objects local if necessary.
+    std::vector<ObjectID> object_ids;
     for (const auto &object_entry : remote_task_entry->second) {
-      // This object created by the task will no longer appear locally since
-      // the task is canceled.  Try to make the object local if necessary.
-      HandleRemoteDependencyRequired(object_entry.first);
+      object_ids.push_back(object_entry.first);
     }
+    HandleRemoteDependenciesRequired(object_ids);
   }
 }
 
@@ -308,6 +309,7 @@ void TaskDependencyManager::RemoveTasksAndRelatedObjects(
     task_dependencies_.erase(*it);
     required_tasks_.erase(*it);
     pending_tasks_.erase(*it);
+    task_lease_manager_.ReleaseLease(*it);
   }
 
   // TODO: the size of required_objects_ could be large, consider to add
@@ -6,6 +6,7 @@
 #include "ray/raylet/task.h"
 #include "ray/object_manager/object_manager.h"
 #include "ray/raylet/reconstruction_policy.h"
+#include "ray/raylet/task_lease_manager.h"
 #include "ray/util/util.h"
 // clang-format on
 
@@ -32,6 +33,7 @@ class TaskDependencyManager {
                         ReconstructionPolicyInterface &reconstruction_policy,
                         boost::asio::io_service &io_service, const ClientID &client_id,
                         int64_t initial_lease_period_ms,
+                        int64_t lease_renewal_tick_period_ms,
                         gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table);
 
   /// Check whether an object is locally available.
@@ -105,6 +107,15 @@ class TaskDependencyManager {
   /// \return Return a vector of TaskIDs for tasks registered as pending.
   std::vector<TaskID> GetPendingTasks() const;
 
+  /// Get the subscribed tasks whose missing dependencies are all created by
+  /// the given tasks. These tasks can run as soon as the given tasks finish.
+  ///
+  /// \param task_ids The IDs of the tasks that create the dependencies.
+  /// \return The IDs of the subscribed tasks that are only waiting for
+  /// objects created by the given tasks.
+  std::vector<TaskID> GetTasksWaitingOnlyFor(
+      const std::unordered_set<TaskID> &task_ids) const;
+
   /// Remove all of the tasks specified, and all the objects created by
   /// these tasks from task dependency manager.
   ///
@@ -124,56 +135,30 @@ class TaskDependencyManager {
     int64_t num_missing_dependencies;
   };
 
-  struct PendingTask {
-    PendingTask(int64_t initial_lease_period_ms, boost::asio::io_service &io_service)
-        : lease_period(initial_lease_period_ms),
-          expires_at(INT64_MAX),
-          lease_timer(new boost::asio::deadline_timer(io_service)) {}
-
-    /// The timeout within which the lease should be renewed.
-    int64_t lease_period;
-    /// The time at which the current lease will expire, according to this
-    /// node's steady clock.
-    int64_t expires_at;
-    /// A timer used to determine when to next renew the lease.
-    std::unique_ptr<boost::asio::deadline_timer> lease_timer;
-  };
-
   /// Check whether the given object needs to be made available through object
   /// transfer or reconstruction. These are objects for which: (1) there is a
   /// subscribed task dependent on it, (2) the object is not local, and (3) the
   /// task that creates the object is not pending execution locally.
   bool CheckObjectRequired(const ObjectID &object_id) const;
-  /// If the given object is required, then request that the object be made
-  /// available through object transfer or reconstruction.
-  void HandleRemoteDependencyRequired(const ObjectID &object_id);
+  /// For each of the given objects that is required, request that the object
+  /// be made available through object transfer or reconstruction. The objects
+  /// are pulled in one batch.
+  void HandleRemoteDependenciesRequired(const std::vector<ObjectID> &object_ids);
   /// If the given object is no longer required, then cancel any in-progress
   /// operations to make the object available through object transfer or
   /// reconstruction.
   void HandleRemoteDependencyCanceled(const ObjectID &object_id);
-  /// Acquire the task lease in the GCS for the given task. This is used to
-  /// indicate to other nodes that the task is currently pending on this node.
-  /// The task lease has an expiration time. If we do not renew the lease
-  /// before that time, then other nodes may choose to execute the task.
-  void AcquireTaskLease(const TaskID &task_id);
 
   /// The object manager, used to fetch required objects from remote nodes.
   ObjectManagerInterface &object_manager_;
   /// The reconstruction policy, used to reconstruct required objects that no
   /// longer exist on any live nodes.
   ReconstructionPolicyInterface &reconstruction_policy_;
-  /// The event loop, used to set timers for renewing task leases. The task
-  /// leases are used to indicate which tasks are pending execution on this
-  /// node and must be periodically renewed.
-  boost::asio::io_service &io_service_;
-  /// This node's GCS client ID, used in the task lease information.
-  const ClientID client_id_;
-  /// For a given task, the expiration period of the initial task lease that is
-  /// added to the GCS. The lease expiration period is doubled every time the
-  /// lease is renewed.
-  const int64_t initial_lease_period_ms_;
-  /// The storage system for the task lease table.
-  gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table_;
+  /// The leases in the GCS for the tasks that are pending execution. A task
+  /// lease indicates to other nodes that the task is currently pending on this
+  /// node. The lease has an expiration time. If it is not renewed before that
+  /// time, then other nodes may choose to execute the task.
+  TaskLeaseManager task_lease_manager_;
   /// A mapping from task ID of each subscribed task to its list of object
   /// dependencies.
   std::unordered_map<ray::TaskID, TaskDependencies> task_dependencies_;
@@ -190,7 +175,7 @@ class TaskDependencyManager {
   std::unordered_set<ray::ObjectID> local_objects_;
   /// The set of tasks that are pending execution. Any objects created by these
   /// tasks that are not already local are pending creation.
-  std::unordered_map<ray::TaskID, PendingTask> pending_tasks_;
+  std::unordered_set<ray::TaskID> pending_tasks_;
 };
 
 }  // namespace raylet
@@ -6,6 +6,7 @@
 #include <boost/asio.hpp>
 
 #include "ray/raylet/task_dependency_manager.h"
+#include "ray/raylet/test_util.h"
 
 namespace ray {
 
@@ -13,27 +14,6 @@ namespace raylet {
 
 using ::testing::_;
 
-class MockObjectManager : public ObjectManagerInterface {
- public:
-  MOCK_METHOD1(Pull, ray::Status(const ObjectID &object_id));
-  MOCK_METHOD1(CancelPull, void(const ObjectID &object_id));
-};
-
-class MockReconstructionPolicy : public ReconstructionPolicyInterface {
- public:
-  MOCK_METHOD1(ListenAndMaybeReconstruct, void(const ObjectID &object_id));
-  MOCK_METHOD1(Cancel, void(const ObjectID &object_id));
-};
-
-class MockGcs : public gcs::TableInterface<TaskID, TaskLeaseData> {
- public:
-  MOCK_METHOD4(
-      Add,
-      ray::Status(const JobID &job_id, const TaskID &task_id,
-                  std::shared_ptr<TaskLeaseDataT> &task_data,
-                  const gcs::TableInterface<TaskID, TaskLeaseData>::WriteCallback &done));
-};
-
 class TaskDependencyManagerTest : public ::testing::Test {
  public:
   TaskDependencyManagerTest()
@@ -44,7 +24,7 @@ class TaskDependencyManagerTest : public ::testing::Test {
         initial_lease_period_ms_(100),
         task_dependency_manager_(object_manager_mock_, reconstruction_policy_mock_,
                                  io_service_, ClientID::nil(), initial_lease_period_ms_,
-                                 gcs_mock_) {}
+                                 /*lease_renewal_tick_period_ms=*/10, gcs_mock_) {}
 
   void Run(uint64_t timeout_ms) {
     auto timer_period = boost::posix_time::milliseconds(timeout_ms);
@@ -262,6 +242,51 @@ TEST_F(TaskDependencyManagerTest, TestTaskChain) {
   }
 }
 
+TEST_F(TaskDependencyManagerTest, TestTasksWaitingOnlyFor) {
+  // Create 3 pending tasks, each dependent on the previous, and a task that is
+  // dependent on the first task and on a remote object.
+  auto tasks = MakeTaskChain(3, {}, 1);
+  const TaskID task_id1 = tasks[0].GetTaskSpecification().TaskId();
+  const TaskID task_id2 = tasks[1].GetTaskSpecification().TaskId();
+  const TaskID task_id3 = tasks[2].GetTaskSpecification().TaskId();
+  const ObjectID remote_object_id = ObjectID::from_random();
+  auto remote_task = ExampleTask({tasks[0].GetTaskSpecification().ReturnId(0),
+                                  remote_object_id},
+                                 0);
+  tasks.push_back(remote_task);
+  const TaskID remote_task_id = remote_task.GetTaskSpecification().TaskId();
+  EXPECT_CALL(gcs_mock_, Add(_, _, _, _)).Times(tasks.size());
+  EXPECT_CALL(object_manager_mock_, Pull(remote_object_id));
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(remote_object_id));
+  for (const auto &task : tasks) {
+    task_dependency_manager_.TaskPending(task);
+  }
+  // The first task has no arguments, so only subscribe to the others.
+  for (size_t i = 1; i < tasks.size(); i++) {
+    ASSERT_FALSE(task_dependency_manager_.SubscribeDependencies(
+        tasks[i].GetTaskSpecification().TaskId(), tasks[i].GetDependencies()));
+  }
+
+  // The task that needs the remote object is not only waiting for the first
+  // task.
+  auto waiting_task_ids = task_dependency_manager_.GetTasksWaitingOnlyFor({task_id1});
+  ASSERT_EQ(waiting_task_ids, std::vector<TaskID>({task_id2}));
+  waiting_task_ids =
+      task_dependency_manager_.GetTasksWaitingOnlyFor({task_id1, task_id2});
+  ASSERT_EQ(std::unordered_set<TaskID>(waiting_task_ids.begin(), waiting_task_ids.end()),
+            std::unordered_set<TaskID>({task_id2, task_id3}));
+  ASSERT_TRUE(task_dependency_manager_.GetTasksWaitingOnlyFor({task_id3}).empty());
+
+  // Once the remote object is local, the task is only waiting for the first
+  // task.
+  EXPECT_CALL(object_manager_mock_, CancelPull(remote_object_id));
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(remote_object_id));
+  ASSERT_TRUE(task_dependency_manager_.HandleObjectLocal(remote_object_id).empty());
+  waiting_task_ids = task_dependency_manager_.GetTasksWaitingOnlyFor({task_id1});
+  ASSERT_EQ(std::unordered_set<TaskID>(waiting_task_ids.begin(), waiting_task_ids.end()),
+            std::unordered_set<TaskID>({task_id2, remote_task_id}));
+}
+
 TEST_F(TaskDependencyManagerTest, TestDependentPut) {
   // Create a task with 3 arguments.
   auto task1 = ExampleTask({}, 0);
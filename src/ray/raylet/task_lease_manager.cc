@@ -0,0 +1,139 @@
+#include "ray/raylet/task_lease_manager.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace {
+
+// The number of slots in the timer wheel. Leases that are due further ahead
+// than this many ticks stay in their slot for more than one revolution.
+const size_t kNumTimerWheelSlots = 256;
+
+}  // namespace
+
+namespace ray {
+
+namespace raylet {
+
+TaskLeaseManager::TaskLeaseManager(
+    boost::asio::io_service &io_service, const ClientID &client_id,
+    int64_t initial_lease_period_ms, int64_t tick_period_ms,
+    gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table)
+    : client_id_(client_id),
+      initial_lease_period_ms_(initial_lease_period_ms),
+      tick_period_ms_(tick_period_ms),
+      task_lease_table_(task_lease_table),
+      timer_wheel_(kNumTimerWheelSlots),
+      current_tick_(0),
+      tick_timer_(io_service),
+      ticking_(false) {
+  RAY_CHECK(tick_period_ms_ > 0);
+}
+
+void TaskLeaseManager::AcquireLease(const TaskID &task_id) {
+  auto inserted = leases_.emplace(task_id, Lease{initial_lease_period_ms_, INT64_MAX, 0});
+  if (!inserted.second) {
+    return;
+  }
+  WriteLease(task_id, inserted.first->second);
+
+  // Start the timer wheel if this is the only lease.
+  if (!ticking_) {
+    ticking_ = true;
+    tick_timer_.expires_from_now(boost::posix_time::milliseconds(tick_period_ms_));
+    ScheduleTick();
+  }
+}
+
+void TaskLeaseManager::ReleaseLease(const TaskID &task_id) {
+  // The lease's entry on the timer wheel is dropped when its slot comes up.
+  leases_.erase(task_id);
+}
+
+size_t TaskLeaseManager::NumLeases() const { return leases_.size(); }
+
+void TaskLeaseManager::WriteLease(const TaskID &task_id, Lease &lease) {
+  // Check that we were able to renew the task lease before the previous one
+  // expired.
+  int64_t now_ms = current_time_ms();
+  if (now_ms > lease.expires_at) {
+    RAY_LOG(WARNING) << "Task lease to renew has already expired by "
+                     << (now_ms - lease.expires_at) << "ms";
+  }
+
+  auto task_lease_data = std::make_shared<TaskLeaseDataT>();
+  task_lease_data->node_manager_id = client_id_.hex();
+  task_lease_data->acquired_at = current_sys_time_ms();
+  task_lease_data->timeout = lease.lease_period;
+  RAY_CHECK_OK(task_lease_table_.Add(DriverID::nil(), task_id, task_lease_data, nullptr));
+
+  // Renew the lease halfway through its period, rounded down to a whole
+  // number of ticks so that the renewal is never late.
+  const int64_t renewal_ticks =
+      std::max<int64_t>(1, lease.lease_period / 2 / tick_period_ms_);
+  lease.renewal_tick = current_tick_ + renewal_ticks;
+  timer_wheel_[lease.renewal_tick % timer_wheel_.size()].emplace_back(
+      task_id, lease.renewal_tick);
+
+  lease.expires_at = now_ms + lease.lease_period;
+  lease.lease_period *= 2;
+}
+
+void TaskLeaseManager::Tick() {
+  current_tick_++;
+  auto &slot = timer_wheel_[current_tick_ % timer_wheel_.size()];
+  std::vector<TaskID> due_task_ids;
+  size_t num_kept = 0;
+  for (size_t i = 0; i < slot.size(); i++) {
+    if (slot[i].second > current_tick_) {
+      // The lease is due in a later revolution of the wheel.
+      slot[num_kept++] = slot[i];
+      continue;
+    }
+    auto it = leases_.find(slot[i].first);
+    if (it != leases_.end() && it->second.renewal_tick == slot[i].second) {
+      // Reset the renewal tick, in case a lease that was released and
+      // acquired again is in the slot twice.
+      it->second.renewal_tick = 0;
+      due_task_ids.push_back(slot[i].first);
+    }
+  }
+  slot.erase(slot.begin() + num_kept, slot.end());
+
+  // Renew the due leases together, so that their GCS writes are pipelined.
+  for (const auto &task_id : due_task_ids) {
+    WriteLease(task_id, leases_[task_id]);
+  }
+
+  if (leases_.empty()) {
+    // Stop the timer wheel until a lease is acquired again. All of the
+    // remaining entries are for released leases.
+    ticking_ = false;
+    for (auto &stale_slot : timer_wheel_) {
+      stale_slot.clear();
+    }
+    return;
+  }
+  // Set the timer relative to the last expiration, so that the wheel does not
+  // drift behind the leases' periods.
+  tick_timer_.expires_at(tick_timer_.expires_at() +
+                         boost::posix_time::milliseconds(tick_period_ms_));
+  ScheduleTick();
+}
+
+void TaskLeaseManager::ScheduleTick() {
+  tick_timer_.async_wait([this](const boost::system::error_code &error) {
+    if (!error) {
+      Tick();
+    } else {
+      // Check that the error was due to the timer being canceled.
+      RAY_CHECK(error == boost::asio::error::operation_aborted);
+    }
+  });
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,119 @@
+#ifndef RAY_RAYLET_TASK_LEASE_MANAGER_H
+#define RAY_RAYLET_TASK_LEASE_MANAGER_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "ray/gcs/tables.h"
+#include "ray/id.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class TaskLeaseManager
+///
+/// Holds the leases in the GCS task lease table for the tasks that are pending
+/// execution on this node. A lease has an expiration period that doubles every
+/// time it is renewed, and it is renewed halfway through its period. Instead
+/// of setting a timer per lease, the leases are kept on a timer wheel that is
+/// driven by a single periodic timer. All of the leases that are due in the
+/// same tick are renewed together, so the GCS writes for a tick are issued
+/// back to back and pipelined on the GCS connections.
+class TaskLeaseManager {
+ public:
+  /// Create a task lease manager.
+  ///
+  /// \param io_service The event loop to run the timer wheel on.
+  /// \param client_id This node's GCS client ID, used in the task lease
+  /// information.
+  /// \param initial_lease_period_ms The expiration period of the first lease
+  /// that is added for a task.
+  /// \param tick_period_ms The period of the timer wheel. Leases are renewed
+  /// at most this long before they are due.
+  /// \param task_lease_table The storage system for the task lease table.
+  TaskLeaseManager(boost::asio::io_service &io_service, const ClientID &client_id,
+                   int64_t initial_lease_period_ms, int64_t tick_period_ms,
+                   gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table);
+
+  /// Acquire the lease for a task and keep renewing it until the lease is
+  /// released. The first lease is added to the GCS immediately. This does
+  /// nothing if the task's lease is already held.
+  ///
+  /// \param task_id The ID of the task to acquire the lease for.
+  /// \return Void.
+  void AcquireLease(const TaskID &task_id);
+
+  /// Stop renewing the lease for a task. The lease entry in the GCS expires at
+  /// the end of its current period.
+  ///
+  /// \param task_id The ID of the task to release the lease for.
+  /// \return Void.
+  void ReleaseLease(const TaskID &task_id);
+
+  /// Get the number of task leases held by this node.
+  ///
+  /// \return The number of leases that are being renewed.
+  size_t NumLeases() const;
+
+ private:
+  /// The state of a lease held by this node.
+  struct Lease {
+    /// The expiration period of the next lease that is added.
+    int64_t lease_period;
+    /// The time at which the current lease will expire, according to this
+    /// node's steady clock.
+    int64_t expires_at;
+    /// The tick of the timer wheel at which the lease will be renewed.
+    uint64_t renewal_tick;
+  };
+
+  /// Add the next lease for a task to the GCS and schedule its renewal on the
+  /// timer wheel.
+  ///
+  /// \param task_id The ID of the task whose lease to add.
+  /// \param lease The state of the task's lease.
+  /// \return Void.
+  void WriteLease(const TaskID &task_id, Lease &lease);
+
+  /// Renew the leases that are due in the current tick, and advance the timer
+  /// wheel. The timer stops once no leases are held.
+  ///
+  /// \return Void.
+  void Tick();
+
+  /// Wait for the tick timer to expire and then run the next tick.
+  ///
+  /// \return Void.
+  void ScheduleTick();
+
+  /// This node's GCS client ID, used in the task lease information.
+  const ClientID client_id_;
+  /// The expiration period of the first lease added for a task.
+  const int64_t initial_lease_period_ms_;
+  /// The period of the timer wheel.
+  const int64_t tick_period_ms_;
+  /// The storage system for the task lease table.
+  gcs::TableInterface<TaskID, TaskLeaseData> &task_lease_table_;
+  /// The leases held by this node.
+  std::unordered_map<TaskID, Lease> leases_;
+  /// The slots of the timer wheel. A lease that is renewed at tick t is in
+  /// slot t modulo the number of slots, along with the tick it is due at, so
+  /// leases that are due more than one revolution ahead stay in their slot.
+  /// Entries for released or rescheduled leases are dropped lazily.
+  std::vector<std::vector<std::pair<TaskID, uint64_t>>> timer_wheel_;
+  /// The number of ticks that the timer wheel has advanced.
+  uint64_t current_tick_;
+  /// The timer that drives the timer wheel.
+  boost::asio::deadline_timer tick_timer_;
+  /// Whether the tick timer is set.
+  bool ticking_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // RAY_RAYLET_TASK_LEASE_MANAGER_H
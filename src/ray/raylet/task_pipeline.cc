@@ -0,0 +1,107 @@
+#include "ray/raylet/task_pipeline.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+TaskPipeline::TaskPipeline(SchedulingQueue &queue,
+                           TaskDependencyManager &task_dependency_manager)
+    : queue_(queue), task_dependency_manager_(task_dependency_manager) {}
+
+std::vector<Task> TaskPipeline::PipelineReadyTasks(
+    Worker &worker, const ResourceIdSet &local_available_resources,
+    size_t max_pipelined_tasks) {
+  std::vector<Task> pipelined_tasks;
+  // A blocked worker may be waiting for a task that would be pipelined behind
+  // it.
+  if (worker.GetAssignedTaskId().is_nil() || worker.IsBlocked() || worker.IsDead() ||
+      worker.GetPipelinedTasks().size() >= max_pipelined_tasks) {
+    return pipelined_tasks;
+  }
+  const ResourceSet worker_resources = worker.GetTaskResourceIds().ToResourceSet();
+  // Tasks that fit the local resources should run on their own worker.
+  if (local_available_resources.Contains(worker_resources)) {
+    return pipelined_tasks;
+  }
+  const auto &buckets = queue_.GetReadyTasksByShape();
+  auto bucket = std::find_if(buckets.begin(), buckets.end(),
+                             [&worker_resources](const ResourceShapeBucket &bucket) {
+                               return bucket.resources.IsEqual(worker_resources);
+                             });
+  if (bucket == buckets.end()) {
+    return pipelined_tasks;
+  }
+
+  // Choose the tasks at the front of the group first, since the group is
+  // erased once its last task is removed.
+  std::vector<TaskID> task_ids;
+  for (const auto &task_id : bucket->task_ids) {
+    if (worker.GetPipelinedTasks().size() + task_ids.size() >= max_pipelined_tasks) {
+      break;
+    }
+    const auto &spec = queue_.GetReadyTask(task_id).GetTaskSpecification();
+    // Actor tasks and actor creation tasks need their own worker. A child of
+    // the running task would likely be waited on by its parent. The tasks
+    // behind this one stay queued so that the group's order is kept.
+    if (spec.IsActorTask() || spec.IsActorCreationTask() ||
+        spec.GetLanguage() != worker.GetLanguage() ||
+        spec.ParentTaskId() == worker.GetAssignedTaskId()) {
+      break;
+    }
+    task_ids.push_back(task_id);
+  }
+  for (const auto &task_id : task_ids) {
+    // (See design_docs/task_states.rst for the state transition diagram.)
+    pipelined_tasks.push_back(queue_.RemoveTask(task_id));
+    PipelineTask(worker, pipelined_tasks.back());
+  }
+  return pipelined_tasks;
+}
+
+void TaskPipeline::PipelineTask(Worker &worker, const Task &task) {
+  worker.PipelineTask(task);
+  // The task is not in any queue while it is pipelined, so stop tracking its
+  // dependencies until it is revoked.
+  task_dependency_manager_.UnsubscribeDependencies(task.GetTaskSpecification().TaskId());
+}
+
+Task TaskPipeline::StartPipelinedTask(Worker &worker,
+                                      SchedulingResources &local_resources) {
+  RAY_CHECK(worker.GetAssignedTaskId().is_nil());
+  Task task = worker.PopPipelinedTask();
+  const TaskSpecification &spec = task.GetTaskSpecification();
+  worker.AssignTaskId(spec.TaskId());
+  worker.AssignDriverId(spec.DriverId());
+  // The specific resource IDs are the ones that the finished task held, so
+  // only the resource totals change.
+  RAY_CHECK(local_resources.Acquire(spec.GetRequiredResources()));
+  return task;
+}
+
+std::vector<Task> TaskPipeline::RevokePipelinedTasks(Worker &worker) {
+  const auto tasks = worker.ClearPipelinedTasks();
+  // Track the tasks' dependencies again. Pipelined actor methods may still
+  // be waiting for the methods before them.
+  std::vector<Task> ready_tasks;
+  std::vector<Task> waiting_tasks;
+  for (const auto &task : tasks) {
+    if (task_dependency_manager_.SubscribeDependencies(
+            task.GetTaskSpecification().TaskId(), task.GetDependencies())) {
+      ready_tasks.push_back(task);
+    } else {
+      waiting_tasks.push_back(task);
+    }
+  }
+  // (See design_docs/task_states.rst for the state transition diagram.)
+  queue_.QueueReadyTasks(ready_tasks);
+  queue_.QueueWaitingTasks(waiting_tasks);
+  return tasks;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
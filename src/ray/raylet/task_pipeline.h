@@ -0,0 +1,84 @@
+#ifndef RAY_RAYLET_TASK_PIPELINE_H
+#define RAY_RAYLET_TASK_PIPELINE_H
+
+#include <vector>
+
+#include "ray/raylet/scheduling_queue.h"
+#include "ray/raylet/scheduling_resources.h"
+#include "ray/raylet/task.h"
+#include "ray/raylet/task_dependency_manager.h"
+#include "ray/raylet/worker.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class TaskPipeline
+///
+/// Tracks the tasks that are pipelined to busy workers, i.e., sent to a worker
+/// to run after its assigned task so that the worker starts its next task
+/// without waiting for the node manager. A pipelined task is in none of the
+/// local queues and reuses the specific resource IDs of the task before it.
+/// This class only moves tasks between the local queues, the workers and the
+/// task dependency manager. The node manager sends the messages to the
+/// workers.
+class TaskPipeline {
+ public:
+  /// Create a task pipeline.
+  ///
+  /// \param queue The local task queues.
+  /// \param task_dependency_manager The local task dependency manager.
+  TaskPipeline(SchedulingQueue &queue, TaskDependencyManager &task_dependency_manager);
+
+  /// Pipeline ready tasks to a non-actor worker that is running a task. Only
+  /// tasks with the same resource demand as the running task are pipelined,
+  /// and only if there are not enough local resources to run them on their
+  /// own worker. Actor tasks, tasks in another language and children of the
+  /// running task are never pipelined.
+  ///
+  /// \param worker The worker.
+  /// \param local_available_resources The resources available on this node.
+  /// \param max_pipelined_tasks The maximum number of tasks pipelined to a
+  /// worker at once.
+  /// \return The tasks pipelined to the worker, in the order that the worker
+  /// runs them.
+  std::vector<Task> PipelineReadyTasks(Worker &worker,
+                                       const ResourceIdSet &local_available_resources,
+                                       size_t max_pipelined_tasks);
+
+  /// Pipeline a task to a worker that is running a task.
+  ///
+  /// \param worker The worker.
+  /// \param task The task. It must not be in any of the local queues.
+  /// \return Void.
+  void PipelineTask(Worker &worker, const Task &task);
+
+  /// Make a worker's next pipelined task its assigned task, once the worker
+  /// has finished its previous task without releasing its specific resource
+  /// IDs. The task is not queued as running.
+  ///
+  /// \param worker The worker.
+  /// \param local_resources This node's resource totals, in which the task's
+  /// resources are acquired again.
+  /// \return The started task.
+  Task StartPipelinedTask(Worker &worker, SchedulingResources &local_resources);
+
+  /// Take back the tasks that were pipelined to a worker and queue them again
+  /// as ready or waiting, depending on whether their dependencies are local.
+  ///
+  /// \param worker The worker.
+  /// \return The revoked tasks.
+  std::vector<Task> RevokePipelinedTasks(Worker &worker);
+
+ private:
+  /// The local task queues.
+  SchedulingQueue &queue_;
+  /// The local task dependency manager.
+  TaskDependencyManager &task_dependency_manager_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // RAY_RAYLET_TASK_PIPELINE_H
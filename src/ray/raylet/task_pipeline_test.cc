@@ -0,0 +1,294 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <boost/asio.hpp>
+
+#include "ray/raylet/task_pipeline.h"
+#include "ray/raylet/test_util.h"
+
+namespace ray {
+
+namespace raylet {
+
+static inline Task ExampleActorTask(double num_cpus) {
+  std::unordered_map<std::string, double> required_resources = {
+      {kCPU_ResourceLabel, num_cpus}};
+  auto spec = TaskSpecification(UniqueID::nil(), TaskID::from_random(), 0,
+                                ActorID::nil(), ObjectID::from_random(),
+                                ActorID::from_random(), ActorHandleID::from_random(), 0,
+                                UniqueID::from_random(), {}, 1, required_resources,
+                                Language::PYTHON);
+  auto execution_spec = TaskExecutionSpecification(std::vector<ObjectID>());
+  return Task(execution_spec, spec);
+}
+
+class TaskPipelineTest : public ::testing::Test {
+ public:
+  TaskPipelineTest()
+      : object_manager_mock_(),
+        reconstruction_policy_mock_(),
+        io_service_(),
+        gcs_mock_(),
+        task_dependency_manager_(object_manager_mock_, reconstruction_policy_mock_,
+                                 io_service_, ClientID::nil(),
+                                 /*initial_lease_period_ms=*/100,
+                                 /*lease_renewal_tick_period_ms=*/10, gcs_mock_),
+        queue_(),
+        task_pipeline_(queue_, task_dependency_manager_),
+        local_resources_(ResourceSet(
+            std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 1}}))),
+        local_available_resources_(ResourceSet(
+            std::unordered_map<std::string, double>({{kCPU_ResourceLabel, 1}}))),
+        max_pipelined_tasks_(2) {}
+
+  /// Queue a task as ready, as the node manager does once its dependencies
+  /// are local.
+  void QueueReadyTask(const Task &task) {
+    ASSERT_TRUE(task_dependency_manager_.SubscribeDependencies(
+        task.GetTaskSpecification().TaskId(), task.GetDependencies()));
+    queue_.QueueReadyTasks(std::vector<Task>({task}));
+  }
+
+  /// Assign a task to a worker, as the node manager does when it dispatches
+  /// the task.
+  void AssignTask(Worker &worker, const Task &task) {
+    const auto &spec = task.GetTaskSpecification();
+    auto acquired_resources =
+        local_available_resources_.Acquire(spec.GetRequiredResources());
+    worker.SetTaskResourceIds(acquired_resources);
+    ASSERT_TRUE(local_resources_.Acquire(spec.GetRequiredResources()));
+    worker.AssignTaskId(spec.TaskId());
+    queue_.QueueRunningTasks(std::vector<Task>({task}));
+  }
+
+  /// Finish a worker's assigned task without releasing its specific resource
+  /// IDs, as the node manager does when the worker has a pipelined task.
+  void FinishAssignedTask(Worker &worker) {
+    const auto task = queue_.RemoveTask(worker.GetAssignedTaskId());
+    ASSERT_TRUE(
+        local_resources_.Release(task.GetTaskSpecification().GetRequiredResources()));
+    worker.AssignTaskId(TaskID::nil());
+  }
+
+  bool HasState(const Task &task, TaskState state) {
+    std::unordered_set<TaskID> task_ids = {task.GetTaskSpecification().TaskId()};
+    queue_.FilterState(task_ids, state);
+    return task_ids.empty();
+  }
+
+ protected:
+  MockObjectManager object_manager_mock_;
+  MockReconstructionPolicy reconstruction_policy_mock_;
+  boost::asio::io_service io_service_;
+  MockGcs gcs_mock_;
+  TaskDependencyManager task_dependency_manager_;
+  SchedulingQueue queue_;
+  TaskPipeline task_pipeline_;
+  SchedulingResources local_resources_;
+  ResourceIdSet local_available_resources_;
+  size_t max_pipelined_tasks_;
+};
+
+TEST_F(TaskPipelineTest, TestPipelineTasksWithMatchingShape) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+
+  // Only the tasks with the running task's resource demand are pipelined, up
+  // to the maximum number of pipelined tasks.
+  const Task large_task = ExampleTask(2);
+  QueueReadyTask(large_task);
+  std::vector<Task> tasks;
+  for (int i = 0; i < 3; i++) {
+    tasks.push_back(ExampleTask(1));
+    QueueReadyTask(tasks.back());
+  }
+  auto pipelined_tasks = task_pipeline_.PipelineReadyTasks(
+      worker, local_available_resources_, max_pipelined_tasks_);
+  ASSERT_EQ(pipelined_tasks.size(), max_pipelined_tasks_);
+  ASSERT_EQ(worker.GetPipelinedTasks().size(), max_pipelined_tasks_);
+  for (size_t i = 0; i < max_pipelined_tasks_; i++) {
+    ASSERT_EQ(pipelined_tasks[i].GetTaskSpecification().TaskId(),
+              tasks[i].GetTaskSpecification().TaskId());
+    ASSERT_FALSE(HasState(tasks[i], TaskState::READY));
+  }
+  ASSERT_TRUE(HasState(tasks.back(), TaskState::READY));
+  ASSERT_TRUE(HasState(large_task, TaskState::READY));
+  // The worker's pipeline is full.
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+}
+
+TEST_F(TaskPipelineTest, TestNoPipeliningWithAvailableResources) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+  const Task task = ExampleTask(1);
+  QueueReadyTask(task);
+
+  // The task fits the local resources, so it runs on its own worker.
+  local_available_resources_.Release(worker.GetTaskResourceIds());
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+  ASSERT_TRUE(HasState(task, TaskState::READY));
+}
+
+TEST_F(TaskPipelineTest, TestNoPipeliningOfActorOrChildTasks) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+
+  // A child of the running task is not pipelined, and neither are the tasks
+  // behind it, so that the queue's order is kept.
+  const Task child_task =
+      ExampleTask(1, {}, 0, running_task.GetTaskSpecification().TaskId());
+  const Task other_task = ExampleTask(1);
+  QueueReadyTask(child_task);
+  QueueReadyTask(other_task);
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+  ASSERT_TRUE(HasState(child_task, TaskState::READY));
+  ASSERT_TRUE(HasState(other_task, TaskState::READY));
+
+  // An actor task is not pipelined to a non-actor worker.
+  std::unordered_set<TaskID> task_ids = {child_task.GetTaskSpecification().TaskId(),
+                                         other_task.GetTaskSpecification().TaskId()};
+  queue_.RemoveTasks(task_ids);
+  const Task actor_task = ExampleActorTask(1);
+  QueueReadyTask(actor_task);
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+  ASSERT_TRUE(HasState(actor_task, TaskState::READY));
+  ASSERT_TRUE(worker.GetPipelinedTasks().empty());
+}
+
+TEST_F(TaskPipelineTest, TestStartPipelinedTaskAfterFinish) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+  const Task task = ExampleTask(1);
+  QueueReadyTask(task);
+  ASSERT_EQ(task_pipeline_
+                .PipelineReadyTasks(worker, local_available_resources_,
+                                    max_pipelined_tasks_)
+                .size(),
+            1u);
+
+  // The pipelined task takes over the finished task's specific resource IDs
+  // and acquires its resources in the node's totals again.
+  FinishAssignedTask(worker);
+  ASSERT_EQ(local_resources_.GetAvailableResources().GetNumCpus(), 1);
+  const Task started_task = task_pipeline_.StartPipelinedTask(worker, local_resources_);
+  ASSERT_EQ(started_task.GetTaskSpecification().TaskId(),
+            task.GetTaskSpecification().TaskId());
+  ASSERT_EQ(worker.GetAssignedTaskId(), task.GetTaskSpecification().TaskId());
+  ASSERT_TRUE(worker.GetPipelinedTasks().empty());
+  ASSERT_EQ(local_resources_.GetAvailableResources().GetNumCpus(), 0);
+  ASSERT_EQ(worker.GetTaskResourceIds().ToResourceSet().GetNumCpus(), 1);
+  ASSERT_EQ(local_available_resources_.ToResourceSet().GetNumCpus(), 0);
+
+  // Finishing the started task returns all of the node's resources.
+  queue_.QueueRunningTasks(std::vector<Task>({started_task}));
+  FinishAssignedTask(worker);
+  local_available_resources_.Release(worker.GetTaskResourceIds());
+  worker.ResetTaskResourceIds();
+  ASSERT_EQ(local_resources_.GetAvailableResources().GetNumCpus(), 1);
+  ASSERT_EQ(local_available_resources_.ToResourceSet().GetNumCpus(), 1);
+}
+
+TEST_F(TaskPipelineTest, TestRevokeOnBlockRequeuesTasks) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+  const Task ready_task = ExampleTask(1);
+  QueueReadyTask(ready_task);
+  ASSERT_EQ(task_pipeline_
+                .PipelineReadyTasks(worker, local_available_resources_,
+                                    max_pipelined_tasks_)
+                .size(),
+            1u);
+
+  // A task that is pipelined while one of its dependencies is missing, like an
+  // actor method behind the method that creates its cursor, is queued as
+  // waiting once it is revoked.
+  const ObjectID argument_id = ObjectID::from_random();
+  const Task waiting_task = ExampleTask(1, {argument_id});
+  EXPECT_CALL(object_manager_mock_, Pull(argument_id)).Times(2);
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(argument_id))
+      .Times(2);
+  EXPECT_CALL(object_manager_mock_, CancelPull(argument_id));
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(argument_id));
+  ASSERT_FALSE(task_dependency_manager_.SubscribeDependencies(
+      waiting_task.GetTaskSpecification().TaskId(), waiting_task.GetDependencies()));
+  queue_.QueueWaitingTasks(std::vector<Task>({waiting_task}));
+  std::unordered_set<TaskID> task_ids = {waiting_task.GetTaskSpecification().TaskId()};
+  queue_.RemoveTasks(task_ids);
+  task_pipeline_.PipelineTask(worker, waiting_task);
+  ASSERT_EQ(worker.GetPipelinedTasks().size(), 2u);
+
+  // The node manager revokes a worker's pipelined tasks when the worker
+  // blocks, since the blocked task may be waiting for them.
+  worker.MarkBlocked();
+  ASSERT_EQ(task_pipeline_.RevokePipelinedTasks(worker).size(), 2u);
+  ASSERT_TRUE(worker.GetPipelinedTasks().empty());
+  ASSERT_TRUE(HasState(ready_task, TaskState::READY));
+  ASSERT_TRUE(HasState(waiting_task, TaskState::WAITING));
+  // Nothing is pipelined to the worker while it is blocked.
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+  ASSERT_TRUE(HasState(ready_task, TaskState::READY));
+}
+
+TEST_F(TaskPipelineTest, TestRevokeOnDisconnectRequeuesTasks) {
+  Worker worker(1234, Language::PYTHON, nullptr);
+  const Task running_task = ExampleTask(1);
+  AssignTask(worker, running_task);
+  std::vector<Task> tasks;
+  for (size_t i = 0; i < max_pipelined_tasks_; i++) {
+    tasks.push_back(ExampleTask(1));
+    QueueReadyTask(tasks.back());
+  }
+  ASSERT_EQ(task_pipeline_
+                .PipelineReadyTasks(worker, local_available_resources_,
+                                    max_pipelined_tasks_)
+                .size(),
+            max_pipelined_tasks_);
+
+  // The node manager revokes a worker's pipelined tasks when the worker
+  // disconnects, so that other workers run them.
+  ASSERT_EQ(task_pipeline_.RevokePipelinedTasks(worker).size(), max_pipelined_tasks_);
+  worker.MarkDead();
+  for (const auto &task : tasks) {
+    ASSERT_TRUE(HasState(task, TaskState::READY));
+  }
+  ASSERT_TRUE(task_pipeline_
+                  .PipelineReadyTasks(worker, local_available_resources_,
+                                      max_pipelined_tasks_)
+                  .empty());
+
+  // The revoked tasks can be pipelined to another worker, with their
+  // dependencies tracked again.
+  Worker other_worker(1235, Language::PYTHON, nullptr);
+  ResourceIdSet resource_ids = worker.GetTaskResourceIds();
+  other_worker.SetTaskResourceIds(resource_ids);
+  other_worker.AssignTaskId(TaskID::from_random());
+  ASSERT_EQ(task_pipeline_
+                .PipelineReadyTasks(other_worker, local_available_resources_,
+                                    max_pipelined_tasks_)
+                .size(),
+            max_pipelined_tasks_);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -31,6 +31,8 @@ flatbuffers::Offset<Arg> TaskArgumentByValue::ToFlatbuffer(
 
 void TaskSpecification::AssignSpecification(const uint8_t *spec, size_t spec_size) {
   spec_.assign(spec, spec + spec_size);
+  auto message = flatbuffers::GetRoot<TaskInfo>(spec_.data());
+  required_resources_ = ResourceSet(map_from_flatbuf(*message->required_resources()));
 }
 
 TaskSpecification::TaskSpecification(const flatbuffers::String &string) {
@@ -46,11 +48,11 @@ TaskSpecification::TaskSpecification(
     const FunctionID &function_id,
     const std::vector<std::shared_ptr<TaskArgument>> &task_arguments, int64_t num_returns,
     const std::unordered_map<std::string, double> &required_resources,
-    const Language &language)
+    const Language &language, int64_t priority)
     : TaskSpecification(driver_id, parent_task_id, parent_counter, ActorID::nil(),
                         ObjectID::nil(), ActorID::nil(), ActorHandleID::nil(), -1,
                         function_id, task_arguments, num_returns, required_resources,
-                        language) {}
+                        language, priority) {}
 
 TaskSpecification::TaskSpecification(
     const UniqueID &driver_id, const TaskID &parent_task_id, int64_t parent_counter,
@@ -59,7 +61,7 @@ TaskSpecification::TaskSpecification(
     const FunctionID &function_id,
     const std::vector<std::shared_ptr<TaskArgument>> &task_arguments, int64_t num_returns,
     const std::unordered_map<std::string, double> &required_resources,
-    const Language &language)
+    const Language &language, int64_t priority)
     : spec_() {
   flatbuffers::FlatBufferBuilder fbb;
 
@@ -99,7 +101,8 @@ TaskSpecification::TaskSpecification(
       to_flatbuf(fbb, actor_creation_dummy_object_id), to_flatbuf(fbb, actor_id),
       to_flatbuf(fbb, actor_handle_id), actor_counter, false,
       to_flatbuf(fbb, function_id), fbb.CreateVector(arguments),
-      fbb.CreateVector(returns), map_to_flatbuf(fbb, required_resources), task_language);
+      fbb.CreateVector(returns), map_to_flatbuf(fbb, required_resources), task_language,
+      0, priority);
   fbb.Finish(spec);
   AssignSpecification(fbb.GetBufferPointer(), fbb.GetSize());
 }
@@ -173,10 +176,8 @@ size_t TaskSpecification::ArgValLength(int64_t arg_index) const {
 double TaskSpecification::GetRequiredResource(const std::string &resource_name) const {
   throw std::runtime_error("Method not implemented");
 }
-const ResourceSet TaskSpecification::GetRequiredResources() const {
-  auto message = flatbuffers::GetRoot<TaskInfo>(spec_.data());
-  auto required_resources = map_from_flatbuf(*message->required_resources());
-  return ResourceSet(required_resources);
+const ResourceSet &TaskSpecification::GetRequiredResources() const {
+  return required_resources_;
 }
 
 bool TaskSpecification::IsDriverTask() const {
@@ -200,6 +201,11 @@ Language TaskSpecification::GetLanguage() const {
   }
 }
 
+int64_t TaskSpecification::Priority() const {
+  auto message = flatbuffers::GetRoot<TaskInfo>(spec_.data());
+  return message->priority();
+}
+
 bool TaskSpecification::IsActorCreationTask() const {
   return !ActorCreationId().is_nil();
 }
@@ -94,12 +94,15 @@ class TaskSpecification {
   /// \param arguments The list of task arguments.
   /// \param num_returns The number of values returned by the task.
   /// \param required_resources The task's resource demands.
+  /// \param language The language of the task's function.
+  /// \param priority The priority of the task. Tasks with a higher priority are
+  ///        scheduled before tasks with a lower priority.
   TaskSpecification(const UniqueID &driver_id, const TaskID &parent_task_id,
                     int64_t parent_counter, const FunctionID &function_id,
                     const std::vector<std::shared_ptr<TaskArgument>> &arguments,
                     int64_t num_returns,
                     const std::unordered_map<std::string, double> &required_resources,
-                    const Language &language);
+                    const Language &language, int64_t priority = 0);
 
   TaskSpecification(const UniqueID &driver_id, const TaskID &parent_task_id,
                     int64_t parent_counter, const ActorID &actor_creation_id,
@@ -109,7 +112,7 @@ class TaskSpecification {
                     const std::vector<std::shared_ptr<TaskArgument>> &task_arguments,
                     int64_t num_returns,
                     const std::unordered_map<std::string, double> &required_resources,
-                    const Language &language);
+                    const Language &language, int64_t priority = 0);
 
   /// Deserialize a task specification from a flatbuffer's string data.
   ///
@@ -141,9 +144,10 @@ class TaskSpecification {
   const uint8_t *ArgVal(int64_t arg_index) const;
   size_t ArgValLength(int64_t arg_index) const;
   double GetRequiredResource(const std::string &resource_name) const;
-  const ResourceSet GetRequiredResources() const;
+  const ResourceSet &GetRequiredResources() const;
   bool IsDriverTask() const;
   Language GetLanguage() const;
+  int64_t Priority() const;
 
   // Methods specific to actor tasks.
   bool IsActorCreationTask() const;
@@ -165,6 +169,9 @@ class TaskSpecification {
 
   /// The task specification data.
   std::vector<uint8_t> spec_;
+  /// The task's resource demands, parsed from the specification once so that
+  /// scheduling does not repeatedly deserialize the resource map.
+  ResourceSet required_resources_;
 };
 
 }  // namespace raylet
@@ -0,0 +1,68 @@
+#ifndef RAY_RAYLET_TEST_UTIL_H
+#define RAY_RAYLET_TEST_UTIL_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "ray/raylet/task.h"
+#include "ray/raylet/task_dependency_manager.h"
+
+namespace ray {
+
+namespace raylet {
+
+class MockObjectManager : public ObjectManagerInterface {
+ public:
+  MOCK_METHOD1(Pull, ray::Status(const ObjectID &object_id));
+  MOCK_METHOD1(CancelPull, void(const ObjectID &object_id));
+};
+
+class MockReconstructionPolicy : public ReconstructionPolicyInterface {
+ public:
+  MOCK_METHOD1(ListenAndMaybeReconstruct, void(const ObjectID &object_id));
+  MOCK_METHOD1(Cancel, void(const ObjectID &object_id));
+};
+
+class MockGcs : public gcs::TableInterface<TaskID, TaskLeaseData> {
+ public:
+  MOCK_METHOD4(
+      Add,
+      ray::Status(const JobID &job_id, const TaskID &task_id,
+                  std::shared_ptr<TaskLeaseDataT> &task_data,
+                  const gcs::TableInterface<TaskID, TaskLeaseData>::WriteCallback &done));
+};
+
+/// Create a task that requires a number of CPUs.
+///
+/// \param num_cpus The number of CPUs that the task requires.
+/// \param arguments The objects that the task takes as arguments, each passed
+/// by reference as a separate argument.
+/// \param priority The task's priority.
+/// \param parent_task_id The ID of the task that submitted the task.
+/// \return The task.
+static inline Task ExampleTask(double num_cpus,
+                               const std::vector<ObjectID> &arguments = {},
+                               int64_t priority = 0,
+                               const TaskID &parent_task_id = TaskID::from_random()) {
+  std::unordered_map<std::string, double> required_resources = {
+      {kCPU_ResourceLabel, num_cpus}};
+  std::vector<std::shared_ptr<TaskArgument>> task_arguments;
+  for (const auto &argument : arguments) {
+    std::vector<ObjectID> references = {argument};
+    task_arguments.emplace_back(std::make_shared<TaskArgumentByReference>(references));
+  }
+  auto spec = TaskSpecification(UniqueID::nil(), parent_task_id, 0,
+                                UniqueID::from_random(), task_arguments, 1,
+                                required_resources, Language::PYTHON, priority);
+  auto execution_spec = TaskExecutionSpecification(std::vector<ObjectID>());
+  return Task(execution_spec, spec);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // RAY_RAYLET_TEST_UTIL_H
@@ -91,6 +91,23 @@ void Worker::AcquireTaskCpuResources(const ResourceIdSet &cpu_resources) {
   task_resource_ids_.Release(cpu_resources);
 }
 
+void Worker::PipelineTask(const Task &task) { pipelined_tasks_.push_back(task); }
+
+const std::deque<Task> &Worker::GetPipelinedTasks() const { return pipelined_tasks_; }
+
+Task Worker::PopPipelinedTask() {
+  RAY_CHECK(!pipelined_tasks_.empty());
+  Task task = std::move(pipelined_tasks_.front());
+  pipelined_tasks_.pop_front();
+  return task;
+}
+
+std::vector<Task> Worker::ClearPipelinedTasks() {
+  std::vector<Task> tasks(pipelined_tasks_.begin(), pipelined_tasks_.end());
+  pipelined_tasks_.clear();
+  return tasks;
+}
+
 }  // namespace raylet
 
 }  // end namespace ray
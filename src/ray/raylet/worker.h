@@ -1,11 +1,14 @@
 #ifndef RAY_RAYLET_WORKER_H
 #define RAY_RAYLET_WORKER_H
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "ray/common/client_connection.h"
 #include "ray/id.h"
 #include "ray/raylet/scheduling_resources.h"
+#include "ray/raylet/task.h"
 
 namespace ray {
 
@@ -48,6 +51,17 @@ class Worker {
   ResourceIdSet ReleaseTaskCpuResources();
   void AcquireTaskCpuResources(const ResourceIdSet &cpu_resources);
 
+  /// Queue a task that has been sent to the worker to run after its assigned
+  /// task.
+  void PipelineTask(const Task &task);
+  /// Return the tasks that have been sent to the worker to run after its
+  /// assigned task, in the order that the worker runs them.
+  const std::deque<Task> &GetPipelinedTasks() const;
+  /// Remove and return the next task that the worker runs.
+  Task PopPipelinedTask();
+  /// Remove and return all of the worker's pipelined tasks.
+  std::vector<Task> ClearPipelinedTasks();
+
  private:
   /// The worker's PID.
   pid_t pid_;
@@ -72,6 +86,9 @@ class Worker {
   /// The specific resource IDs that this worker currently owns for the duration
   // of a task.
   ResourceIdSet task_resource_ids_;
+  /// The tasks that have been sent to the worker to run after its assigned
+  /// task. They reuse the assigned task's resources.
+  std::deque<Task> pipelined_tasks_;
 };
 
 }  // namespace raylet
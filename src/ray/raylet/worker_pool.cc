@@ -1,25 +1,98 @@
 #include "ray/raylet/worker_pool.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
 #include <thread>
 
+#include "common/state/ray_config.h"
 #include "ray/status.h"
 #include "ray/util/logging.h"
+#include "ray/util/util.h"
 
 namespace {
 
-// A helper function to get a worker from a list.
-std::shared_ptr<ray::raylet::Worker> GetWorker(
-    const std::list<std::shared_ptr<ray::raylet::Worker>> &worker_pool,
-    const std::shared_ptr<ray::LocalClientConnection> &connection) {
-  for (auto it = worker_pool.begin(); it != worker_pool.end(); it++) {
-    if ((*it)->Connection() == connection) {
-      return (*it);
+// The environment variable that tells a process started from the worker command
+// that it is a fork server, and which file descriptor its socket to the pool is.
+const char kForkServerFdEnvironmentVariable[] = "RAY_WORKER_FORK_SERVER_FD";
+
+// A helper function to wait until a file descriptor is ready for the given
+// poll events or the deadline passes. Returns false if the deadline passed or
+// the poll failed.
+bool WaitForFd(int fd, short events,
+               const std::chrono::steady_clock::time_point &deadline) {
+  while (true) {
+    auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            deadline - std::chrono::steady_clock::now())
+                            .count();
+    struct pollfd poll_fd;
+    poll_fd.fd = fd;
+    poll_fd.events = events;
+    poll_fd.revents = 0;
+    int num_ready = poll(&poll_fd, 1, std::max<int64_t>(remaining_ms, 0));
+    if (num_ready < 0 && errno == EINTR) {
+      continue;
     }
+    // An error or hangup also counts as ready, so that the read or write that
+    // follows reports it.
+    return num_ready > 0;
   }
-  return nullptr;
+}
+
+// A helper function to read a line from a file descriptor, without the
+// trailing newline. Returns false if the file descriptor was closed or failed,
+// or the deadline passed, before a full line was read.
+bool ReadLine(int fd, std::string *line,
+              const std::chrono::steady_clock::time_point &deadline) {
+  line->clear();
+  while (true) {
+    if (!WaitForFd(fd, POLLIN, deadline)) {
+      return false;
+    }
+    char c;
+    ssize_t num_read = read(fd, &c, 1);
+    if (num_read < 0 && errno == EINTR) {
+      continue;
+    } else if (num_read <= 0) {
+      return false;
+    } else if (c == '\n') {
+      return true;
+    }
+    line->push_back(c);
+  }
+}
+
+// A helper function to write a string to a file descriptor. Returns false if
+// the write failed or the deadline passed.
+bool WriteString(int fd, const std::string &data,
+                 const std::chrono::steady_clock::time_point &deadline) {
+  size_t position = 0;
+  while (position < data.size()) {
+    if (!WaitForFd(fd, POLLOUT, deadline)) {
+      return false;
+    }
+    ssize_t num_written = write(fd, data.data() + position, data.size() - position);
+    if (num_written < 0 && errno == EINTR) {
+      continue;
+    } else if (num_written < 0) {
+      return false;
+    }
+    position += num_written;
+  }
+  return true;
+}
+
+// Get the deadline for an exchange with a fork server that starts now.
+std::chrono::steady_clock::time_point ForkServerDeadline() {
+  return std::chrono::steady_clock::now() +
+         std::chrono::milliseconds(
+             RayConfig::instance().worker_fork_timeout_milliseconds());
 }
 
 // A helper function to remove a worker from a list. Returns true if the worker
@@ -46,7 +119,8 @@ namespace raylet {
 WorkerPool::WorkerPool(
     int num_worker_processes, int num_workers_per_process,
     int maximum_startup_concurrency,
-    const std::unordered_map<Language, std::vector<std::string>> &worker_commands)
+    const std::unordered_map<Language, std::vector<std::string>> &worker_commands,
+    const std::unordered_set<Language> &fork_server_languages)
     : num_workers_per_process_(num_workers_per_process),
       maximum_startup_concurrency_(maximum_startup_concurrency) {
   RAY_CHECK(num_workers_per_process > 0) << "num_workers_per_process must be positive.";
@@ -60,6 +134,9 @@ WorkerPool::WorkerPool(
     // Set worker command for this language.
     state.worker_command = entry.second;
     RAY_CHECK(!state.worker_command.empty()) << "Worker command must not be empty.";
+    if (fork_server_languages.count(entry.first) > 0) {
+      StartForkServer(state);
+    }
     // Force-start num_workers worker processes for this language.
     for (int i = 0; i < num_worker_processes; i++) {
       StartWorkerProcess(entry.first);
@@ -69,12 +146,16 @@ WorkerPool::WorkerPool(
 
 WorkerPool::~WorkerPool() {
   std::unordered_set<pid_t> pids_to_kill;
-  for (const auto &entry : states_by_lang_) {
+  for (auto &entry : states_by_lang_) {
     // Kill all registered workers. NOTE(swang): This assumes that the registered
     // workers were started by the pool.
     for (const auto &worker : entry.second.registered_workers) {
       pids_to_kill.insert(worker->Pid());
     }
+    if (entry.second.fork_server_pid != -1) {
+      pids_to_kill.insert(entry.second.fork_server_pid);
+    }
+    StopForkServer(entry.second);
   }
   // Kill all the workers that have been started but not registered.
   for (const auto &entry : starting_worker_processes_) {
@@ -116,20 +197,61 @@ void WorkerPool::StartWorkerProcess(const Language &language) {
                  << state.idle_actor.size() << " actor workers, and " << state.idle.size()
                  << " non-actor workers";
 
+  // Fork the worker from the fork server if it is ready, since that skips the
+  // worker's initialization. Otherwise, launch the process from the worker
+  // command.
+  pid_t pid = -1;
+  if (IsForkServerReady(language)) {
+    pid = ForkWorkerProcess(state);
+  }
+  if (pid == -1) {
+    pid = StartProcess(state.worker_command, -1);
+  }
+  RAY_LOG(DEBUG) << "Started worker process with pid " << pid;
+  starting_worker_processes_.emplace(std::make_pair(pid, num_workers_per_process_));
+  state.starting_worker_processes.insert(pid);
+}
+
+bool WorkerPool::IsForkServerReady(const Language &language) {
+  auto &state = GetStateForLanguage(language);
+  if (state.fork_server_fd == -1 || state.fork_server_ready) {
+    return state.fork_server_ready;
+  }
+  // Check whether the fork server has started writing its ready line, without
+  // blocking.
+  if (!WaitForFd(state.fork_server_fd, POLLIN, std::chrono::steady_clock::now())) {
+    return false;
+  }
+  std::string line;
+  if (ReadLine(state.fork_server_fd, &line, ForkServerDeadline()) && line == "ready") {
+    RAY_LOG(DEBUG) << "Fork server with pid " << state.fork_server_pid << " is ready";
+    state.fork_server_ready = true;
+  } else {
+    RAY_LOG(WARNING) << "Fork server with pid " << state.fork_server_pid
+                     << " failed to start, starting workers from the worker command";
+    StopForkServer(state);
+  }
+  return state.fork_server_ready;
+}
+
+pid_t WorkerPool::StartProcess(const std::vector<std::string> &worker_command,
+                               int fork_server_fd) {
   // Launch the process to create the worker.
   pid_t pid = fork();
   if (pid != 0) {
-    RAY_LOG(DEBUG) << "Started worker process with pid " << pid;
-    starting_worker_processes_.emplace(std::make_pair(pid, num_workers_per_process_));
-    return;
+    RAY_CHECK(pid > 0) << "Failed to fork a worker process";
+    return pid;
   }
 
   // Reset the SIGCHLD handler for the worker.
   signal(SIGCHLD, SIG_DFL);
+  if (fork_server_fd != -1) {
+    setenv(kForkServerFdEnvironmentVariable, std::to_string(fork_server_fd).c_str(), 1);
+  }
 
   // Extract pointers from the worker command to pass into execvp.
   std::vector<const char *> worker_command_args;
-  for (auto const &token : state.worker_command) {
+  for (auto const &token : worker_command) {
     worker_command_args.push_back(token.c_str());
   }
   worker_command_args.push_back(nullptr);
@@ -139,48 +261,118 @@ void WorkerPool::StartWorkerProcess(const Language &language) {
                   const_cast<char *const *>(worker_command_args.data()));
   // The worker failed to start. This is a fatal error.
   RAY_LOG(FATAL) << "Failed to start worker with return value " << rv;
+  return -1;
+}
+
+void WorkerPool::StartForkServer(State &state) {
+  int fds[2];
+  RAY_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  // Keep the pool's end of the socket out of the worker processes that are
+  // started from the worker command.
+  RAY_CHECK(fcntl(fds[0], F_SETFD, FD_CLOEXEC) == 0);
+  state.fork_server_pid = StartProcess(state.worker_command, fds[1]);
+  close(fds[1]);
+  state.fork_server_fd = fds[0];
+  state.fork_server_ready = false;
+  RAY_LOG(DEBUG) << "Started fork server with pid " << state.fork_server_pid;
+}
+
+pid_t WorkerPool::ForkWorkerProcess(State &state) {
+  RAY_CHECK(state.fork_server_ready);
+  // This runs on the event loop, so give up on a fork server that does not
+  // answer in time. If it forks the worker after all, the worker registers
+  // with a process ID that the pool does not expect, which is tolerated.
+  const auto deadline = ForkServerDeadline();
+  std::string line;
+  if (WriteString(state.fork_server_fd, "fork\n", deadline) &&
+      ReadLine(state.fork_server_fd, &line, deadline)) {
+    char *end;
+    long pid = strtol(line.c_str(), &end, 10);
+    if (*end == '\0' && pid > 0) {
+      return static_cast<pid_t>(pid);
+    }
+  }
+  RAY_LOG(WARNING) << "Fork server with pid " << state.fork_server_pid
+                   << " failed, starting workers from the worker command";
+  StopForkServer(state);
+  return -1;
+}
+
+void WorkerPool::StopForkServer(State &state) {
+  if (state.fork_server_fd != -1) {
+    // The fork server exits once its socket is closed.
+    close(state.fork_server_fd);
+  }
+  state.fork_server_pid = -1;
+  state.fork_server_fd = -1;
+  state.fork_server_ready = false;
 }
 
 void WorkerPool::RegisterWorker(std::shared_ptr<Worker> worker) {
   auto pid = worker->Pid();
   RAY_LOG(DEBUG) << "Registering worker with pid " << pid;
   auto &state = GetStateForLanguage(worker->GetLanguage());
-  state.registered_workers.push_back(std::move(worker));
+  RAY_CHECK(workers_by_connection_.emplace(worker->Connection(), worker).second);
+  workers_by_pid_.emplace(pid, worker);
+  state.registered_workers.insert(std::move(worker));
 
   auto it = starting_worker_processes_.find(pid);
-  RAY_CHECK(it != starting_worker_processes_.end());
+  if (it == starting_worker_processes_.end()) {
+    // The worker was forked by a fork server that was given up on before it
+    // reported the worker's process ID.
+    RAY_LOG(WARNING) << "Registered worker with pid " << pid
+                     << " that was not started by the worker pool";
+    return;
+  }
   it->second--;
   if (it->second == 0) {
     starting_worker_processes_.erase(it);
+    state.starting_worker_processes.erase(pid);
   }
 }
 
 void WorkerPool::RegisterDriver(std::shared_ptr<Worker> driver) {
   RAY_CHECK(!driver->GetAssignedTaskId().is_nil());
   auto &state = GetStateForLanguage(driver->GetLanguage());
-  state.registered_drivers.push_back(driver);
+  RAY_CHECK(drivers_by_connection_.emplace(driver->Connection(), driver).second);
+  drivers_by_pid_[driver->Pid()] = driver;
+  state.registered_drivers.insert(driver);
 }
 
 std::shared_ptr<Worker> WorkerPool::GetRegisteredWorker(
     const std::shared_ptr<LocalClientConnection> &connection) const {
-  for (const auto &entry : states_by_lang_) {
-    auto worker = GetWorker(entry.second.registered_workers, connection);
-    if (worker != nullptr) {
-      return worker;
-    }
+  auto it = workers_by_connection_.find(connection);
+  if (it == workers_by_connection_.end()) {
+    return nullptr;
   }
-  return nullptr;
+  return it->second;
 }
 
 std::shared_ptr<Worker> WorkerPool::GetRegisteredDriver(
     const std::shared_ptr<LocalClientConnection> &connection) const {
-  for (const auto &entry : states_by_lang_) {
-    auto driver = GetWorker(entry.second.registered_drivers, connection);
-    if (driver != nullptr) {
-      return driver;
-    }
+  auto it = drivers_by_connection_.find(connection);
+  if (it == drivers_by_connection_.end()) {
+    return nullptr;
   }
-  return nullptr;
+  return it->second;
+}
+
+std::vector<std::shared_ptr<Worker>> WorkerPool::GetRegisteredWorkersByPid(
+    pid_t pid) const {
+  std::vector<std::shared_ptr<Worker>> workers;
+  auto range = workers_by_pid_.equal_range(pid);
+  for (auto it = range.first; it != range.second; it++) {
+    workers.push_back(it->second);
+  }
+  return workers;
+}
+
+std::shared_ptr<Worker> WorkerPool::GetRegisteredDriverByPid(pid_t pid) const {
+  auto it = drivers_by_pid_.find(pid);
+  if (it == drivers_by_pid_.end()) {
+    return nullptr;
+  }
+  return it->second;
 }
 
 void WorkerPool::PushWorker(std::shared_ptr<Worker> worker) {
@@ -190,6 +382,7 @@ void WorkerPool::PushWorker(std::shared_ptr<Worker> worker) {
   auto &state = GetStateForLanguage(worker->GetLanguage());
   // Add the worker to the idle pool.
   if (worker->GetActorId().is_nil()) {
+    state.idle_since_ms[worker] = current_time_ms();
     state.idle.push_back(std::move(worker));
   } else {
     state.idle_actor[worker->GetActorId()] = std::move(worker);
@@ -204,6 +397,7 @@ std::shared_ptr<Worker> WorkerPool::PopWorker(const TaskSpecification &task_spec
     if (!state.idle.empty()) {
       worker = std::move(state.idle.back());
       state.idle.pop_back();
+      state.idle_since_ms.erase(worker);
     }
   } else {
     auto actor_entry = state.idle_actor.find(actor_id);
@@ -217,13 +411,30 @@ std::shared_ptr<Worker> WorkerPool::PopWorker(const TaskSpecification &task_spec
 
 bool WorkerPool::DisconnectWorker(std::shared_ptr<Worker> worker) {
   auto &state = GetStateForLanguage(worker->GetLanguage());
-  RAY_CHECK(RemoveWorker(state.registered_workers, worker));
+  RAY_CHECK(state.registered_workers.erase(worker) == 1);
+  RAY_CHECK(workers_by_connection_.erase(worker->Connection()) == 1);
+  auto range = workers_by_pid_.equal_range(worker->Pid());
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->second == worker) {
+      workers_by_pid_.erase(it);
+      break;
+    }
+  }
+  // Only idle workers have an idle time.
+  if (state.idle_since_ms.erase(worker) == 0) {
+    return false;
+  }
   return RemoveWorker(state.idle, worker);
 }
 
 void WorkerPool::DisconnectDriver(std::shared_ptr<Worker> driver) {
   auto &state = GetStateForLanguage(driver->GetLanguage());
-  RAY_CHECK(RemoveWorker(state.registered_drivers, driver));
+  RAY_CHECK(state.registered_drivers.erase(driver) == 1);
+  RAY_CHECK(drivers_by_connection_.erase(driver->Connection()) == 1);
+  auto it = drivers_by_pid_.find(driver->Pid());
+  if (it != drivers_by_pid_.end() && it->second == driver) {
+    drivers_by_pid_.erase(it);
+  }
 }
 
 inline WorkerPool::State &WorkerPool::GetStateForLanguage(const Language &language) {
@@ -232,6 +443,53 @@ inline WorkerPool::State &WorkerPool::GetStateForLanguage(const Language &langua
   return state->second;
 }
 
+int64_t WorkerPool::NumIdleWorkers(const Language &language) const {
+  const auto state = states_by_lang_.find(language);
+  if (state == states_by_lang_.end()) {
+    return 0;
+  }
+  return state->second.idle.size();
+}
+
+int64_t WorkerPool::NumStartingWorkers(const Language &language) const {
+  const auto state = states_by_lang_.find(language);
+  if (state == states_by_lang_.end()) {
+    return 0;
+  }
+  int64_t num_starting_workers = 0;
+  for (const auto &pid : state->second.starting_worker_processes) {
+    auto it = starting_worker_processes_.find(pid);
+    if (it != starting_worker_processes_.end()) {
+      num_starting_workers += it->second;
+    }
+  }
+  return num_starting_workers;
+}
+
+std::vector<std::shared_ptr<Worker>> WorkerPool::ReapIdleWorkers(
+    const Language &language, int64_t idle_timeout_ms, int64_t max_workers) {
+  std::vector<std::shared_ptr<Worker>> workers;
+  if (num_workers_per_process_ != 1) {
+    return workers;
+  }
+  auto &state = GetStateForLanguage(language);
+  const int64_t idle_before_ms = current_time_ms() - idle_timeout_ms;
+  // Workers are popped from the back of the idle list, so the workers at the
+  // front have been idle for the longest time.
+  while (static_cast<int64_t>(workers.size()) < max_workers && !state.idle.empty()) {
+    const auto &worker = state.idle.front();
+    auto idle_since = state.idle_since_ms.find(worker);
+    RAY_CHECK(idle_since != state.idle_since_ms.end());
+    if (idle_since->second > idle_before_ms) {
+      break;
+    }
+    state.idle_since_ms.erase(idle_since);
+    workers.push_back(std::move(state.idle.front()));
+    state.idle.pop_front();
+  }
+  return workers;
+}
+
 std::vector<std::shared_ptr<Worker>> WorkerPool::GetWorkersRunningTasksForDriver(
     const DriverID &driver_id) const {
   std::vector<std::shared_ptr<Worker>> workers;
@@ -249,6 +507,29 @@ std::vector<std::shared_ptr<Worker>> WorkerPool::GetWorkersRunningTasksForDriver
   return workers;
 }
 
+std::vector<std::shared_ptr<Worker>> WorkerPool::GetWorkersRunningTasks() const {
+  std::vector<std::shared_ptr<Worker>> workers;
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &worker : entry.second.registered_workers) {
+      if (worker->GetActorId().is_nil() && !worker->GetAssignedTaskId().is_nil()) {
+        workers.push_back(worker);
+      }
+    }
+  }
+  return workers;
+}
+
+std::shared_ptr<Worker> WorkerPool::GetActorWorker(const ActorID &actor_id) const {
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &worker : entry.second.registered_workers) {
+      if (worker->GetActorId() == actor_id) {
+        return worker;
+      }
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace raylet
 
 }  // namespace ray
@@ -35,10 +35,16 @@ class WorkerPool {
   /// resources on the machine).
   /// \param worker_commands The commands used to start the worker process, grouped by
   /// language.
+  /// \param fork_server_languages The languages whose worker processes are
+  /// forked from a fork server instead of started from the worker command.
+  /// For each of these languages, the worker command is run once to start a
+  /// fork server, which initializes itself once and then forks a new worker
+  /// process whenever the pool asks for one.
   WorkerPool(
       int num_worker_processes, int num_workers_per_process,
       int maximum_startup_concurrency,
-      const std::unordered_map<Language, std::vector<std::string>> &worker_commands);
+      const std::unordered_map<Language, std::vector<std::string>> &worker_commands,
+      const std::unordered_set<Language> &fork_server_languages = {});
 
   /// Destructor responsible for freeing a set of workers owned by this class.
   virtual ~WorkerPool();
@@ -53,6 +59,15 @@ class WorkerPool {
   /// \param language Which language this worker process should be.
   void StartWorkerProcess(const Language &language);
 
+  /// Check whether the fork server for a language has finished initializing.
+  /// Until then, worker processes for the language are started from the
+  /// worker command.
+  ///
+  /// \param language The language of the fork server.
+  /// \return True if the language has a fork server that is ready to fork
+  /// workers and false otherwise.
+  bool IsForkServerReady(const Language &language);
+
   /// Register a new worker. The Worker should be added by the caller to the
   /// pool after it becomes idle (e.g., requests a work assignment).
   ///
@@ -80,6 +95,19 @@ class WorkerPool {
   std::shared_ptr<Worker> GetRegisteredDriver(
       const std::shared_ptr<LocalClientConnection> &connection) const;
 
+  /// Get the registered workers of a worker process.
+  ///
+  /// \param pid The pid of the worker process.
+  /// \return The registered workers that run in the given process.
+  std::vector<std::shared_ptr<Worker>> GetRegisteredWorkersByPid(pid_t pid) const;
+
+  /// Get the registered driver of a process.
+  ///
+  /// \param pid The pid of the driver process.
+  /// \return The registered driver that runs in the given process. Returns
+  /// nullptr if the process has not registered a driver.
+  std::shared_ptr<Worker> GetRegisteredDriverByPid(pid_t pid) const;
+
   /// Disconnect a registered worker.
   ///
   /// \param The worker to disconnect. The worker must be registered.
@@ -111,6 +139,34 @@ class WorkerPool {
   /// \return The total count of all workers (actor and non-actor) in the pool.
   uint32_t Size(const Language &language) const;
 
+  /// Get the number of idle non-actor workers for a language.
+  ///
+  /// \param language The requested language.
+  /// \return The number of idle non-actor workers.
+  int64_t NumIdleWorkers(const Language &language) const;
+
+  /// Get the number of workers for a language that have been started but not
+  /// registered yet.
+  ///
+  /// \param language The requested language.
+  /// \return The number of starting workers.
+  int64_t NumStartingWorkers(const Language &language) const;
+
+  /// Remove the non-actor workers that have been idle for the longest time
+  /// from the pool, so that the caller can kill them. Workers are only
+  /// removed if each worker process runs a single worker, since killing a
+  /// process would otherwise also kill workers that are not idle.
+  ///
+  /// \param language The requested language.
+  /// \param idle_timeout_ms Only remove workers that have been idle for at
+  /// least this many milliseconds.
+  /// \param max_workers The maximum number of workers to remove.
+  /// \return The removed workers. They are still registered until they
+  /// disconnect.
+  std::vector<std::shared_ptr<Worker>> ReapIdleWorkers(const Language &language,
+                                                       int64_t idle_timeout_ms,
+                                                       int64_t max_workers);
+
   /// Get all the workers which are running tasks for a given driver.
   ///
   /// \param driver_id The driver ID.
@@ -118,6 +174,17 @@ class WorkerPool {
   std::vector<std::shared_ptr<Worker>> GetWorkersRunningTasksForDriver(
       const DriverID &driver_id) const;
 
+  /// Get all the non-actor workers which are running tasks.
+  ///
+  /// \return A list containing all the non-actor workers with an assigned task.
+  std::vector<std::shared_ptr<Worker>> GetWorkersRunningTasks() const;
+
+  /// Get the registered worker that an actor runs on.
+  ///
+  /// \param actor_id The actor ID.
+  /// \return The actor's worker. Returns nullptr if no such worker exists.
+  std::shared_ptr<Worker> GetActorWorker(const ActorID &actor_id) const;
+
  protected:
   /// A map from the pids of starting worker processes
   /// to the number of their unregistered workers.
@@ -130,24 +197,76 @@ class WorkerPool {
   struct State {
     /// The commands and arguments used to start the worker process
     std::vector<std::string> worker_command;
-    /// The pool of idle non-actor workers.
+    /// The pool of idle non-actor workers, in the order that they became idle.
     std::list<std::shared_ptr<Worker>> idle;
+    /// The time in milliseconds that each idle non-actor worker became idle.
+    std::unordered_map<std::shared_ptr<Worker>, int64_t> idle_since_ms;
+    /// The pids of the worker processes that have been started for this
+    /// language and have unregistered workers.
+    std::unordered_set<pid_t> starting_worker_processes;
     /// The pool of idle actor workers.
     std::unordered_map<ActorID, std::shared_ptr<Worker>> idle_actor;
     /// All workers that have registered and are still connected, including both
     /// idle and executing.
-    // TODO(swang): Make this a map to make GetRegisteredWorker faster.
-    std::list<std::shared_ptr<Worker>> registered_workers;
+    std::unordered_set<std::shared_ptr<Worker>> registered_workers;
     /// All drivers that have registered and are still connected.
-    std::list<std::shared_ptr<Worker>> registered_drivers;
+    std::unordered_set<std::shared_ptr<Worker>> registered_drivers;
+    /// The pid of the fork server for this language, or -1 if there is none.
+    pid_t fork_server_pid = -1;
+    /// The pool's end of the socket to the fork server, or -1 if there is no
+    /// fork server.
+    int fork_server_fd = -1;
+    /// Whether the fork server has finished initializing.
+    bool fork_server_ready = false;
   };
 
+  /// Fork a process and execute a worker command in it.
+  ///
+  /// \param worker_command The command to execute.
+  /// \param fork_server_fd If not -1, the process is started as a fork server
+  /// and this is its end of the socket to the pool.
+  /// \return The pid of the started process.
+  pid_t StartProcess(const std::vector<std::string> &worker_command,
+                     int fork_server_fd);
+
+  /// Start the fork server for a language. The fork server writes a "ready"
+  /// line once it has initialized. Then, for each "fork" line that the pool
+  /// writes, it forks a worker process and replies with the worker's pid.
+  ///
+  /// \param state The pool state of the language.
+  void StartForkServer(State &state);
+
+  /// Ask the fork server for a language to fork a worker process.
+  ///
+  /// \param state The pool state of the language. Its fork server must be
+  /// ready.
+  /// \return The pid of the forked worker process, or -1 if the fork server
+  /// failed. In that case, the fork server is stopped.
+  pid_t ForkWorkerProcess(State &state);
+
+  /// Stop the fork server for a language, if there is one.
+  ///
+  /// \param state The pool state of the language.
+  void StopForkServer(State &state);
+
   /// A helper function that returns the reference of the pool state
   /// for a given language.
   inline State &GetStateForLanguage(const Language &language);
 
   /// The maximum number of workers that can be started concurrently.
   int maximum_startup_concurrency_;
+  /// All registered workers of every language, indexed by their connection.
+  /// Nearly every client message looks up its worker here.
+  std::unordered_map<std::shared_ptr<LocalClientConnection>, std::shared_ptr<Worker>>
+      workers_by_connection_;
+  /// All registered drivers of every language, indexed by their connection.
+  std::unordered_map<std::shared_ptr<LocalClientConnection>, std::shared_ptr<Worker>>
+      drivers_by_connection_;
+  /// All registered workers, indexed by the pid of their process. A worker
+  /// process may run several workers.
+  std::unordered_multimap<pid_t, std::shared_ptr<Worker>> workers_by_pid_;
+  /// All registered drivers, indexed by the pid of their process.
+  std::unordered_map<pid_t, std::shared_ptr<Worker>> drivers_by_pid_;
   /// Pool states per language.
   std::unordered_map<Language, State> states_by_lang_;
 };
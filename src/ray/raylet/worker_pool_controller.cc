@@ -0,0 +1,64 @@
+#include "ray/raylet/worker_pool_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+std::string WorkerPoolMetrics::ToString() const {
+  std::stringstream result;
+  result << "smoothed demand " << smoothed_demand << ", target workers "
+         << target_workers << ", workers prestarted " << num_workers_prestarted
+         << ", workers reaped " << num_workers_reaped;
+  return result.str();
+}
+
+WorkerPoolController::WorkerPoolController(int64_t min_workers, int64_t max_workers,
+                                           double demand_smoothing)
+    : min_workers_(min_workers),
+      max_workers_(max_workers),
+      demand_smoothing_(demand_smoothing) {
+  RAY_CHECK(min_workers_ >= 0);
+  RAY_CHECK(demand_smoothing_ > 0 && demand_smoothing_ <= 1);
+}
+
+WorkerPoolResize WorkerPoolController::Resize(const Language &language,
+                                              int64_t num_ready_tasks,
+                                              int64_t num_idle_workers,
+                                              int64_t num_starting_workers) {
+  auto &metrics = metrics_[language];
+  metrics.smoothed_demand = demand_smoothing_ * num_ready_tasks +
+                            (1 - demand_smoothing_) * metrics.smoothed_demand;
+
+  // Cover the larger of the current and the historical demand, within the
+  // configured bounds.
+  int64_t target_workers = std::max(
+      num_ready_tasks, static_cast<int64_t>(std::ceil(metrics.smoothed_demand)));
+  target_workers = std::max(min_workers_, std::min(max_workers_, target_workers));
+  metrics.target_workers = target_workers;
+
+  WorkerPoolResize resize;
+  resize.num_workers_to_start =
+      std::max<int64_t>(0, target_workers - num_idle_workers - num_starting_workers);
+  resize.num_workers_to_reap = std::max<int64_t>(0, num_idle_workers - target_workers);
+  metrics.num_workers_prestarted += resize.num_workers_to_start;
+  return resize;
+}
+
+void WorkerPoolController::RecordReapedWorkers(const Language &language,
+                                               int64_t num_workers_reaped) {
+  metrics_[language].num_workers_reaped += num_workers_reaped;
+}
+
+const WorkerPoolMetrics &WorkerPoolController::GetMetrics(const Language &language) {
+  return metrics_[language];
+}
+
+}  // namespace raylet
+
+}  // namespace ray
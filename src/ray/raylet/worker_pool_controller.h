@@ -0,0 +1,101 @@
+#ifndef RAY_RAYLET_WORKER_POOL_CONTROLLER_H
+#define RAY_RAYLET_WORKER_POOL_CONTROLLER_H
+
+#include <string>
+#include <unordered_map>
+
+#include "ray/gcs/format/util.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// The decisions of a WorkerPoolController for one language.
+struct WorkerPoolMetrics {
+  /// The smoothed number of ready tasks that wait for a worker.
+  double smoothed_demand = 0;
+  /// The number of idle and starting workers that the pool should have.
+  int64_t target_workers = 0;
+  /// The total number of workers that the controller started ahead of demand.
+  int64_t num_workers_prestarted = 0;
+  /// The total number of idle workers that the controller reaped.
+  int64_t num_workers_reaped = 0;
+
+  /// Return a human-readable string for the metrics.
+  ///
+  /// \return A string of the metrics.
+  std::string ToString() const;
+};
+
+/// The way a WorkerPoolController decides to resize the pool for a language.
+struct WorkerPoolResize {
+  /// The number of workers to start.
+  int64_t num_workers_to_start;
+  /// The maximum number of idle workers to reap. Only workers that have been
+  /// idle for longer than the idle timeout should be reaped.
+  int64_t num_workers_to_reap;
+};
+
+/// \class WorkerPoolController
+///
+/// Sizes the worker pool from the demand for workers. The controller keeps a
+/// smoothed history of the number of ready tasks per language and targets
+/// enough idle and starting workers to cover both the current and the
+/// historical demand. Workers are started ahead of demand when the pool is
+/// below the target, and idle workers above the target may be reaped.
+class WorkerPoolController {
+ public:
+  /// Create a worker pool controller.
+  ///
+  /// \param min_workers The number of idle and starting workers that the pool
+  /// keeps per language regardless of demand.
+  /// \param max_workers The maximum number of idle and starting workers that
+  /// the controller targets per language.
+  /// \param demand_smoothing The weight of the latest demand in the smoothed
+  /// demand, between 0 and 1. Lower values remember demand for longer.
+  WorkerPoolController(int64_t min_workers, int64_t max_workers,
+                       double demand_smoothing);
+
+  /// Decide how to resize the pool for a language. This should be called
+  /// periodically for each language.
+  ///
+  /// \param language The language of the workers.
+  /// \param num_ready_tasks The number of ready non-actor tasks for the
+  /// language.
+  /// \param num_idle_workers The number of idle non-actor workers for the
+  /// language.
+  /// \param num_starting_workers The number of workers for the language that
+  /// have been started but not registered yet.
+  /// \return The decision.
+  WorkerPoolResize Resize(const Language &language, int64_t num_ready_tasks,
+                          int64_t num_idle_workers, int64_t num_starting_workers);
+
+  /// Record the number of workers that were reaped after a decision.
+  ///
+  /// \param language The language of the workers.
+  /// \param num_workers_reaped The number of workers that were reaped.
+  /// \return Void.
+  void RecordReapedWorkers(const Language &language, int64_t num_workers_reaped);
+
+  /// Get the decisions of the controller for a language so far.
+  ///
+  /// \param language The language of the workers.
+  /// \return The metrics of the language.
+  const WorkerPoolMetrics &GetMetrics(const Language &language);
+
+ private:
+  /// The number of idle and starting workers to keep per language.
+  const int64_t min_workers_;
+  /// The maximum number of idle and starting workers to target per language.
+  const int64_t max_workers_;
+  /// The weight of the latest demand in the smoothed demand.
+  const double demand_smoothing_;
+  /// The metrics of each language.
+  std::unordered_map<Language, WorkerPoolMetrics> metrics_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // RAY_RAYLET_WORKER_POOL_CONTROLLER_H
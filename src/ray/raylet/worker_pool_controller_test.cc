@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include "ray/raylet/worker_pool_controller.h"
+
+namespace ray {
+
+namespace raylet {
+
+TEST(WorkerPoolControllerTest, TestPrestartWorkers) {
+  WorkerPoolController controller(2, 8, 0.5);
+
+  // Without demand, the pool keeps the minimum number of workers.
+  auto resize = controller.Resize(Language::PYTHON, 0, 0, 0);
+  ASSERT_EQ(resize.num_workers_to_start, 2);
+  ASSERT_EQ(resize.num_workers_to_reap, 0);
+  resize = controller.Resize(Language::PYTHON, 0, 0, 2);
+  ASSERT_EQ(resize.num_workers_to_start, 0);
+
+  // Ready tasks raise the target, counting the workers that are starting.
+  resize = controller.Resize(Language::PYTHON, 6, 0, 2);
+  ASSERT_EQ(resize.num_workers_to_start, 4);
+  ASSERT_EQ(controller.GetMetrics(Language::PYTHON).target_workers, 6);
+
+  // The target is capped.
+  resize = controller.Resize(Language::PYTHON, 20, 0, 6);
+  ASSERT_EQ(resize.num_workers_to_start, 2);
+  ASSERT_EQ(controller.GetMetrics(Language::PYTHON).target_workers, 8);
+  ASSERT_EQ(controller.GetMetrics(Language::PYTHON).num_workers_prestarted, 8);
+
+  // Languages are sized independently.
+  resize = controller.Resize(Language::JAVA, 0, 2, 0);
+  ASSERT_EQ(resize.num_workers_to_start, 0);
+  ASSERT_EQ(controller.GetMetrics(Language::JAVA).num_workers_prestarted, 0);
+}
+
+TEST(WorkerPoolControllerTest, TestReapIdleWorkers) {
+  WorkerPoolController controller(1, 8, 0.5);
+  auto resize = controller.Resize(Language::PYTHON, 8, 0, 0);
+  ASSERT_EQ(resize.num_workers_to_start, 8);
+  for (int i = 0; i < 2; i++) {
+    resize = controller.Resize(Language::PYTHON, 8, 0, 8);
+    ASSERT_EQ(resize.num_workers_to_start, 0);
+  }
+
+  // Once the demand is gone, the smoothed demand still covers half of the
+  // workers, so only the other half may be reaped.
+  resize = controller.Resize(Language::PYTHON, 0, 8, 0);
+  ASSERT_EQ(resize.num_workers_to_start, 0);
+  ASSERT_EQ(resize.num_workers_to_reap, 4);
+  controller.RecordReapedWorkers(Language::PYTHON, 4);
+
+  // The pool shrinks to the minimum as the smoothed demand decays.
+  for (int i = 0; i < 10; i++) {
+    resize = controller.Resize(Language::PYTHON, 0, 4, 0);
+  }
+  ASSERT_EQ(resize.num_workers_to_reap, 3);
+  ASSERT_EQ(controller.GetMetrics(Language::PYTHON).target_workers, 1);
+  ASSERT_EQ(controller.GetMetrics(Language::PYTHON).num_workers_reaped, 4);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -1,3 +1,10 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -161,6 +168,248 @@ TEST_F(WorkerPoolTest, PopWorkersOfMultipleLanguages) {
   ASSERT_NE(worker_pool_.PopWorker(java_task_spec), nullptr);
 }
 
+TEST_F(WorkerPoolTest, LookupWorkersByPid) {
+  pid_t pid = 1234;
+  worker_pool_.StartWorkerProcess(pid);
+  std::unordered_set<std::shared_ptr<Worker>> workers;
+  for (int i = 0; i < NUM_WORKERS_PER_PROCESS; i++) {
+    auto worker = CreateWorker(pid);
+    worker_pool_.RegisterWorker(worker);
+    workers.insert(worker);
+  }
+  auto registered_workers = worker_pool_.GetRegisteredWorkersByPid(pid);
+  ASSERT_EQ(std::unordered_set<std::shared_ptr<Worker>>(registered_workers.begin(),
+                                                        registered_workers.end()),
+            workers);
+  ASSERT_TRUE(worker_pool_.GetRegisteredWorkersByPid(5678).empty());
+
+  auto driver = CreateWorker(5678);
+  driver->AssignTaskId(TaskID::from_random());
+  worker_pool_.RegisterDriver(driver);
+  ASSERT_EQ(worker_pool_.GetRegisteredDriverByPid(5678), driver);
+  ASSERT_EQ(worker_pool_.GetRegisteredDriver(driver->Connection()), driver);
+  ASSERT_EQ(worker_pool_.GetRegisteredWorker(driver->Connection()), nullptr);
+
+  // Disconnect all the workers, so that the pool does not kill the pid when
+  // it is destroyed.
+  size_t num_registered = workers.size();
+  for (const auto &worker : workers) {
+    worker_pool_.DisconnectWorker(worker);
+    num_registered--;
+    ASSERT_EQ(worker_pool_.GetRegisteredWorkersByPid(pid).size(), num_registered);
+  }
+  worker_pool_.DisconnectDriver(driver);
+  ASSERT_EQ(worker_pool_.GetRegisteredDriverByPid(5678), nullptr);
+  ASSERT_EQ(worker_pool_.GetRegisteredDriver(driver->Connection()), nullptr);
+}
+
+/// Measure the cost of looking up the worker or driver of a client message,
+/// as NodeManager::ProcessClientMessage does, with a given number of
+/// registered workers.
+///
+/// \param num_workers The number of registered workers.
+/// \return The mean number of nanoseconds per message.
+double MeanMessageLookupNs(int num_workers) {
+  const int num_messages = 100000;
+  boost::asio::io_service io_service;
+  WorkerPoolMock worker_pool;
+  std::vector<std::shared_ptr<Worker>> workers;
+  std::vector<std::shared_ptr<LocalClientConnection>> connections;
+  auto create_worker = [&io_service](pid_t pid) {
+    boost::asio::local::stream_protocol::socket socket(io_service);
+    auto client = LocalClientConnection::Create(
+        [](LocalClientConnection &) {},
+        [](std::shared_ptr<LocalClientConnection>, int64_t, const uint8_t *) {},
+        std::move(socket), "worker");
+    return std::make_shared<Worker>(pid, Language::PYTHON, client);
+  };
+  for (int i = 0; i < num_workers; i += NUM_WORKERS_PER_PROCESS) {
+    const pid_t pid = 1000 + i;
+    worker_pool.StartWorkerProcess(pid);
+    for (int j = 0; j < NUM_WORKERS_PER_PROCESS; j++) {
+      auto worker = create_worker(pid);
+      worker_pool.RegisterWorker(worker);
+      workers.push_back(worker);
+      connections.push_back(worker->Connection());
+    }
+  }
+  // Messages from drivers miss the workers first.
+  auto driver = create_worker(1);
+  driver->AssignTaskId(TaskID::from_random());
+  worker_pool.RegisterDriver(driver);
+  connections.push_back(driver->Connection());
+
+  int num_found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_messages; i++) {
+    const auto &connection = connections[(i * 7919) % connections.size()];
+    auto worker = worker_pool.GetRegisteredWorker(connection);
+    if (worker == nullptr) {
+      worker = worker_pool.GetRegisteredDriver(connection);
+    }
+    num_found += worker != nullptr;
+  }
+  const double total_ns = std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+  RAY_CHECK(num_found == num_messages);
+
+  // Disconnect all the workers, so that the pool does not kill the pids when
+  // it is destroyed.
+  for (const auto &worker : workers) {
+    worker_pool.DisconnectWorker(worker);
+  }
+  worker_pool.DisconnectDriver(driver);
+  return total_ns / num_messages;
+}
+
+// This compares wall-clock times, so it is disabled by default. Run it with
+// --gtest_also_run_disabled_tests.
+TEST(WorkerPoolLookupTest, DISABLED_TestMessageLookupCost) {
+  const double small_pool_ns = MeanMessageLookupNs(12);
+  const double large_pool_ns = MeanMessageLookupNs(1200);
+  RAY_LOG(INFO) << "Mean worker lookup time per message: " << small_pool_ns
+                << "ns with 12 workers, " << large_pool_ns << "ns with 1200 workers";
+  // The lookup does not scan the registered workers, so 100 times as many
+  // workers should cost far less than 100 times as much.
+  ASSERT_LT(large_pool_ns, 10 * small_pool_ns);
+}
+
+/// Count the files in a directory.
+static int CountFiles(const std::string &directory) {
+  DIR *dir = opendir(directory.c_str());
+  RAY_CHECK(dir != nullptr);
+  int num_files = 0;
+  while (struct dirent *entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      num_files++;
+    }
+  }
+  closedir(dir);
+  return num_files;
+}
+
+/// Remove a directory and the files in it.
+static void RemoveDirectory(const std::string &directory) {
+  DIR *dir = opendir(directory.c_str());
+  RAY_CHECK(dir != nullptr);
+  while (struct dirent *entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      unlink((directory + "/" + entry->d_name).c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(directory.c_str());
+}
+
+/// Start Python worker processes one at a time. Each worker process signals
+/// that it is running by creating a file in the given directory.
+///
+/// \param worker_pool The worker pool to start the worker processes from.
+/// \param directory The directory that the worker processes create files in.
+/// \param num_worker_processes The number of worker processes to start.
+/// \return The mean number of milliseconds until a worker process is running.
+static double MeanWorkerStartupMs(WorkerPool &worker_pool, const std::string &directory,
+                                  int num_worker_processes) {
+  double total_ms = 0;
+  for (int i = 0; i < num_worker_processes; i++) {
+    auto start = std::chrono::steady_clock::now();
+    worker_pool.StartWorkerProcess(Language::PYTHON);
+    while (CountFiles(directory) <= i) {
+      RAY_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+          << "Worker process did not start";
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    total_ms += std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  }
+  return total_ms / num_worker_processes;
+}
+
+// This benchmark starts bash processes and compares their startup times, so
+// it is disabled by default.
+TEST(WorkerPoolStartupTest, DISABLED_TestForkServerStartup) {
+  const int num_worker_processes = 10;
+  char cold_template[] = "/tmp/worker_pool_test_XXXXXX";
+  char fork_template[] = "/tmp/worker_pool_test_XXXXXX";
+  RAY_CHECK(mkdtemp(cold_template) != nullptr);
+  RAY_CHECK(mkdtemp(fork_template) != nullptr);
+  const std::string cold_directory = cold_template;
+  const std::string fork_directory = fork_template;
+
+  // Both worker commands take 100ms to initialize, like a worker that imports
+  // its modules. The fork server initializes once and then forks a subshell
+  // for each worker.
+  const std::string cold_command = "sleep 0.1; touch " + cold_directory + "/$$";
+  const std::string fork_server_command =
+      "sleep 0.1; fd=$RAY_WORKER_FORK_SERVER_FD; echo ready >&$fd; "
+      "while read -r request <&$fd; do "
+      "(touch " +
+      fork_directory + "/$BASHPID) & echo $! >&$fd; done";
+
+  double cold_startup_ms;
+  double fork_server_startup_ms;
+  {
+    WorkerPool worker_pool(0, 1, num_worker_processes,
+                           {{Language::PYTHON, {"/bin/bash", "-c", cold_command}}});
+    cold_startup_ms =
+        MeanWorkerStartupMs(worker_pool, cold_directory, num_worker_processes);
+  }
+  {
+    WorkerPool worker_pool(0, 1, num_worker_processes,
+                           {{Language::PYTHON, {"/bin/bash", "-c", fork_server_command}}},
+                           {Language::PYTHON});
+    auto start = std::chrono::steady_clock::now();
+    while (!worker_pool.IsForkServerReady(Language::PYTHON)) {
+      ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fork_server_startup_ms =
+        MeanWorkerStartupMs(worker_pool, fork_directory, num_worker_processes);
+  }
+  RemoveDirectory(cold_directory);
+  RemoveDirectory(fork_directory);
+
+  RAY_LOG(INFO) << "Mean worker process startup time: " << cold_startup_ms
+                << "ms from the worker command, " << fork_server_startup_ms
+                << "ms from the fork server";
+  ASSERT_LT(fork_server_startup_ms, cold_startup_ms);
+}
+
+TEST(WorkerPoolStartupTest, TestForkServerTimeout) {
+  char template_directory[] = "/tmp/worker_pool_test_XXXXXX";
+  RAY_CHECK(mkdtemp(template_directory) != nullptr);
+  const std::string directory = template_directory;
+
+  // The fork server reports that it is ready, but never answers a request to
+  // fork a worker. A process started from the worker command creates a file.
+  const std::string command =
+      "fd=$RAY_WORKER_FORK_SERVER_FD; if [ -n \"$fd\" ]; then echo ready >&$fd; "
+      "while read -r request <&$fd; do :; done; else touch " +
+      directory + "/$$; fi";
+  {
+    WorkerPool worker_pool(0, 1, 1, {{Language::PYTHON, {"/bin/bash", "-c", command}}},
+                           {Language::PYTHON});
+    auto start = std::chrono::steady_clock::now();
+    while (!worker_pool.IsForkServerReady(Language::PYTHON)) {
+      ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The pool gives up on the fork server and starts the worker from the
+    // worker command instead.
+    worker_pool.StartWorkerProcess(Language::PYTHON);
+    ASSERT_FALSE(worker_pool.IsForkServerReady(Language::PYTHON));
+    start = std::chrono::steady_clock::now();
+    while (CountFiles(directory) == 0) {
+      ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  RemoveDirectory(directory);
+}
+
 }  // namespace raylet
 
 }  // namespace ray